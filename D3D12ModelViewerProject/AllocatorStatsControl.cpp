@@ -0,0 +1,35 @@
+#include "AllocatorStatsControl.h"
+#include "D3DResourceManager.h"
+
+void AllocatorStatsControl::Show()
+{
+	if (ImGui::Begin("Allocator Stats") == false)
+	{
+		ImGui::End();
+		return;
+	}
+
+	//단위는 디스크립터 개수
+	for (auto& stats : D3DResourceManager::GetInstance().GetAllocatorStats())
+	{
+		if (ImGui::CollapsingHeader(stats.Name.c_str()) == false)
+		{
+			continue;
+		}
+
+		const VariableSizeAllocationStats& blocks = stats.Blocks;
+		ImGui::Text("Heaps : %zu", stats.HeapCount);
+		ImGui::Text("Used : %zu / %zu (Peak %zu)", blocks.TotalSize - blocks.FreeSize, blocks.TotalSize, blocks.PeakUsedSize);
+		ImGui::Text("Free : %zu", blocks.FreeSize);
+		ImGui::Text("Largest Free Block : %zu", blocks.LargestFreeBlock);
+		ImGui::Text("Free Blocks : %zu", blocks.FreeBlockCount);
+		ImGui::Text("Fragmentation : %.3f", blocks.GetFragmentation());
+		ImGui::Text("Live Allocations : %zu", blocks.AllocationCount);
+		ImGui::Text("Allocations / Frame : %llu", stats.AllocationsPerFrame);
+		ImGui::Text("Frees / Frame : %llu", stats.FreesPerFrame);
+		ImGui::Text("Failed Allocations : %llu", blocks.FailedAllocateCount);
+		ImGui::Text("Stale Queue : %zu (%zu)", blocks.StaleAllocationCount, blocks.StaleSize);
+	}
+
+	ImGui::End();
+}
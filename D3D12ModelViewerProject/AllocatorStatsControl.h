@@ -0,0 +1,9 @@
+#pragma once
+
+#include "ImGUIControl.h"
+
+class AllocatorStatsControl
+{
+public:
+	void Show();
+};
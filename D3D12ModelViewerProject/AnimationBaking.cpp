@@ -0,0 +1,76 @@
+#include "AnimationBaking.h"
+
+using namespace DirectX;
+
+BakedAnimation BakedAnimation::Bake(const AnimationClip& clip)
+{
+	BakedAnimation baked;
+	baked.BoneCount = static_cast<UINT>(clip.BoneAnimations.size());
+	if (baked.BoneCount == 0)
+	{
+		return baked;
+	}
+
+	baked.FramePerSecond = clip.BoneAnimations.front().GetFramePerSecond();
+	for (const BoneAnimation& boneAnimation : clip.BoneAnimations)
+	{
+		baked.FrameCount = (std::max)(baked.FrameCount, boneAnimation.Track.FrameCount);
+	}
+	baked.FrameCount = (std::max)(baked.FrameCount, 1u);
+
+	baked.Palettes.resize(static_cast<size_t>(baked.FrameCount) * baked.BoneCount);
+
+	std::vector<XMMATRIX> boneTransforms;
+	std::vector<BoneTrackCursor> cursors;
+	for (UINT frame = 0; frame < baked.FrameCount; ++frame)
+	{
+		clip.Interpolate(frame / baked.FramePerSecond, boneTransforms, &cursors);
+
+		BoneTransform3x4* framePalette = &baked.Palettes[static_cast<size_t>(frame) * baked.BoneCount];
+		for (UINT boneIndex = 0; boneIndex < baked.BoneCount; ++boneIndex)
+		{
+			framePalette[boneIndex].Store(boneTransforms[boneIndex]);
+		}
+	}
+
+	return baked;
+}
+
+void BakedAnimation::Sample(float time, BoneTransform3x4* result) const
+{
+	BakedClipInfo clipInfo;
+	clipInfo.FrameCount = FrameCount;
+	clipInfo.BoneCount = BoneCount;
+	clipInfo.FramePerSecond = FramePerSecond;
+
+	UINT frame0, frame1;
+	float alpha;
+	AnimationBaking::GetFramePosition(clipInfo, time, frame0, frame1, alpha);
+
+	const BoneTransform3x4* palette0 = &Palettes[static_cast<size_t>(frame0) * BoneCount];
+	const BoneTransform3x4* palette1 = &Palettes[static_cast<size_t>(frame1) * BoneCount];
+	for (UINT boneIndex = 0; boneIndex < BoneCount; ++boneIndex)
+	{
+		for (int row = 0; row < 3; ++row)
+		{
+			XMVECTOR row0 = XMLoadFloat4(&palette0[boneIndex].Rows[row]);
+			XMVECTOR row1 = XMLoadFloat4(&palette1[boneIndex].Rows[row]);
+			XMStoreFloat4(&result[boneIndex].Rows[row], XMVectorLerp(row0, row1, alpha));
+		}
+	}
+}
+
+void AnimationBaking::GetFramePosition(const BakedClipInfo& clipInfo, float time, UINT& frame0, UINT& frame1, float& alpha)
+{
+	float frame = time * clipInfo.FramePerSecond;
+	float frameCount = static_cast<float>(clipInfo.FrameCount);
+
+	//frac과 같은 결과, 음수 시간도 되감음
+	frame = frame - floorf(frame / frameCount) * frameCount;
+	float baseFrame = floorf(frame);
+
+	alpha = frame - baseFrame;
+	frame0 = (std::min)(static_cast<UINT>(baseFrame), clipInfo.FrameCount - 1);
+	//마지막 프레임 구간은 처음으로 보간하지 않고 마지막 키 유지, AnimationPlayback 재생과 같음
+	frame1 = (std::min)(frame0 + 1, clipInfo.FrameCount - 1);
+}
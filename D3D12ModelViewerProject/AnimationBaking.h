@@ -0,0 +1,28 @@
+#pragma once
+
+#include "FbxUtil.h"
+#include "FrameResource.h"
+
+//클립 전체를 프레임마다 스키닝 행렬로 구워둔 것, 루프 재생만 하는 인스턴스용
+//Palettes : 프레임 * 본 개수, 한 프레임의 본들이 연속
+struct BakedAnimation
+{
+	UINT FrameCount = 0;
+	UINT BoneCount = 0;
+	float FramePerSecond = 0.0f;
+	std::vector<BoneTransform3x4> Palettes;
+
+	static BakedAnimation Bake(const AnimationClip& clip);
+
+	float GetEndTime() const { return FramePerSecond > 0.0f ? FrameCount / FramePerSecond : 0.0f; }
+
+	//DynamicMeshShader.hlsl의 GetBakedBoneTransform과 같은 계산, result : BoneCount 크기
+	void Sample(float time, BoneTransform3x4* result) const;
+};
+
+namespace AnimationBaking
+{
+	//셰이더와 같은 프레임 선택, time은 루프로 되감음
+	//마지막 프레임에서 끝 시간까지는 마지막 프레임 그대로
+	void GetFramePosition(const BakedClipInfo& clipInfo, float time, UINT& frame0, UINT& frame1, float& alpha);
+}
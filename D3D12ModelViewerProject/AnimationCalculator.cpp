@@ -1,43 +1,177 @@
-
 #include "AnimationCalculator.h"
 using namespace DirectX;
 
-void AnimationCalcuator::CopyAnimation(std::vector<InstanceAnimations>& instanceAnimations, const Skeleton& skeleton)
+void AnimationPlayback::Reset(std::shared_ptr<const AnimationClip> clip)
 {
-	
+	Clip = std::move(clip);
+	TrackCursors.clear();
+	EndTime = Clip != nullptr ? Clip->GetEndTime() : 0.0f;
+	CurrentTime = 0.0f;
+	IsLoop = false;
+}
 
-	//BoneAnimations
-	std::vector<XMMATRIX> boneTransforms;
+void AnimationPlayback::AddTime(float time)
+{
+	CurrentTime += time;
+	if (CurrentTime >= EndTime)
+	{
+		if (IsLoop == true && EndTime > 0.0f)
+		{
+			int times = CurrentTime / EndTime;
+			CurrentTime -= EndTime * times;
+		}
+		else
+		{
+			CurrentTime = EndTime;
+		}
+	}
+}
 
-	m_animation.Interpolate(m_currentTime, boneTransforms);
+float AnimationPlayback::GetSampleTime(float offset) const
+{
+	float time = CurrentTime + offset;
+	if (time >= EndTime)
+	{
+		if (IsLoop == true && EndTime > 0.0f)
+		{
+			return fmodf(time, EndTime);
+		}
+		return EndTime;
+	}
+	return time;
+}
 
-	int animationIndex = 0;
-	for (animationIndex = 0; animationIndex < boneTransforms.size() && animationIndex < instanceAnimations.size(); ++animationIndex)
+void AnimationCalcuator::SetAnimationClip(std::shared_ptr<const AnimationClip> animation, float blendTime)
+{
+	if (blendTime > 0.0f && m_current.Clip != nullptr && animation != nullptr)
+	{
+		m_previous = std::move(m_current);
+		m_blendTime = blendTime;
+		m_blendElapsedTime = 0.0f;
+	}
+	else
 	{
-		InstanceAnimations& copyDest = instanceAnimations.at(animationIndex);
-		XMStoreFloat4x4(&copyDest.BoneTransform, XMMatrixTranspose(boneTransforms.at(animationIndex)));
+		m_previous.Reset(nullptr);
 	}
-	for (; animationIndex < instanceAnimations.size(); ++animationIndex)
+
+	m_current.Reset(std::move(animation));
+}
+
+void AnimationCalcuator::SetLayer(size_t layerIndex, std::shared_ptr<const AnimationClip> animation, AnimationBlendMode blendMode,
+	float weight, std::shared_ptr<const std::vector<float>> boneMask)
+{
+	if (m_layers.size() <= layerIndex)
 	{
-		InstanceAnimations& copyDest = instanceAnimations.at(animationIndex);
-		XMStoreFloat4x4(&copyDest.BoneTransform, XMMatrixTranspose(XMMatrixIdentity()));
+		m_layers.resize(layerIndex + 1);
 	}
 
+	AnimationLayer& layer = m_layers[layerIndex];
+	layer.Playback.Reset(std::move(animation));
+	layer.Playback.IsLoop = true;
+	layer.BlendMode = blendMode;
+	layer.Weight = weight;
+	layer.BoneMask = std::move(boneMask);
+}
+
+void AnimationCalcuator::SetLayerWeight(size_t layerIndex, float weight)
+{
+	if (layerIndex < m_layers.size())
+	{
+		m_layers[layerIndex].Weight = weight;
+	}
 }
 
 void AnimationCalcuator::AddTime(float time)
 {
-	m_currentTime += time;
-	if (m_currentTime >= m_endTime)
+	time *= m_speed;
+
+	m_current.AddTime(time);
+
+	if (m_previous.Clip != nullptr)
 	{
-		if (m_isAnimationLoop == true)
+		m_previous.AddTime(time);
+		m_blendElapsedTime += time;
+		if (m_blendElapsedTime >= m_blendTime)
 		{
-			int times = m_currentTime / m_endTime;
-			m_currentTime -= m_endTime * times;
+			m_previous.Reset(nullptr);
 		}
-		else
+	}
+
+	for (AnimationLayer& layer : m_layers)
+	{
+		if (layer.Playback.Clip != nullptr)
+		{
+			layer.Playback.AddTime(time);
+		}
+	}
+}
+
+bool AnimationCalcuator::HasAnimation() const
+{
+	if (m_current.Clip != nullptr || m_previous.Clip != nullptr)
+	{
+		return true;
+	}
+	return std::any_of(m_layers.begin(), m_layers.end(),
+		[](const AnimationLayer& layer) { return layer.Playback.Clip != nullptr && layer.Weight > 0.0f; });
+}
+
+bool AnimationCalcuator::GetSingleClipSample(const AnimationClip*& clip, float& time) const
+{
+	if (m_current.Clip == nullptr || m_previous.Clip != nullptr)
+	{
+		return false;
+	}
+
+	for (const AnimationLayer& layer : m_layers)
+	{
+		if (layer.Playback.Clip != nullptr && layer.Weight > 0.0f)
+		{
+			return false;
+		}
+	}
+
+	clip = m_current.Clip.get();
+	time = m_current.CurrentTime;
+	return true;
+}
+
+void AnimationCalcuator::AddPoseSamples(AnimationPoseBatch& poseBatch, size_t poseIndex, float timeOffset)
+{
+	timeOffset *= m_speed;
+
+	auto addSample = [&](AnimationPlayback& playback, int layer, AnimationBlendMode blendMode, float weight, const std::vector<float>* boneMask)
+	{
+		PoseBatchSample sample;
+		sample.Clip = playback.Clip.get();
+		sample.Layer = layer;
+		sample.BlendMode = blendMode;
+		sample.Time = playback.GetSampleTime(timeOffset);
+		sample.Weight = weight;
+		sample.BoneMask = boneMask;
+		sample.Cursors = &playback.TrackCursors;
+		sample.PoseIndex = poseIndex;
+		poseBatch.AddSample(sample);
+	};
+
+	//기본 레이어, 크로스페이드중이면 두 클립을 가중평균
+	float blendWeight = 1.0f;
+	if (m_previous.Clip != nullptr && m_blendTime > 0.0f)
+	{
+		blendWeight = (std::min)((m_blendElapsedTime + timeOffset) / m_blendTime, 1.0f);
+		addSample(m_previous, 0, AnimationBlendMode::Override, 1.0f - blendWeight, nullptr);
+	}
+	if (m_current.Clip != nullptr)
+	{
+		addSample(m_current, 0, AnimationBlendMode::Override, blendWeight, nullptr);
+	}
+
+	for (size_t i = 0; i < m_layers.size(); ++i)
+	{
+		AnimationLayer& layer = m_layers[i];
+		if (layer.Playback.Clip != nullptr)
 		{
-			m_currentTime = m_endTime;
+			addSample(layer.Playback, static_cast<int>(i) + 1, layer.BlendMode, layer.Weight, layer.BoneMask.get());
 		}
 	}
 }
@@ -2,41 +2,82 @@
 
 #include "FbxUtil.h"
 #include "FrameResource.h"
+#include "AnimationPoseBatch.h"
 
+//클립 하나의 재생상태
+struct AnimationPlayback
+{
+	std::shared_ptr<const AnimationClip> Clip;
+	float CurrentTime = 0.0f;
+	float EndTime = 0.0f;
+	bool IsLoop = false;
+	//본마다 마지막으로 찾은 키
+	std::vector<BoneTrackCursor> TrackCursors;
+
+	void Reset(std::shared_ptr<const AnimationClip> clip);
+	void AddTime(float time);
+	//현재 시간에서 offset만큼 지난 샘플 시간, 루프면 되감음
+	float GetSampleTime(float offset) const;
+};
+
+//기본 클립 위에 섞는 레이어
+struct AnimationLayer
+{
+	AnimationPlayback Playback;
+	AnimationBlendMode BlendMode = AnimationBlendMode::Override;
+	float Weight = 1.0f;
+	//본별 가중치, nullptr이면 모든 본
+	std::shared_ptr<const std::vector<float>> BoneMask;
+};
+
+//클립은 공유하는 불변 데이터, 인스턴스마다 재생상태만 가짐
 class AnimationCalcuator
 {
 public:
 	AnimationCalcuator() = default;
 
-	void CopyAnimation(std::vector<InstanceAnimations>& instanceAnimations, const Skeleton& skeleton);	
-
 	void SetLoop(bool loopMode)
 	{
-		m_isAnimationLoop = loopMode;
+		m_current.IsLoop = loopMode;
 	}
 
-	void SetAnimationClip(const AnimationClip& animation)
+	void SetSpeed(float speed)
 	{
-		m_animation = animation;
-		m_endTime = animation.GetEndTime();
-		m_currentTime = 0.0f;
-		m_isAnimationLoop = false;
+		m_speed = speed;
 	}
 
+	//nullptr이면 바인드포즈, blendTime동안 이전 클립에서 크로스페이드
+	void SetAnimationClip(std::shared_ptr<const AnimationClip> animation, float blendTime = 0.0f);
+
+	//layerIndex번째 레이어를 설정, 가중치가 0이면 샘플링하지 않음
+	void SetLayer(size_t layerIndex, std::shared_ptr<const AnimationClip> animation, AnimationBlendMode blendMode,
+		float weight = 1.0f, std::shared_ptr<const std::vector<float>> boneMask = nullptr);
+	void SetLayerWeight(size_t layerIndex, float weight);
+	void ClearLayers() { m_layers.clear(); }
+
 	void Stop()
 	{
-		m_currentTime = 0.0f;
+		m_current.CurrentTime = 0.0f;
 	}
 
 	void AddTime(float time);
-	
 
-	const AnimationClip& GetCurrentAnimation() { return m_animation; }
+	bool HasAnimation() const;
+	//크로스페이드, 레이어 없이 클립 하나만 재생중이면 그 클립과 시간
+	bool GetSingleClipSample(const AnimationClip*& clip, float& time) const;
+	//기본 클립, 크로스페이드, 레이어 샘플을 poseIndex 포즈에 추가
+	//timeOffset : 현재 시간보다 앞선 포즈가 필요할때 (LOD 보간 목표)
+	void AddPoseSamples(AnimationPoseBatch& poseBatch, size_t poseIndex, float timeOffset = 0.0f);
+
+	const std::shared_ptr<const AnimationClip>& GetCurrentAnimation() { return m_current.Clip; }
 
 private:
+	AnimationPlayback m_current;
+	//크로스페이드중 나가는 클립
+	AnimationPlayback m_previous;
+	float m_blendTime = 0.0f;
+	float m_blendElapsedTime = 0.0f;
 
-	AnimationClip m_animation;
-	float m_currentTime = 0.0f;
-	float m_endTime = 0.0f;
-	bool m_isAnimationLoop = false;
-};
\ No newline at end of file
+	std::vector<AnimationLayer> m_layers;
+	float m_speed = 1.0f;
+};
@@ -0,0 +1,641 @@
+#include "AnimationCompression.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	using Float3 = std::array<float, 3>;
+	using Float4 = std::array<float, 4>;
+
+	//키 사이 최대 프레임수, 키 제거 계산량을 제한
+	const uint32_t MaxKeyGap = 256;
+
+	const float VectorQuantizeMax = 65535.0f;
+	//smallest three에서 나머지 성분의 범위는 -1/sqrt(2) ~ 1/sqrt(2)
+	const float RotationComponentRange = 0.70710678f;
+	//짝수로 두어 0을 정확히 표현
+	const float RotationQuantizeMax = 32766.0f;
+
+	float Distance(const Float3& a, const Float3& b)
+	{
+		float x = a[0] - b[0];
+		float y = a[1] - b[1];
+		float z = a[2] - b[2];
+		return std::sqrt(x * x + y * y + z * z);
+	}
+
+	float Dot(const Float4& a, const Float4& b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+	}
+
+	//두 회전의 사이각 (radian)
+	//작은 각도에서 acos(dot)은 float 오차가 커서 차와 합의 길이로 계산
+	float AngleBetween(const Float4& a, const Float4& b)
+	{
+		float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+		float differenceSquared = 0.0f;
+		float sumSquared = 0.0f;
+		for (int i = 0; i < 4; ++i)
+		{
+			float difference = a[i] - b[i] * sign;
+			float sum = a[i] + b[i] * sign;
+			differenceSquared += difference * difference;
+			sumSquared += sum * sum;
+		}
+		return 4.0f * std::atan2(std::sqrt(differenceSquared), std::sqrt(sumSquared));
+	}
+
+	void Normalize(Float4& q)
+	{
+		float length = std::sqrt(Dot(q, q));
+		if (length > 0.0f)
+		{
+			for (float& value : q)
+			{
+				value /= length;
+			}
+		}
+	}
+
+	Float3 Lerp(const Float3& a, const Float3& b, float t)
+	{
+		return { a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t };
+	}
+
+	//최단경로 slerp
+	Float4 Slerp(const Float4& a, const Float4& b, float t)
+	{
+		float cosOmega = Dot(a, b);
+		float sign = 1.0f;
+		if (cosOmega < 0.0f)
+		{
+			cosOmega = -cosOmega;
+			sign = -1.0f;
+		}
+
+		float scaleA = 1.0f - t;
+		float scaleB = t;
+		if (cosOmega < 0.9999f)
+		{
+			float omega = std::acos(cosOmega);
+			float sinOmega = std::sin(omega);
+			scaleA = std::sin((1.0f - t) * omega) / sinOmega;
+			scaleB = std::sin(t * omega) / sinOmega;
+		}
+		scaleB *= sign;
+
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+		{
+			result[i] = a[i] * scaleA + b[i] * scaleB;
+		}
+		Normalize(result);
+		return result;
+	}
+
+	//frame을 포함하는 키 구간
+	//모든 프레임에 키가 있으면 인덱스를 바로 계산, 아니면 cursor 구간과 그 다음 구간을 먼저 확인하고 이진검색
+	void FindKeys(const std::vector<uint32_t>& frames, float frame, uint32_t* cursor, size_t& left, size_t& right, float& alpha)
+	{
+		if (frames.size() == 1 || frame <= frames.front())
+		{
+			left = right = 0;
+			alpha = 0.0f;
+			return;
+		}
+		if (frame >= frames.back())
+		{
+			left = right = frames.size() - 1;
+			alpha = 0.0f;
+			return;
+		}
+
+		//키는 0부터 오름차순이므로 마지막 키가 size-1이면 빠진 프레임이 없음
+		if (frames.back() == frames.size() - 1)
+		{
+			left = static_cast<size_t>(frame);
+			right = left + 1;
+			alpha = frame - static_cast<float>(left);
+			return;
+		}
+
+		auto isInSegment = [&](size_t keyIndex)
+		{
+			return keyIndex + 1 < frames.size() && frames[keyIndex] <= frame && frame < frames[keyIndex + 1];
+		};
+
+		if (cursor != nullptr && isInSegment(*cursor))
+		{
+			left = *cursor;
+		}
+		else if (cursor != nullptr && isInSegment(*cursor + 1))
+		{
+			left = *cursor + 1;
+		}
+		else
+		{
+			auto iter = std::upper_bound(frames.begin(), frames.end(), frame,
+				[](float value, uint32_t keyFrame) { return value < keyFrame; });
+			left = (iter - frames.begin()) - 1;
+		}
+		right = left + 1;
+		alpha = (frame - frames[left]) / (frames[right] - frames[left]);
+
+		if (cursor != nullptr)
+		{
+			*cursor = static_cast<uint32_t>(left);
+		}
+	}
+
+	//구간 [start, end] 양끝 키로 보간해도 오차가 허용범위면 구간을 늘림
+	template<class IsSegmentValidFunc>
+	std::vector<uint32_t> ReduceKeys(uint32_t frameCount, IsSegmentValidFunc isSegmentValid)
+	{
+		std::vector<uint32_t> keys;
+		keys.push_back(0);
+
+		uint32_t start = 0;
+		while (start + 1 < frameCount)
+		{
+			uint32_t end = start + 1;
+			while (end + 1 < frameCount && end + 1 - start <= MaxKeyGap && isSegmentValid(start, end + 1))
+			{
+				++end;
+			}
+			keys.push_back(end);
+			start = end;
+		}
+		return keys;
+	}
+
+	uint16_t QuantizeUnit(float value, float maxValue)
+	{
+		value = (std::max)(0.0f, (std::min)(1.0f, value));
+		return static_cast<uint16_t>(std::lround(value * maxValue));
+	}
+
+	void EncodeRotation(const Float4& q, uint16_t* result)
+	{
+		int largest = 0;
+		for (int i = 1; i < 4; ++i)
+		{
+			if (std::fabs(q[i]) > std::fabs(q[largest]))
+			{
+				largest = i;
+			}
+		}
+		//q와 -q는 같은 회전, 가장 큰 성분이 양수가 되도록
+		float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+		uint64_t packed = static_cast<uint64_t>(largest) << 45;
+		int shift = 30;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+			float normalized = (q[i] * sign / RotationComponentRange) * 0.5f + 0.5f;
+			packed |= static_cast<uint64_t>(QuantizeUnit(normalized, RotationQuantizeMax)) << shift;
+			shift -= 15;
+		}
+
+		result[0] = static_cast<uint16_t>(packed & 0xFFFF);
+		result[1] = static_cast<uint16_t>((packed >> 16) & 0xFFFF);
+		result[2] = static_cast<uint16_t>((packed >> 32) & 0xFFFF);
+	}
+
+	Float4 DecodeRotation(const uint16_t* values)
+	{
+		uint64_t packed = static_cast<uint64_t>(values[0]) |
+			(static_cast<uint64_t>(values[1]) << 16) |
+			(static_cast<uint64_t>(values[2]) << 32);
+
+		int largest = static_cast<int>((packed >> 45) & 0x3);
+
+		Float4 q;
+		float sumOfSquares = 0.0f;
+		int shift = 30;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+			float normalized = static_cast<float>((packed >> shift) & 0x7FFF) / RotationQuantizeMax;
+			q[i] = (normalized - 0.5f) * 2.0f * RotationComponentRange;
+			sumOfSquares += q[i] * q[i];
+			shift -= 15;
+		}
+		q[largest] = std::sqrt((std::max)(0.0f, 1.0f - sumOfSquares));
+		return q;
+	}
+
+	CompressedVectorTrack CompressVectorTrack(const std::vector<Float3>& raw, float tolerance)
+	{
+		CompressedVectorTrack track;
+		uint32_t frameCount = static_cast<uint32_t>(raw.size());
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float minValue = raw[0][axis];
+			float maxValue = raw[0][axis];
+			for (const Float3& value : raw)
+			{
+				minValue = (std::min)(minValue, value[axis]);
+				maxValue = (std::max)(maxValue, value[axis]);
+			}
+			track.Min[axis] = minValue;
+			track.Extent[axis] = maxValue - minValue;
+		}
+
+		//프레임마다 양자화, 키 제거는 복원한 값 기준으로 오차 계산
+		std::vector<uint16_t> quantized(raw.size() * 3);
+		std::vector<Float3> decoded(raw.size());
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				float extent = track.Extent[axis];
+				float normalized = extent > 0.0f ? (raw[frame][axis] - track.Min[axis]) / extent : 0.0f;
+				uint16_t value = QuantizeUnit(normalized, VectorQuantizeMax);
+				quantized[frame * 3 + axis] = value;
+				decoded[frame][axis] = track.Min[axis] + value * (extent / VectorQuantizeMax);
+			}
+		}
+
+		//어느 프레임이든 키가 될수있으므로 모든 프레임의 양자화 오차가 허용범위여야함
+		bool isQuantized = true;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			if (Distance(decoded[frame], raw[frame]) > tolerance)
+			{
+				isQuantized = false;
+				decoded = raw;
+				break;
+			}
+		}
+
+		bool isConstant = std::all_of(raw.begin(), raw.end(),
+			[&](const Float3& value) { return Distance(decoded[0], value) <= tolerance; });
+
+		if (isConstant)
+		{
+			track.Frames.push_back(0);
+		}
+		else
+		{
+			track.Frames = ReduceKeys(frameCount, [&](uint32_t start, uint32_t end)
+				{
+					for (uint32_t frame = start + 1; frame < end; ++frame)
+					{
+						float t = static_cast<float>(frame - start) / (end - start);
+						if (Distance(Lerp(decoded[start], decoded[end], t), raw[frame]) > tolerance)
+						{
+							return false;
+						}
+					}
+					return true;
+				});
+		}
+
+		if (isQuantized == false)
+		{
+			track.RawValues.reserve(track.Frames.size() * 3);
+			for (uint32_t frame : track.Frames)
+			{
+				track.RawValues.insert(track.RawValues.end(), raw[frame].begin(), raw[frame].end());
+			}
+			return track;
+		}
+
+		track.Values.reserve(track.Frames.size() * 3);
+		for (uint32_t frame : track.Frames)
+		{
+			track.Values.insert(track.Values.end(), quantized.begin() + frame * 3, quantized.begin() + frame * 3 + 3);
+		}
+		return track;
+	}
+
+	CompressedRotationTrack CompressRotationTrack(const std::vector<Float4>& raw, float tolerance)
+	{
+		CompressedRotationTrack track;
+		uint32_t frameCount = static_cast<uint32_t>(raw.size());
+
+		std::vector<uint16_t> quantized(raw.size() * 3);
+		std::vector<Float4> decoded(raw.size());
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			EncodeRotation(raw[frame], &quantized[frame * 3]);
+			decoded[frame] = DecodeRotation(&quantized[frame * 3]);
+		}
+
+		bool isQuantized = true;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			if (AngleBetween(decoded[frame], raw[frame]) > tolerance)
+			{
+				isQuantized = false;
+				decoded = raw;
+				break;
+			}
+		}
+
+		bool isConstant = std::all_of(raw.begin(), raw.end(),
+			[&](const Float4& value) { return AngleBetween(decoded[0], value) <= tolerance; });
+
+		if (isConstant)
+		{
+			track.Frames.push_back(0);
+		}
+		else
+		{
+			track.Frames = ReduceKeys(frameCount, [&](uint32_t start, uint32_t end)
+				{
+					for (uint32_t frame = start + 1; frame < end; ++frame)
+					{
+						float t = static_cast<float>(frame - start) / (end - start);
+						if (AngleBetween(Slerp(decoded[start], decoded[end], t), raw[frame]) > tolerance)
+						{
+							return false;
+						}
+					}
+					return true;
+				});
+		}
+
+		if (isQuantized == false)
+		{
+			track.RawValues.reserve(track.Frames.size() * 4);
+			for (uint32_t frame : track.Frames)
+			{
+				track.RawValues.insert(track.RawValues.end(), raw[frame].begin(), raw[frame].end());
+			}
+			return track;
+		}
+
+		track.Values.reserve(track.Frames.size() * 3);
+		for (uint32_t frame : track.Frames)
+		{
+			track.Values.insert(track.Values.end(), quantized.begin() + frame * 3, quantized.begin() + frame * 3 + 3);
+		}
+		return track;
+	}
+
+	template<class T>
+	size_t GetVectorMemorySize(const std::vector<T>& values)
+	{
+		return values.capacity() * sizeof(T);
+	}
+}
+
+void AnimationCompressionStats::Merge(const AnimationCompressionStats& other)
+{
+	RawSize += other.RawSize;
+	CompressedSize += other.CompressedSize;
+	MaxTranslationError = (std::max)(MaxTranslationError, other.MaxTranslationError);
+	MaxRotationError = (std::max)(MaxRotationError, other.MaxRotationError);
+	MaxScaleError = (std::max)(MaxScaleError, other.MaxScaleError);
+}
+
+void CompressedVectorTrack::Decode(size_t keyIndex, float* result) const
+{
+	if (RawValues.empty() == false)
+	{
+		std::copy(RawValues.begin() + keyIndex * 3, RawValues.begin() + keyIndex * 3 + 3, result);
+		return;
+	}
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		result[axis] = Min[axis] + Values[keyIndex * 3 + axis] * (Extent[axis] / VectorQuantizeMax);
+	}
+}
+
+void CompressedVectorTrack::DecodeLanes(const size_t* keyIndices, XMVECTOR* result) const
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (RawValues.empty() == false)
+		{
+			result[axis] = XMVectorSet(RawValues[keyIndices[0] * 3 + axis], RawValues[keyIndices[1] * 3 + axis],
+				RawValues[keyIndices[2] * 3 + axis], RawValues[keyIndices[3] * 3 + axis]);
+			continue;
+		}
+
+		XMVECTOR quantized = XMVectorSet(Values[keyIndices[0] * 3 + axis], Values[keyIndices[1] * 3 + axis],
+			Values[keyIndices[2] * 3 + axis], Values[keyIndices[3] * 3 + axis]);
+		result[axis] = XMVectorAdd(XMVectorReplicate(Min[axis]), XMVectorMultiply(quantized, XMVectorReplicate(Extent[axis] / VectorQuantizeMax)));
+	}
+}
+
+void CompressedVectorTrack::FindKeyIndices(float frame, uint32_t* cursor, size_t& leftKey, size_t& rightKey, float& alpha) const
+{
+	FindKeys(Frames, frame, cursor, leftKey, rightKey, alpha);
+}
+
+void CompressedVectorTrack::SampleKeys(float frame, uint32_t* cursor, float* left, float* right, float& alpha) const
+{
+	size_t leftKey, rightKey;
+	FindKeys(Frames, frame, cursor, leftKey, rightKey, alpha);
+	Decode(leftKey, left);
+	Decode(rightKey, right);
+}
+
+void CompressedVectorTrack::Sample(float frame, float* result, uint32_t* cursor) const
+{
+	Float3 leftValue, rightValue;
+	float alpha;
+	SampleKeys(frame, cursor, leftValue.data(), rightValue.data(), alpha);
+
+	Float3 value = Lerp(leftValue, rightValue, alpha);
+	std::copy(value.begin(), value.end(), result);
+}
+
+void CompressedRotationTrack::Decode(size_t keyIndex, float* result) const
+{
+	if (RawValues.empty() == false)
+	{
+		std::copy(RawValues.begin() + keyIndex * 4, RawValues.begin() + keyIndex * 4 + 4, result);
+		return;
+	}
+
+	Float4 value = DecodeRotation(&Values[keyIndex * 3]);
+	std::copy(value.begin(), value.end(), result);
+}
+
+void CompressedRotationTrack::DecodeLanes(const size_t* keyIndices, XMVECTOR* result) const
+{
+	if (RawValues.empty() == false)
+	{
+		for (int axis = 0; axis < 4; ++axis)
+		{
+			result[axis] = XMVectorSet(RawValues[keyIndices[0] * 4 + axis], RawValues[keyIndices[1] * 4 + axis],
+				RawValues[keyIndices[2] * 4 + axis], RawValues[keyIndices[3] * 4 + axis]);
+		}
+		return;
+	}
+
+	//비트 풀기만 키마다 하고 나머지는 DecodeRotation을 4개씩
+	XMFLOAT4 largestLanes;
+	XMFLOAT4 quantizedLanes[3];
+	float* largest = &largestLanes.x;
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		const uint16_t* values = &Values[keyIndices[lane] * 3];
+		uint64_t packed = static_cast<uint64_t>(values[0]) |
+			(static_cast<uint64_t>(values[1]) << 16) |
+			(static_cast<uint64_t>(values[2]) << 32);
+
+		largest[lane] = static_cast<float>((packed >> 45) & 0x3);
+		for (int i = 0; i < 3; ++i)
+		{
+			(&quantizedLanes[i].x)[lane] = static_cast<float>((packed >> (30 - 15 * i)) & 0x7FFF);
+		}
+	}
+
+	//가장 큰 성분을 뺀 나머지 3개, 성분 순서대로
+	XMVECTOR components[3];
+	XMVECTOR sumOfSquares = XMVectorZero();
+	for (int i = 0; i < 3; ++i)
+	{
+		XMVECTOR normalized = XMVectorDivide(XMLoadFloat4(&quantizedLanes[i]), XMVectorReplicate(RotationQuantizeMax));
+		components[i] = XMVectorMultiply(XMVectorScale(XMVectorSubtract(normalized, XMVectorReplicate(0.5f)), 2.0f), XMVectorReplicate(RotationComponentRange));
+		sumOfSquares = XMVectorAdd(sumOfSquares, XMVectorMultiply(components[i], components[i]));
+	}
+	XMVECTOR largestValue = XMVectorSqrt(XMVectorMax(XMVectorZero(), XMVectorSubtract(g_XMOne, sumOfSquares)));
+
+	//axis가 가장 큰 성분보다 앞이면 components[axis], 뒤면 components[axis - 1]
+	XMVECTOR largestIndex = XMLoadFloat4(&largestLanes);
+	for (int axis = 0; axis < 4; ++axis)
+	{
+		XMVECTOR axisIndex = XMVectorReplicate(static_cast<float>(axis));
+		XMVECTOR before = axis < 3 ? components[axis] : XMVectorZero();
+		XMVECTOR after = axis > 0 ? components[axis - 1] : XMVectorZero();
+		XMVECTOR value = XMVectorSelect(after, before, XMVectorLess(axisIndex, largestIndex));
+		result[axis] = XMVectorSelect(value, largestValue, XMVectorEqual(axisIndex, largestIndex));
+	}
+}
+
+void CompressedRotationTrack::FindKeyIndices(float frame, uint32_t* cursor, size_t& leftKey, size_t& rightKey, float& alpha) const
+{
+	FindKeys(Frames, frame, cursor, leftKey, rightKey, alpha);
+}
+
+void CompressedRotationTrack::SampleKeys(float frame, uint32_t* cursor, float* left, float* right, float& alpha) const
+{
+	size_t leftKey, rightKey;
+	FindKeys(Frames, frame, cursor, leftKey, rightKey, alpha);
+	Decode(leftKey, left);
+	Decode(rightKey, right);
+}
+
+void CompressedRotationTrack::Sample(float frame, float* result, uint32_t* cursor) const
+{
+	Float4 leftValue, rightValue;
+	float alpha;
+	SampleKeys(frame, cursor, leftValue.data(), rightValue.data(), alpha);
+	if (alpha == 0.0f)
+	{
+		std::copy(leftValue.begin(), leftValue.end(), result);
+		return;
+	}
+
+	Float4 value = Slerp(leftValue, rightValue, alpha);
+	std::copy(value.begin(), value.end(), result);
+}
+
+void CompressedBoneTrack::Sample(float frame, XMVECTOR& scale, XMVECTOR& rotation, XMVECTOR& translation,
+	BoneTrackCursor* cursor) const
+{
+	if (FrameCount == 0)
+	{
+		scale = XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f);
+		rotation = XMQuaternionIdentity();
+		translation = XMVectorZero();
+		return;
+	}
+
+	Float3 scaleValue, translationValue;
+	Float4 rotationValue;
+	Scale.Sample(frame, scaleValue.data(), cursor ? &cursor->Scale : nullptr);
+	Rotation.Sample(frame, rotationValue.data(), cursor ? &cursor->Rotation : nullptr);
+	Translation.Sample(frame, translationValue.data(), cursor ? &cursor->Translation : nullptr);
+
+	scale = XMVectorSet(scaleValue[0], scaleValue[1], scaleValue[2], 0.0f);
+	rotation = XMVectorSet(rotationValue[0], rotationValue[1], rotationValue[2], rotationValue[3]);
+	translation = XMVectorSet(translationValue[0], translationValue[1], translationValue[2], 0.0f);
+}
+
+size_t CompressedBoneTrack::GetMemorySize() const
+{
+	return sizeof(CompressedBoneTrack) +
+		GetVectorMemorySize(Scale.Frames) + GetVectorMemorySize(Scale.Values) + GetVectorMemorySize(Scale.RawValues) +
+		GetVectorMemorySize(Rotation.Frames) + GetVectorMemorySize(Rotation.Values) + GetVectorMemorySize(Rotation.RawValues) +
+		GetVectorMemorySize(Translation.Frames) + GetVectorMemorySize(Translation.Values) + GetVectorMemorySize(Translation.RawValues);
+}
+
+CompressedBoneTrack AnimationCompressor::Compress(const std::vector<AffineMatrix>& frames,
+	const AnimationCompressionSettings& settings, AnimationCompressionStats& stats)
+{
+	CompressedBoneTrack track;
+	track.FrameCount = static_cast<uint32_t>(frames.size());
+	if (frames.empty())
+	{
+		return track;
+	}
+
+	std::vector<Float3> scales(frames.size());
+	std::vector<Float4> rotations(frames.size());
+	std::vector<Float3> translations(frames.size());
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		XMFLOAT3 scale, translation;
+		XMFLOAT4 rotation;
+		XMStoreFloat3(&scale, frames[i].Scale);
+		XMStoreFloat4(&rotation, XMQuaternionNormalize(frames[i].Quaternion));
+		XMStoreFloat3(&translation, frames[i].Translation);
+
+		scales[i] = { scale.x, scale.y, scale.z };
+		rotations[i] = { rotation.x, rotation.y, rotation.z, rotation.w };
+		translations[i] = { translation.x, translation.y, translation.z };
+
+		//이웃 프레임과 같은 반구로 맞춤
+		if (i > 0 && Dot(rotations[i - 1], rotations[i]) < 0.0f)
+		{
+			for (float& value : rotations[i])
+			{
+				value = -value;
+			}
+		}
+	}
+
+	track.Scale = CompressVectorTrack(scales, settings.ScaleTolerance);
+	track.Rotation = CompressRotationTrack(rotations, settings.RotationTolerance);
+	track.Translation = CompressVectorTrack(translations, settings.TranslationTolerance);
+
+	//원본 프레임 전체와 비교
+	AnimationCompressionStats trackStats;
+	trackStats.RawSize = frames.size() * sizeof(AffineMatrix);
+	trackStats.CompressedSize = track.GetMemorySize();
+	BoneTrackCursor cursor;
+	for (uint32_t frame = 0; frame < track.FrameCount; ++frame)
+	{
+		Float3 scale, translation;
+		Float4 rotation;
+		track.Scale.Sample(static_cast<float>(frame), scale.data(), &cursor.Scale);
+		track.Rotation.Sample(static_cast<float>(frame), rotation.data(), &cursor.Rotation);
+		track.Translation.Sample(static_cast<float>(frame), translation.data(), &cursor.Translation);
+
+		trackStats.MaxScaleError = (std::max)(trackStats.MaxScaleError, Distance(scale, scales[frame]));
+		trackStats.MaxRotationError = (std::max)(trackStats.MaxRotationError, AngleBetween(rotation, rotations[frame]));
+		trackStats.MaxTranslationError = (std::max)(trackStats.MaxTranslationError, Distance(translation, translations[frame]));
+	}
+	stats.Merge(trackStats);
+
+	return track;
+}
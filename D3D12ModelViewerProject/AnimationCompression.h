@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "D3DUtil.h"
+
+//키 제거 허용오차
+struct AnimationCompressionSettings
+{
+	//Scene 단위 거리
+	float TranslationTolerance = 0.001f;
+	//radian
+	float RotationTolerance = 0.0005f;
+	float ScaleTolerance = 0.0001f;
+};
+
+//압축결과 크기와 원본 프레임 대비 최대오차
+struct AnimationCompressionStats
+{
+	size_t RawSize = 0;
+	size_t CompressedSize = 0;
+
+	float MaxTranslationError = 0.0f;
+	float MaxRotationError = 0.0f;
+	float MaxScaleError = 0.0f;
+
+	void Merge(const AnimationCompressionStats& other);
+};
+
+//트랙별로 마지막에 찾은 키 인덱스, 재생시간은 조금씩 움직이므로 다음 검색을 여기서 시작
+struct BoneTrackCursor
+{
+	uint32_t Scale = 0;
+	uint32_t Rotation = 0;
+	uint32_t Translation = 0;
+};
+
+//float3 트랙, 트랙 범위(Min ~ Min+Extent)를 16bit로 양자화
+//범위가 커서 양자화 오차가 허용오차를 넘으면 float로 저장
+//키가 하나면 상수 트랙
+struct CompressedVectorTrack
+{
+	//키가 있는 프레임 (오름차순)
+	std::vector<uint32_t> Frames;
+	//키마다 xyz
+	std::vector<uint16_t> Values;
+	//양자화하지 않은 트랙이면 Values 대신 키마다 xyz
+	std::vector<float> RawValues;
+	float Min[3] = {};
+	float Extent[3] = {};
+
+	void Decode(size_t keyIndex, float* result) const;
+	//키 4개를 한번에 복원, result : xyz 성분마다 키 4개
+	void DecodeLanes(const size_t* keyIndices, DirectX::XMVECTOR* result) const;
+	//frame 양쪽 키 인덱스, 키가 하나면 left == right, alpha = 0
+	void FindKeyIndices(float frame, uint32_t* cursor, size_t& leftKey, size_t& rightKey, float& alpha) const;
+	//frame 양쪽 키를 복원
+	void SampleKeys(float frame, uint32_t* cursor, float* left, float* right, float& alpha) const;
+	//cursor : nullptr이면 이진검색
+	void Sample(float frame, float* result, uint32_t* cursor = nullptr) const;
+};
+
+//회전 트랙, smallest three (2bit 인덱스 + 15bit x 3 을 16bit 3개에 저장)
+struct CompressedRotationTrack
+{
+	std::vector<uint32_t> Frames;
+	//키마다 3개
+	std::vector<uint16_t> Values;
+	//양자화하지 않은 트랙이면 Values 대신 키마다 xyzw
+	std::vector<float> RawValues;
+
+	void Decode(size_t keyIndex, float* result) const;
+	//키 4개를 한번에 복원, result : xyzw 성분마다 키 4개
+	void DecodeLanes(const size_t* keyIndices, DirectX::XMVECTOR* result) const;
+	void FindKeyIndices(float frame, uint32_t* cursor, size_t& leftKey, size_t& rightKey, float& alpha) const;
+	//left, right : xyzw, 부호는 맞추지 않음
+	void SampleKeys(float frame, uint32_t* cursor, float* left, float* right, float& alpha) const;
+	void Sample(float frame, float* result, uint32_t* cursor = nullptr) const;
+};
+
+//본 하나의 Scale, Rotation, Translation
+struct CompressedBoneTrack
+{
+	//원본 프레임수
+	uint32_t FrameCount = 0;
+
+	CompressedVectorTrack Scale;
+	CompressedRotationTrack Rotation;
+	CompressedVectorTrack Translation;
+
+	//frame : 0 ~ FrameCount-1 범위로 잘림
+	void Sample(float frame, DirectX::XMVECTOR& scale, DirectX::XMVECTOR& rotation, DirectX::XMVECTOR& translation,
+		BoneTrackCursor* cursor = nullptr) const;
+
+	size_t GetMemorySize() const;
+};
+
+class AnimationCompressor
+{
+public:
+	//frames : 프레임마다 본 변환, stats에 이 트랙의 크기와 오차를 더함
+	static CompressedBoneTrack Compress(const std::vector<AffineMatrix>& frames,
+		const AnimationCompressionSettings& settings, AnimationCompressionStats& stats);
+};
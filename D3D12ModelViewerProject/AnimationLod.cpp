@@ -0,0 +1,46 @@
+#include "AnimationLod.h"
+
+using namespace DirectX;
+
+void AnimationLodSystem::BeginFrame(const Camera& camera)
+{
+	m_lastFrameStats = m_stats;
+	m_stats = AnimationLodStats();
+
+	BoundingFrustum viewFrustum;
+	BoundingFrustum::CreateFromMatrix(viewFrustum, camera.GetProj());
+
+	XMMATRIX view = camera.GetView();
+	XMMATRIX inverseView = XMMatrixInverse(nullptr, view);
+	viewFrustum.Transform(m_worldFrustum, inverseView);
+
+	m_eyePosition = camera.GetPosition3f();
+	m_screenScale = 1.0f / tanf(0.5f * camera.GetFovY());
+	m_nearZ = camera.GetNearZ();
+}
+
+int AnimationLodSystem::SelectLevel(const BoundingSphere& worldBounds) const
+{
+	if (m_worldFrustum.Contains(worldBounds) == DISJOINT)
+	{
+		return OffscreenLevel;
+	}
+
+	float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&worldBounds.Center), XMLoadFloat3(&m_eyePosition))));
+	float screenSize = worldBounds.Radius * m_screenScale / (std::max)(distance, m_nearZ);
+
+	for (int level = 0; level < LevelCount - 1; ++level)
+	{
+		if (screenSize >= m_levels[level].MinScreenSize)
+		{
+			return level;
+		}
+	}
+	return LevelCount - 1;
+}
+
+AnimationLodSystem& GetAnimationLodSystem()
+{
+	static AnimationLodSystem lodSystem;
+	return lodSystem;
+}
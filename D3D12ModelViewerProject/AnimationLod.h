@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include "Camera.h"
+#include "FrameResource.h"
+
+//화면에서 차지하는 크기별 애니메이션 갱신 단계
+struct AnimationLodLevel
+{
+	//바운딩스피어 반지름 / 화면 절반 높이, 이 값 이상이면 이 단계
+	float MinScreenSize = 0.0f;
+	//몇 프레임마다 포즈를 계산할지, 사이 프레임은 팔레트를 보간
+	int UpdateInterval = 1;
+	//말단에서부터 제외할 본 단계 (0 : 모든 본), 제외된 본은 바인드포즈
+	int DroppedLeafLevels = 0;
+};
+
+//프레임마다 초기화되는 카운터
+struct AnimationLodStats
+{
+	size_t EvaluatedBones = 0;
+	size_t SkippedBones = 0;
+
+	size_t FullRateInstances = 0;
+	size_t ReducedRateInstances = 0;
+	size_t FrozenInstances = 0;
+	//같은 포즈의 팔레트를 재사용한 인스턴스
+	size_t SharedPalettes = 0;
+};
+
+//인스턴스별 LOD 상태
+struct AnimationLodState
+{
+	//-1 : 아직 계산 안함
+	int Level = -1;
+	int FramesSinceUpdate = 0;
+	//보간 구간 양끝 팔레트, 갱신 주기가 1이면 비어있음
+	std::vector<InstanceAnimations> FromPalette;
+	std::vector<InstanceAnimations> ToPalette;
+};
+
+//카메라 거리, 가시성으로 인스턴스의 애니메이션 갱신 단계를 정함
+class AnimationLodSystem
+{
+public:
+	static constexpr int LevelCount = 3;
+	//화면밖
+	static constexpr int OffscreenLevel = -1;
+public:
+	//씬 업데이트 전에 호출, 통계는 지난 프레임 것으로 넘어감
+	void BeginFrame(const Camera& camera);
+	int SelectLevel(const DirectX::BoundingSphere& worldBounds) const;
+
+	const AnimationLodLevel& GetLevel(int level) const { return m_levels.at(level); }
+	void SetLevel(int level, const AnimationLodLevel& lodLevel) { m_levels.at(level) = lodLevel; }
+
+	bool IsEnabled() const { return m_enable; }
+	void SetEnable(bool enable) { m_enable = enable; }
+	bool IsFreezeOffscreen() const { return m_freezeOffscreen; }
+	void SetFreezeOffscreen(bool freeze) { m_freezeOffscreen = freeze; }
+
+	AnimationLodStats& GetStats() { return m_stats; }
+	const AnimationLodStats& GetLastFrameStats() const { return m_lastFrameStats; }
+private:
+	std::array<AnimationLodLevel, LevelCount> m_levels = { {
+		{ 0.25f, 1, 0 },
+		{ 0.08f, 2, 1 },
+		{ 0.0f, 4, 2 } } };
+
+	bool m_enable = true;
+	bool m_freezeOffscreen = true;
+
+	DirectX::BoundingFrustum m_worldFrustum;
+	DirectX::XMFLOAT3 m_eyePosition = { 0.0f,0.0f,0.0f };
+	//1 / tan(fovY / 2)
+	float m_screenScale = 1.0f;
+	float m_nearZ = 1.0f;
+
+	AnimationLodStats m_stats;
+	AnimationLodStats m_lastFrameStats;
+};
+
+AnimationLodSystem& GetAnimationLodSystem();
@@ -0,0 +1,62 @@
+#include "AnimationLodControl.h"
+#include <string>
+
+using namespace std;
+
+void AnimationLodControl::Show()
+{
+	if (ImGui::Begin("Animation LOD") == false)
+	{
+		ImGui::End();
+		return;
+	}
+
+	AnimationLodSystem& lodSystem = GetAnimationLodSystem();
+
+	bool enable = lodSystem.IsEnabled();
+	if (ImGui::Checkbox("Enable", &enable))
+	{
+		lodSystem.SetEnable(enable);
+	}
+
+	bool freezeOffscreen = lodSystem.IsFreezeOffscreen();
+	if (ImGui::Checkbox("Freeze Offscreen", &freezeOffscreen))
+	{
+		lodSystem.SetFreezeOffscreen(freezeOffscreen);
+	}
+
+	if (ImGui::CollapsingHeader("Levels"))
+	{
+		for (int level = 0; level < AnimationLodSystem::LevelCount; ++level)
+		{
+			AnimationLodLevel lodLevel = lodSystem.GetLevel(level);
+			string levelId = "LOD" + to_string(level);
+			if (ImGui::TreeNode(levelId.c_str()))
+			{
+				ImGui::SetNextItemWidth(200.0f);
+				ImGui::DragFloat("Min Screen Size", &lodLevel.MinScreenSize, 0.01f, 0.0f, 10.0f);
+
+				ImGui::SetNextItemWidth(200.0f);
+				ImGui::DragInt("Update Interval", &lodLevel.UpdateInterval, 0.1f, 1, 16);
+
+				ImGui::SetNextItemWidth(200.0f);
+				ImGui::DragInt("Dropped Leaf Levels", &lodLevel.DroppedLeafLevels, 0.1f, 0, 8);
+
+				lodSystem.SetLevel(level, lodLevel);
+				ImGui::TreePop();
+			}
+		}
+	}
+
+	//지난 프레임 카운터
+	const AnimationLodStats& stats = lodSystem.GetLastFrameStats();
+	ImGui::Separator();
+	ImGui::Text("Evaluated Bones : %zu", stats.EvaluatedBones);
+	ImGui::Text("Skipped Bones : %zu", stats.SkippedBones);
+	ImGui::Text("Full Rate Instances : %zu", stats.FullRateInstances);
+	ImGui::Text("Reduced Rate Instances : %zu", stats.ReducedRateInstances);
+	ImGui::Text("Frozen Instances : %zu", stats.FrozenInstances);
+	ImGui::Text("Shared Palettes : %zu", stats.SharedPalettes);
+
+	ImGui::End();
+}
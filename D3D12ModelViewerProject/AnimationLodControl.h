@@ -0,0 +1,10 @@
+#pragma once
+
+#include "ImGUIControl.h"
+#include "AnimationLod.h"
+
+class AnimationLodControl
+{
+public:
+	void Show();
+};
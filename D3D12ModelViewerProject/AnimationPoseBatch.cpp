@@ -0,0 +1,463 @@
+#include "AnimationPoseBatch.h"
+#include "Skinning.h"
+
+using namespace DirectX;
+
+namespace
+{
+	using LaneValues = float[AnimationPoseBatch::LaneCount];
+
+	XMVECTOR LoadLanes(const LaneValues& values)
+	{
+		return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(values));
+	}
+
+	void StoreLanes(LaneValues& values, FXMVECTOR vector)
+	{
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(values), vector);
+	}
+
+	//q0, q1, result : x, y, z, w 성분마다 레인 4개
+	void SlerpLanes(const XMVECTOR* q0, const XMVECTOR* q1, FXMVECTOR t, XMVECTOR* result)
+	{
+		XMVECTOR cosOmega = XMVectorMultiply(q0[0], q1[0]);
+		for (int i = 1; i < 4; ++i)
+		{
+			cosOmega = XMVectorMultiplyAdd(q0[i], q1[i], cosOmega);
+		}
+
+		//반대 반구면 q1을 뒤집어서 최단경로로 보간
+		XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(cosOmega, XMVectorZero()));
+		cosOmega = XMVectorAbs(cosOmega);
+
+		XMVECTOR oneMinusT = XMVectorSubtract(g_XMOne, t);
+		XMVECTOR omega = XMVectorACos(cosOmega);
+		XMVECTOR sinOmega = XMVectorSin(omega);
+		XMVECTOR scale0 = XMVectorDivide(XMVectorSin(XMVectorMultiply(oneMinusT, omega)), sinOmega);
+		XMVECTOR scale1 = XMVectorDivide(XMVectorSin(XMVectorMultiply(t, omega)), sinOmega);
+
+		//거의 같은 회전이면 lerp
+		XMVECTOR isNear = XMVectorGreater(cosOmega, XMVectorReplicate(0.9999f));
+		scale0 = XMVectorSelect(scale0, oneMinusT, isNear);
+		scale1 = XMVectorMultiply(XMVectorSelect(scale1, t, isNear), sign);
+
+		XMVECTOR lengthSquared = XMVectorZero();
+		for (int i = 0; i < 4; ++i)
+		{
+			result[i] = XMVectorMultiplyAdd(q0[i], scale0, XMVectorMultiply(q1[i], scale1));
+			lengthSquared = XMVectorMultiplyAdd(result[i], result[i], lengthSquared);
+		}
+
+		XMVECTOR inverseLength = XMVectorReciprocalSqrt(lengthSquared);
+		for (int i = 0; i < 4; ++i)
+		{
+			result[i] = XMVectorMultiply(result[i], inverseLength);
+		}
+	}
+
+	//base에 sample을 weight만큼 보간
+	void BlendOverride(XMVECTOR& scale, XMVECTOR& rotation, XMVECTOR& translation,
+		FXMVECTOR sampleScale, FXMVECTOR sampleRotation, FXMVECTOR sampleTranslation, float weight)
+	{
+		scale = XMVectorLerp(scale, sampleScale, weight);
+		rotation = XMQuaternionSlerp(rotation, sampleRotation, weight);
+		translation = XMVectorLerp(translation, sampleTranslation, weight);
+	}
+
+	//reference 대비 sample 차이를 weight만큼 base에 더함
+	void BlendAdditive(XMVECTOR& scale, XMVECTOR& rotation, XMVECTOR& translation,
+		FXMVECTOR sampleScale, FXMVECTOR sampleRotation, FXMVECTOR sampleTranslation,
+		GXMVECTOR referenceScale, HXMVECTOR referenceRotation, HXMVECTOR referenceTranslation, float weight)
+	{
+		XMVECTOR isZero = XMVectorNearEqual(referenceScale, XMVectorZero(), XMVectorReplicate(1e-6f));
+		XMVECTOR scaleRatio = XMVectorSelect(XMVectorDivide(sampleScale, referenceScale), g_XMOne, isZero);
+		scale = XMVectorMultiply(scale, XMVectorLerp(g_XMOne, scaleRatio, weight));
+
+		XMVECTOR deltaRotation = XMQuaternionMultiply(XMQuaternionInverse(referenceRotation), sampleRotation);
+		deltaRotation = XMQuaternionSlerp(XMQuaternionIdentity(), deltaRotation, weight);
+		rotation = XMQuaternionNormalize(XMQuaternionMultiply(rotation, deltaRotation));
+
+		translation = XMVectorMultiplyAdd(XMVectorSubtract(sampleTranslation, referenceTranslation), XMVectorReplicate(weight), translation);
+	}
+}
+
+void AnimationPoseBatch::Begin(const Skeleton& skeleton)
+{
+	m_poseInstanceIndices.clear();
+	m_poseDroppedLeafLevels.clear();
+	m_poseCaptures.clear();
+	m_paletteCache.clear();
+
+	const size_t boneCount = skeleton.Joints.size();
+	if (m_skeleton == &skeleton && m_bindLocalPoses.size() == boneCount)
+	{
+		return;
+	}
+	m_skeleton = &skeleton;
+
+	//바인드포즈 로컬변환, 조인트는 부모가 먼저 옴
+	m_bindposeInverses.resize(boneCount);
+	m_bindLocalPoses.resize(boneCount);
+	m_globalTransforms.resize(boneCount);
+	for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		const Joint& joint = skeleton.Joints[boneIndex];
+		m_bindposeInverses[boneIndex] = joint.GlobalBindposeInverseTransform.GetFinalTransformMatrix();
+		m_globalTransforms[boneIndex] = XMMatrixInverse(nullptr, m_bindposeInverses[boneIndex]);
+
+		XMMATRIX localTransform = joint.ParentIndex < 0 ? m_globalTransforms[boneIndex] :
+			XMMatrixMultiply(m_globalTransforms[boneIndex], m_bindposeInverses[joint.ParentIndex]);
+
+		XMVECTOR scale, rotation, translation;
+		if (XMMatrixDecompose(&scale, &rotation, &translation, localTransform) == false)
+		{
+			scale = g_XMOne;
+			rotation = XMQuaternionIdentity();
+			translation = XMVectorZero();
+		}
+
+		LocalPose& bindPose = m_bindLocalPoses[boneIndex];
+		XMStoreFloat3(&bindPose.Scale, scale);
+		XMStoreFloat4(&bindPose.Rotation, rotation);
+		XMStoreFloat3(&bindPose.Translation, translation);
+		bindPose.Weight = 1.0f;
+	}
+
+	//자식이 부모보다 뒤에 있으므로 뒤에서부터 부모로 올림
+	m_boneHeights.assign(boneCount, 0);
+	for (size_t boneIndex = boneCount; boneIndex-- > 0;)
+	{
+		int parentIndex = skeleton.Joints[boneIndex].ParentIndex;
+		if (parentIndex >= 0)
+		{
+			m_boneHeights[parentIndex] = (std::max)(m_boneHeights[parentIndex], m_boneHeights[boneIndex] + 1);
+		}
+	}
+}
+
+size_t AnimationPoseBatch::AddPose(size_t instanceIndex, int droppedLeafLevels, std::vector<InstanceAnimations>* capture)
+{
+	m_poseInstanceIndices.push_back(instanceIndex);
+	m_poseDroppedLeafLevels.push_back(droppedLeafLevels);
+	m_poseCaptures.push_back(capture);
+	if (capture != nullptr)
+	{
+		capture->resize(m_bindLocalPoses.size());
+	}
+	return m_poseInstanceIndices.size() - 1;
+}
+
+bool AnimationPoseBatch::FindSharedPalette(const AnimationClip* clip, float time, int droppedLeafLevels, size_t instanceIndex, size_t& ownerInstanceIndex)
+{
+	int quantizedTime = static_cast<int>(time / PaletteCacheTimeStep + 0.5f);
+	auto result = m_paletteCache.emplace(PaletteCacheKey(m_skeleton, clip, quantizedTime, droppedLeafLevels), instanceIndex);
+
+	ownerInstanceIndex = result.first->second;
+	return result.second == false;
+}
+
+size_t AnimationPoseBatch::GetActiveBoneCount(int droppedLeafLevels) const
+{
+	return std::count_if(m_boneHeights.begin(), m_boneHeights.end(),
+		[droppedLeafLevels](int height) { return height >= droppedLeafLevels; });
+}
+
+void AnimationPoseBatch::AddSample(const PoseBatchSample& sample)
+{
+	const size_t boneCount = m_bindLocalPoses.size();
+	if (sample.Clip == nullptr || sample.Weight <= 0.0f || sample.Clip->BoneAnimations.size() != boneCount)
+	{
+		return;
+	}
+
+	sample.Cursors->resize(boneCount);
+	m_sampleGroups[SampleGroupKey(sample.Layer, sample.BlendMode, sample.Clip)].push_back(sample);
+}
+
+void AnimationPoseBatch::Execute(const PaletteWriter& writePalette)
+{
+	SamplePoses();
+
+	m_palette.resize(m_bindLocalPoses.size());
+	for (size_t poseIndex = 0; poseIndex < m_poseInstanceIndices.size(); ++poseIndex)
+	{
+		std::vector<InstanceAnimations>* capture = m_poseCaptures[poseIndex];
+		if (capture != nullptr)
+		{
+			WritePalette(poseIndex, capture->data(), nullptr, nullptr);
+			continue;
+		}
+
+		WritePalette(poseIndex, m_palette.data(), nullptr, nullptr);
+		writePalette(m_poseInstanceIndices[poseIndex], m_palette.data());
+	}
+
+	EndExecute();
+}
+
+void AnimationPoseBatch::Execute(InstanceAnimations* paletteBase, const std::vector<JointBounds>& jointBounds, const BoundsWriter& writeBounds)
+{
+	SamplePoses();
+
+	const size_t boneCount = m_bindLocalPoses.size();
+	m_jointBoundsIndices.assign(boneCount, -1);
+	for (size_t i = 0; i < jointBounds.size(); ++i)
+	{
+		m_jointBoundsIndices[jointBounds[i].JointIndex] = static_cast<int>(i);
+	}
+
+	for (size_t poseIndex = 0; poseIndex < m_poseInstanceIndices.size(); ++poseIndex)
+	{
+		std::vector<InstanceAnimations>* capture = m_poseCaptures[poseIndex];
+		if (capture != nullptr)
+		{
+			WritePalette(poseIndex, capture->data(), nullptr, nullptr);
+			continue;
+		}
+
+		const size_t instanceIndex = m_poseInstanceIndices[poseIndex];
+		BoundingBox bounds;
+		WritePalette(poseIndex, paletteBase + instanceIndex * boneCount, &jointBounds, &bounds);
+		writeBounds(instanceIndex, bounds);
+	}
+
+	EndExecute();
+}
+
+void AnimationPoseBatch::SamplePoses()
+{
+	const size_t boneCount = m_bindLocalPoses.size();
+	const size_t poseCount = m_poseInstanceIndices.size();
+
+	m_localPoses.assign(poseCount * boneCount, LocalPose());
+
+	//기본 레이어를 모두 더한 뒤에 위 레이어를 섞음
+	bool isBaseResolved = false;
+	auto iter = m_sampleGroups.begin();
+	while (iter != m_sampleGroups.end())
+	{
+		std::vector<PoseBatchSample>& samples = iter->second;
+		if (samples.empty())
+		{
+			iter = m_sampleGroups.erase(iter);
+			continue;
+		}
+
+		if (std::get<0>(iter->first) > 0 && isBaseResolved == false)
+		{
+			ResolveBasePoses();
+			isBaseResolved = true;
+		}
+
+		const AnimationClip& clip = *std::get<2>(iter->first);
+		for (size_t first = 0; first < samples.size(); first += LaneCount)
+		{
+			SampleLanes(clip, &samples[first], (std::min)(LaneCount, samples.size() - first));
+		}
+
+		samples.clear();
+		++iter;
+	}
+
+	if (isBaseResolved == false)
+	{
+		ResolveBasePoses();
+	}
+}
+
+void AnimationPoseBatch::WritePalette(size_t poseIndex, InstanceAnimations* palette, const std::vector<JointBounds>* jointBounds, BoundingBox* bounds)
+{
+	const size_t boneCount = m_bindLocalPoses.size();
+	XMVECTOR minPosition = XMVectorReplicate(FLT_MAX);
+	XMVECTOR maxPosition = XMVectorReplicate(-FLT_MAX);
+
+	const LocalPose* localPoses = &m_localPoses[poseIndex * boneCount];
+	for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		const LocalPose& localPose = localPoses[boneIndex];
+		XMMATRIX localTransform = XMMatrixAffineTransformation(
+			XMLoadFloat3(&localPose.Scale), XMVectorZero(), XMLoadFloat4(&localPose.Rotation), XMLoadFloat3(&localPose.Translation));
+
+		int parentIndex = m_skeleton->Joints[boneIndex].ParentIndex;
+		m_globalTransforms[boneIndex] = parentIndex < 0 ?
+			localTransform : XMMatrixMultiply(localTransform, m_globalTransforms[parentIndex]);
+
+		//업로드 버퍼는 읽으면 느리므로 지역변수에서 계산하고 쓰기만 함
+		BoneTransform3x4 bone;
+		bone.Store(XMMatrixMultiply(m_bindposeInverses[boneIndex], m_globalTransforms[boneIndex]));
+		palette[boneIndex] = bone;
+
+		if (bounds != nullptr && m_jointBoundsIndices[boneIndex] >= 0)
+		{
+			Skinning::MergeSkinnedBounds(bone, (*jointBounds)[m_jointBoundsIndices[boneIndex]].Bounds, minPosition, maxPosition);
+		}
+	}
+
+	if (bounds != nullptr)
+	{
+		Skinning::CreateSkinnedBounds(jointBounds->empty(), minPosition, maxPosition, *bounds);
+	}
+}
+
+void AnimationPoseBatch::EndExecute()
+{
+	m_poseInstanceIndices.clear();
+	m_poseDroppedLeafLevels.clear();
+	m_poseCaptures.clear();
+}
+
+//기본 레이어 가중평균, 가중치가 없는 본은 바인드포즈
+void AnimationPoseBatch::ResolveBasePoses()
+{
+	const size_t boneCount = m_bindLocalPoses.size();
+	for (size_t i = 0; i < m_localPoses.size(); ++i)
+	{
+		LocalPose& localPose = m_localPoses[i];
+		if (localPose.Weight <= 0.0f)
+		{
+			localPose = m_bindLocalPoses[i % boneCount];
+			continue;
+		}
+
+		XMVECTOR inverseWeight = XMVectorReplicate(1.0f / localPose.Weight);
+		XMStoreFloat3(&localPose.Scale, XMVectorMultiply(XMLoadFloat3(&localPose.Scale), inverseWeight));
+		XMStoreFloat4(&localPose.Rotation, XMQuaternionNormalize(XMLoadFloat4(&localPose.Rotation)));
+		XMStoreFloat3(&localPose.Translation, XMVectorMultiply(XMLoadFloat3(&localPose.Translation), inverseWeight));
+		localPose.Weight = 1.0f;
+	}
+}
+
+void AnimationPoseBatch::SampleLanes(const AnimationClip& clip, const PoseBatchSample* samples, size_t laneCount)
+{
+	const size_t boneCount = clip.BoneAnimations.size();
+	const int layer = samples[0].Layer;
+	const AnimationBlendMode blendMode = samples[0].BlendMode;
+
+	//레인마다 키 양쪽 인덱스
+	size_t scaleLeftKeys[LaneCount], scaleRightKeys[LaneCount];
+	size_t rotationLeftKeys[LaneCount], rotationRightKeys[LaneCount];
+	size_t translationLeftKeys[LaneCount], translationRightKeys[LaneCount];
+	LaneValues scaleAlpha, rotationAlpha, translationAlpha;
+	float weights[LaneCount];
+
+	for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		const BoneAnimation& boneAnimation = clip.BoneAnimations[boneIndex];
+		const CompressedBoneTrack& track = boneAnimation.Track;
+		if (track.FrameCount == 0)
+		{
+			continue;
+		}
+
+		//마스크로 모두 빠진 본은 샘플링하지 않음
+		bool hasWeight = false;
+		for (size_t lane = 0; lane < laneCount; ++lane)
+		{
+			const std::vector<float>* boneMask = samples[lane].BoneMask;
+			float maskWeight = (boneMask != nullptr && boneIndex < boneMask->size()) ? (*boneMask)[boneIndex] : 1.0f;
+			if (m_boneHeights[boneIndex] < m_poseDroppedLeafLevels[samples[lane].PoseIndex])
+			{
+				maskWeight = 0.0f;
+			}
+			weights[lane] = samples[lane].Weight * maskWeight;
+			hasWeight |= weights[lane] > 0.0f;
+		}
+		if (hasWeight == false)
+		{
+			continue;
+		}
+
+		const float lastFrame = static_cast<float>(track.FrameCount - 1);
+		const float framePerSecond = boneAnimation.GetFramePerSecond();
+
+		for (size_t lane = 0; lane < LaneCount; ++lane)
+		{
+			//남는 레인은 첫 샘플로 채움
+			const PoseBatchSample& sample = samples[lane < laneCount ? lane : 0];
+			BoneTrackCursor& cursor = (*sample.Cursors)[boneIndex];
+			float frame = (std::max)(0.0f, (std::min)(sample.Time * framePerSecond, lastFrame));
+
+			//키 검색은 레인마다 커서가 달라서 하나씩
+			track.Scale.FindKeyIndices(frame, &cursor.Scale, scaleLeftKeys[lane], scaleRightKeys[lane], scaleAlpha[lane]);
+			track.Rotation.FindKeyIndices(frame, &cursor.Rotation, rotationLeftKeys[lane], rotationRightKeys[lane], rotationAlpha[lane]);
+			track.Translation.FindKeyIndices(frame, &cursor.Translation, translationLeftKeys[lane], translationRightKeys[lane], translationAlpha[lane]);
+		}
+
+		//복원부터 성분별로 레인을 모아서 계산
+		XMVECTOR scaleLeft[3], scaleRight[3], translationLeft[3], translationRight[3];
+		track.Scale.DecodeLanes(scaleLeftKeys, scaleLeft);
+		track.Scale.DecodeLanes(scaleRightKeys, scaleRight);
+		track.Translation.DecodeLanes(translationLeftKeys, translationLeft);
+		track.Translation.DecodeLanes(translationRightKeys, translationRight);
+
+		LaneValues scale[3], rotation[4], translation[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			StoreLanes(scale[axis], XMVectorLerpV(scaleLeft[axis], scaleRight[axis], LoadLanes(scaleAlpha)));
+			StoreLanes(translation[axis], XMVectorLerpV(translationLeft[axis], translationRight[axis], LoadLanes(translationAlpha)));
+		}
+
+		XMVECTOR q0[4], q1[4], q[4];
+		track.Rotation.DecodeLanes(rotationLeftKeys, q0);
+		track.Rotation.DecodeLanes(rotationRightKeys, q1);
+		SlerpLanes(q0, q1, LoadLanes(rotationAlpha), q);
+		for (int axis = 0; axis < 4; ++axis)
+		{
+			StoreLanes(rotation[axis], q[axis]);
+		}
+
+		//Additive 기준포즈는 클립 첫 프레임
+		XMVECTOR referenceScale = g_XMOne;
+		XMVECTOR referenceRotation = XMQuaternionIdentity();
+		XMVECTOR referenceTranslation = XMVectorZero();
+		if (blendMode == AnimationBlendMode::Additive)
+		{
+			track.Sample(0.0f, referenceScale, referenceRotation, referenceTranslation);
+		}
+
+		for (size_t lane = 0; lane < laneCount; ++lane)
+		{
+			float weight = weights[lane];
+			if (weight <= 0.0f)
+			{
+				continue;
+			}
+
+			XMVECTOR sampleScale = XMVectorSet(scale[0][lane], scale[1][lane], scale[2][lane], 0.0f);
+			XMVECTOR sampleRotation = XMVectorSet(rotation[0][lane], rotation[1][lane], rotation[2][lane], rotation[3][lane]);
+			XMVECTOR sampleTranslation = XMVectorSet(translation[0][lane], translation[1][lane], translation[2][lane], 0.0f);
+
+			LocalPose& localPose = m_localPoses[samples[lane].PoseIndex * boneCount + boneIndex];
+
+			//기본 레이어는 가중합, ResolveBasePoses에서 정규화
+			if (layer == 0)
+			{
+				XMVECTOR accumulatedRotation = XMLoadFloat4(&localPose.Rotation);
+				float rotationWeight = XMVectorGetX(XMVector4Dot(accumulatedRotation, sampleRotation)) < 0.0f ? -weight : weight;
+
+				XMVECTOR weightVector = XMVectorReplicate(weight);
+				XMStoreFloat3(&localPose.Scale, XMVectorMultiplyAdd(sampleScale, weightVector, XMLoadFloat3(&localPose.Scale)));
+				XMStoreFloat4(&localPose.Rotation, XMVectorMultiplyAdd(sampleRotation, XMVectorReplicate(rotationWeight), accumulatedRotation));
+				XMStoreFloat3(&localPose.Translation, XMVectorMultiplyAdd(sampleTranslation, weightVector, XMLoadFloat3(&localPose.Translation)));
+				localPose.Weight += weight;
+				continue;
+			}
+
+			XMVECTOR poseScale = XMLoadFloat3(&localPose.Scale);
+			XMVECTOR poseRotation = XMLoadFloat4(&localPose.Rotation);
+			XMVECTOR poseTranslation = XMLoadFloat3(&localPose.Translation);
+			if (blendMode == AnimationBlendMode::Additive)
+			{
+				BlendAdditive(poseScale, poseRotation, poseTranslation, sampleScale, sampleRotation, sampleTranslation,
+					referenceScale, referenceRotation, referenceTranslation, weight);
+			}
+			else
+			{
+				BlendOverride(poseScale, poseRotation, poseTranslation, sampleScale, sampleRotation, sampleTranslation, (std::min)(weight, 1.0f));
+			}
+			XMStoreFloat3(&localPose.Scale, poseScale);
+			XMStoreFloat4(&localPose.Rotation, poseRotation);
+			XMStoreFloat3(&localPose.Translation, poseTranslation);
+		}
+	}
+}
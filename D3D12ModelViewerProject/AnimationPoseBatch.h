@@ -0,0 +1,114 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <functional>
+#include "FbxUtil.h"
+#include "FrameResource.h"
+
+enum class AnimationBlendMode : int
+{
+	//아래 레이어 결과와 Weight만큼 보간
+	Override = 0,
+	//클립 첫 프레임과의 차이를 Weight만큼 더함
+	Additive
+};
+
+//클립 하나를 샘플링해서 포즈에 섞는 요청
+struct PoseBatchSample
+{
+	const AnimationClip* Clip = nullptr;
+	//0 : 기본 레이어 (Weight로 가중평균, 크로스페이드), 1부터 순서대로 위에 섞음
+	int Layer = 0;
+	AnimationBlendMode BlendMode = AnimationBlendMode::Override;
+	float Time = 0.0f;
+	float Weight = 1.0f;
+	//본별 가중치, nullptr이면 모든 본 1
+	const std::vector<float>* BoneMask = nullptr;
+	//재생상태마다 따로 가짐, 본 개수로 맞춰짐
+	std::vector<BoneTrackCursor>* Cursors = nullptr;
+	//AddPose 반환값
+	size_t PoseIndex = 0;
+};
+
+//한 스켈레톤을 쓰는 인스턴스들의 본 팔레트를 한번에 계산
+//같은 클립 샘플끼리 LaneCount개씩 키를 성분별로 모아 복원, lerp/slerp를 한번에 하고
+//레이어 순서대로 로컬포즈에 섞은 뒤 부모부터 누적한 3x4 팔레트를 인스턴스 버퍼에 바로 쓰거나 PaletteWriter로 넘김
+class AnimationPoseBatch
+{
+public:
+	//CompressedVectorTrack::DecodeLanes 키 개수
+	static constexpr size_t LaneCount = 4;
+	//계산한 팔레트를 인스턴스 버퍼에 쓰는 함수, palette : 본 개수 크기
+	using PaletteWriter = std::function<void(size_t instanceIndex, const InstanceAnimations* palette)>;
+	//인스턴스 버퍼에 바로 쓴 팔레트의 바운딩박스를 받는 함수
+	using BoundsWriter = std::function<void(size_t instanceIndex, const DirectX::BoundingBox& bounds)>;
+	//팔레트 캐시 시간 양자화 단위
+	static constexpr float PaletteCacheTimeStep = 1.0f / 120.0f;
+public:
+	void Begin(const Skeleton& skeleton);
+	//instanceIndex : InstanceAnimationBuffer에서 인스턴스 위치 (본 개수 단위)
+	//droppedLeafLevels : 말단에서부터 샘플링하지 않을 본 단계
+	//capture : nullptr이 아니면 writePalette를 부르지 않고 여기에 팔레트를 씀 (본 개수 크기)
+	size_t AddPose(size_t instanceIndex, int droppedLeafLevels = 0, std::vector<InstanceAnimations>* capture = nullptr);
+	//Weight가 0이면 샘플링하지 않음
+	void AddSample(const PoseBatchSample& sample);
+	//팔레트를 다른 곳에서 변환해서 쓸때, 팔레트마다 임시 버퍼에 계산해서 writePalette로 넘김
+	void Execute(const PaletteWriter& writePalette);
+	//선형 스키닝 팔레트를 paletteBase + instanceIndex * 본 개수에 바로 씀 (업로드 버퍼 매핑 주소, 읽지 않음)
+	//바운딩박스는 본마다 쓰면서 같이 계산, Skinning::ComputeSkinnedBounds와 같은 결과
+	void Execute(InstanceAnimations* paletteBase, const std::vector<JointBounds>& jointBounds, const BoundsWriter& writeBounds);
+
+	//이번 프레임에 같은 클립, 같은 양자화 시간으로 계산할 포즈가 있으면 그 인스턴스 위치를 돌려줌
+	//없으면 instanceIndex를 주인으로 등록하고 false, 호출한쪽에서 AddPose 해야함
+	bool FindSharedPalette(const AnimationClip* clip, float time, int droppedLeafLevels, size_t instanceIndex, size_t& ownerInstanceIndex);
+
+	//droppedLeafLevels로 제외하고 남는 본 개수
+	size_t GetActiveBoneCount(int droppedLeafLevels) const;
+private:
+	//본 하나의 로컬 TRS
+	struct LocalPose
+	{
+		DirectX::XMFLOAT3 Scale = { 0.0f,0.0f,0.0f };
+		DirectX::XMFLOAT4 Rotation = { 0.0f,0.0f,0.0f,0.0f };
+		DirectX::XMFLOAT3 Translation = { 0.0f,0.0f,0.0f };
+		float Weight = 0.0f;
+	};
+
+	//레이어, 블렌드모드, 클립 순서로 정렬되어 레이어 순서대로 처리됨
+	using SampleGroupKey = std::tuple<int, AnimationBlendMode, const AnimationClip*>;
+	//스켈레톤, 클립, 양자화한 시간, 제외한 본 단계
+	using PaletteCacheKey = std::tuple<const Skeleton*, const AnimationClip*, int, int>;
+private:
+	//샘플을 모두 로컬포즈에 섞음
+	void SamplePoses();
+	void SampleLanes(const AnimationClip& clip, const PoseBatchSample* samples, size_t laneCount);
+	void ResolveBasePoses();
+	//부모부터 누적한 3x4 팔레트를 palette에 씀, bounds가 nullptr이 아니면 바운딩박스도 계산
+	void WritePalette(size_t poseIndex, InstanceAnimations* palette, const std::vector<JointBounds>* jointBounds, DirectX::BoundingBox* bounds);
+	void EndExecute();
+private:
+	const Skeleton* m_skeleton = nullptr;
+	std::vector<DirectX::XMMATRIX> m_bindposeInverses;
+	//기본 레이어 가중치가 0인 본에 사용
+	std::vector<LocalPose> m_bindLocalPoses;
+
+	//본에서 가장 먼 말단까지의 단계, 말단 본은 0
+	std::vector<int> m_boneHeights;
+
+	std::vector<size_t> m_poseInstanceIndices;
+	std::vector<int> m_poseDroppedLeafLevels;
+	std::vector<std::vector<InstanceAnimations>*> m_poseCaptures;
+	//포즈마다 본 개수만큼 연속
+	std::vector<LocalPose> m_localPoses;
+	//벡터는 프레임마다 재사용
+	std::map<SampleGroupKey, std::vector<PoseBatchSample>> m_sampleGroups;
+	//프레임마다 비움, 값은 팔레트를 가진 인스턴스 위치
+	std::map<PaletteCacheKey, size_t> m_paletteCache;
+
+	std::vector<DirectX::XMMATRIX> m_globalTransforms;
+	//본마다 JointBounds 위치, 없으면 -1
+	std::vector<int> m_jointBoundsIndices;
+	//인스턴스 하나 분량
+	std::vector<InstanceAnimations> m_palette;
+};
@@ -63,7 +63,7 @@ D3DModelViewerApp::D3DModelViewerApp(HINSTANCE hInstance)
 	m_mainScene(make_shared<Scene>("mainScene")),
 	m_fbxModels(make_shared<map<std::string, std::shared_ptr<FbxModelScene>>>()),
 	m_meshResources(make_shared<std::map<std::string, std::shared_ptr<MeshResources>>>()),
-	m_animations(make_shared<std::map<std::string, AnimationClip>>()),
+	m_animations(make_shared<std::map<std::string, std::shared_ptr<const AnimationClip>>>()),
 	m_lights(make_shared<Lights>())
 {
 
@@ -145,6 +145,9 @@ void D3DModelViewerApp::Update(const GameTimer& gt)
 
 	m_importListControl.Update();
 	m_sceneHierachyControl.Update();
+
+	GetAnimationLodSystem().BeginFrame(m_camera);
+	GetInstanceCullingSystem().BeginFrame(m_camera);
 	m_mainScene->Update();
 
 	ReAllocateLightsBuffer(frameIndex);
@@ -307,7 +310,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 	UNREFERENCED_PARAMETER(hPrevInstance);
 	UNREFERENCED_PARAMETER(lpCmdLine);
 
-	//D3D12device  εǾ
+	//D3D12device 생성전에 로드되어야함
 	if (GetModuleHandle(L"WinPixGpuCapturer.dll") == 0)
 	{
 		LoadLibrary(GetLatestWinPixGpuCapturerPath_Cpp17().c_str());
@@ -382,6 +385,9 @@ void D3DModelViewerApp::ImGUIFrameStarted()
 	m_importListControl.Show();
 	m_sceneHierachyControl.Show();
 	m_lightsInfoControl.Show();
+	m_animationLodControl.Show();
+	m_instanceCullingControl.Show();
+	m_allocatorStatsControl.Show();
 }
 
 void D3DModelViewerApp::BuildGrid()
@@ -13,6 +13,9 @@
 #include "ImportListControl.h"
 #include "SceneHierachyControl.h"
 #include "LightsInfoControl.h"
+#include "AnimationLodControl.h"
+#include "InstanceCullingControl.h"
+#include "AllocatorStatsControl.h"
 
 class D3DModelViewerApp : public DirectX3DApp
 {
@@ -46,7 +49,7 @@ private:
 	std::wstring m_mainPassName = _TEXT("Main");
 
 	Camera m_camera;
-	//key -> pass Constant buffer( framesCountŭ ° Ҵ)
+	//key -> pass Constant buffer( framesCount만큼 통째로 할당)
 	std::unordered_map<std::wstring, std::unique_ptr<UploadBuffer<PassConstants>>> m_passCBMap;
 
 	std::vector<std::unique_ptr<UploadBuffer<Light>>> m_lightsBuffers;
@@ -64,9 +67,12 @@ private:
 	std::shared_ptr<Scene> m_mainScene;
 	std::shared_ptr<std::map<std::string, std::shared_ptr<FbxModelScene>>> m_fbxModels;
 	std::shared_ptr<std::map<std::string, std::shared_ptr<MeshResources>>> m_meshResources;
-	std::shared_ptr<std::map<std::string, AnimationClip>> m_animations;
+	std::shared_ptr<std::map<std::string, std::shared_ptr<const AnimationClip>>> m_animations;
 
 	ImportListControl m_importListControl;
 	SceneHierachyControl m_sceneHierachyControl;
 	LightsInfoControl m_lightsInfoControl;
+	AnimationLodControl m_animationLodControl;
+	InstanceCullingControl m_instanceCullingControl;
+	AllocatorStatsControl m_allocatorStatsControl;
 };
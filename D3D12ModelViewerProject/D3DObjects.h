@@ -67,13 +67,13 @@ public:
 	CommandQueueObject& operator=(CommandQueueObject&&) = default;
 	virtual ~CommandQueueObject() = default;
 
-	// store=true commandlist
+	// store=true면 commandlist보관
 	void ExecuteCommandList(GraphicsCommandListObject cmdListObj, bool bStore = false);
 	void ExecuteCommandList(std::vector<ID3D12CommandList*>& cmdListObjs);
 
 	void ReleaseStoreCommandListObj();
 
-	//fence LastFenceCountȯ 
+	//fence증가 LastFenceCount반환 
 	uint64_t Signal()
 	{
 		ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), ++m_lastFenceCount));
@@ -89,10 +89,10 @@ public:
 		return m_commandQueue.Get();
 	}
 
-	//LastFenceCountȯ fence
+	//LastFenceCount반환 fence증가
 	virtual uint64_t FlushCommandQueue();
 
-	//uint ÷ο쿡 
+	//uint 언더플로우에 주의
 	void WaitFence(uint64_t fenceCount);
 
 protected:
@@ -135,7 +135,7 @@ public:
 
 private:
 	size_t m_threadCount = 1;
-	//Ҵ籸 thread0(frame0,1,2...), thread1(frame0,1,2...) ....
+	//할당구조 thread0(frame0,1,2...), thread1(frame0,1,2...) ....
 	std::vector<GraphicsCommandListObject> m_threadCommandLists;
 	uint64_t m_currentFramesCount = 0;
 };
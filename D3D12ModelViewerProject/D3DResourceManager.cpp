@@ -46,6 +46,15 @@ void D3DResourceManager::BuildDescriptorHeaps(ID3D12Device* device)
 		100,
 	};
 
+	//스레드 캐시 청크 크기, 0이면 사용안함
+	uint32_t cpuThreadCacheChunkSizes[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] =
+	{
+		256,
+		0,
+		0,
+		0,
+	};
+
 	D3D12_DESCRIPTOR_HEAP_TYPE cpuDescriptorHeapTypes[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] =
 	{
 		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
@@ -56,7 +65,7 @@ void D3DResourceManager::BuildDescriptorHeaps(ID3D12Device* device)
 
 	for (int i = 0; i < _countof(cpuDescriptorHeapTypes); ++i)
 	{
-		m_cpuDescriptorHeapsMap.try_emplace(cpuDescriptorHeapTypes[i], device, numCpuDescriptors[i], cpuDescriptorHeapTypes[i], D3D12_DESCRIPTOR_HEAP_FLAG_NONE);
+		m_cpuDescriptorHeapsMap.try_emplace(cpuDescriptorHeapTypes[i], device, numCpuDescriptors[i], cpuDescriptorHeapTypes[i], D3D12_DESCRIPTOR_HEAP_FLAG_NONE, cpuThreadCacheChunkSizes[i]);
 	}
 
 	//build gpuDescriptorHeap
@@ -70,6 +79,11 @@ void D3DResourceManager::BuildDescriptorHeaps(ID3D12Device* device)
 		100000,
 		10
 	};
+	uint32_t gpuThreadCacheChunkSizes[] =
+	{
+		256,
+		0
+	};
 
 	D3D12_DESCRIPTOR_HEAP_TYPE gpuDescriptorHeapTypes[] =
 	{
@@ -85,15 +99,16 @@ void D3DResourceManager::BuildDescriptorHeaps(ID3D12Device* device)
 			numGpuStaticDescriptors[i],
 			numGpuDynamicDescriptors[i],
 			gpuDescriptorHeapTypes[i],
-			D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
+			D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+			gpuThreadCacheChunkSizes[i]);
 	}
 
 }
 
 /// <summary>
 /// </summary>
-/// <param name="textureName">α׷  ̸</param>
-/// <returns>ϸ nullptr ȯ</returns>
+/// <param name="textureName">프로그램내에서 고유한 이름</param>
+/// <returns>실패하면 nullptr 반환</returns>
 ID3D12Resource* D3DResourceManager::GetTextureResource(std::wstring textureName)
 {
 	ID3D12Resource* result = nullptr;
@@ -109,8 +124,8 @@ ID3D12Resource* D3DResourceManager::GetTextureResource(std::wstring textureName)
 /// <summary>
 /// 
 /// </summary>
-/// <param name="textureName">α׷  ̸</param>
-/// <param name="textureFilePath">ؽó </param>
+/// <param name="textureName">프로그램내에서 고유한 이름</param>
+/// <param name="textureFilePath">텍스처파일 절대경로</param>
 void D3DResourceManager::CreateTextureResource(std::wstring TextureName, std::wstring textureFilePath)
 {
 	if (m_device == nullptr)
@@ -307,7 +322,7 @@ void D3DResourceManager::Update()
 {
 	uint64_t currentFrameCount = m_renderQueue->GoNextFrame();
 
-	//uint ÷ο쿡 
+	//uint 언더플로우에 주의
 	uint64_t fenceCount = (currentFrameCount < FramesCount) ? 0 : currentFrameCount - FramesCount;
 	m_renderQueue->WaitFence(fenceCount);
 	m_renderQueue->ReleaseStoreCommandListObj();
@@ -316,6 +331,7 @@ void D3DResourceManager::Update()
 	m_renderLists.at(GetCurrentFrameIndex()).clear();
 
 	UpdateStaleAllocations();
+	UpdateAllocatorStats();
 }
 
 bool D3DResourceManager::InitDirect3D()
@@ -370,6 +386,53 @@ void D3DResourceManager::UpdateStaleAllocations()
 	}
 }
 
+void D3DResourceManager::UpdateAllocatorStats()
+{
+	auto getHeapTypeName = [](D3D12_DESCRIPTOR_HEAP_TYPE heapType) -> std::string
+	{
+		switch (heapType)
+		{
+		case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV: return "CBV_SRV_UAV";
+		case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER: return "SAMPLER";
+		case D3D12_DESCRIPTOR_HEAP_TYPE_RTV: return "RTV";
+		case D3D12_DESCRIPTOR_HEAP_TYPE_DSV: return "DSV";
+		default: return "UNKNOWN";
+		}
+	};
+
+	std::vector<DescriptorHeapStats> allocatorStats;
+	for (auto& element : m_cpuDescriptorHeapsMap)
+	{
+		allocatorStats.push_back(element.second.GetStats());
+		allocatorStats.back().Name = "CPU " + getHeapTypeName(element.first);
+	}
+
+	for (auto& element : m_gpuDescriptorHeapsMap)
+	{
+		DescriptorHeapStats staticStats;
+		staticStats.Name = "GPU " + getHeapTypeName(element.first) + " Static";
+		staticStats.Blocks = element.second.GetStaticStats();
+		allocatorStats.push_back(staticStats);
+
+		DescriptorHeapStats dynamicStats;
+		dynamicStats.Name = "GPU " + getHeapTypeName(element.first) + " Dynamic";
+		dynamicStats.Blocks = element.second.GetDynamicStats();
+		allocatorStats.push_back(dynamicStats);
+	}
+
+	//힙 구성은 바뀌지 않으므로 같은 인덱스끼리 누적 횟수 차이를 구함
+	if (allocatorStats.size() == m_allocatorStats.size())
+	{
+		for (size_t i = 0; i < allocatorStats.size(); ++i)
+		{
+			allocatorStats[i].AllocationsPerFrame = allocatorStats[i].Blocks.AllocateCount - m_allocatorStats[i].Blocks.AllocateCount;
+			allocatorStats[i].FreesPerFrame = allocatorStats[i].Blocks.FreeCount - m_allocatorStats[i].Blocks.FreeCount;
+		}
+	}
+
+	m_allocatorStats = std::move(allocatorStats);
+}
+
 void D3DResourceManager::DrawRenderLists(D3D12_CPU_DESCRIPTOR_HANDLE backbufferView, D3D12_CPU_DESCRIPTOR_HANDLE depthStencilView, RenderType renderType, D3D12_GPU_DESCRIPTOR_HANDLE passDescriptorHandle)
 {
 	auto descriptorHeapIter = m_gpuDescriptorHeapsMap.find(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -511,10 +574,11 @@ void D3DResourceManager::BuildShaders()
 		passRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
 		passRange[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 3);
 
-		CD3DX12_DESCRIPTOR_RANGE objRange[3];
+		CD3DX12_DESCRIPTOR_RANGE objRange[4];
 		objRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);//objConstant
 		objRange[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 1);//instanceData 
-		objRange[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 2);//instanceAnimation
+		objRange[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 2, 0, 2);//instanceAnimation, instanceDualQuaternion
+		objRange[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 2, 0, 4);//bakedPalettes, bakedClips
 
 		CD3DX12_DESCRIPTOR_RANGE matRange[2];
 		matRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 2);
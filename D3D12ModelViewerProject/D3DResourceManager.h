@@ -38,35 +38,35 @@ public:
 
 	ID3D12Device* GetDevice() { return m_device.Get(); }
 
-	//н nullptrȯ
+	//실패시 nullptr반환
 	ID3D12Resource* GetTextureResource(std::wstring textureName = _TEXT("defaultDiffuseTexture"));
 
-	// θ  ؽó  textureName ؽʿ  , Ű  ۷īƮ+1
+	// 절대경로를 통해 텍스처 생성후 textureName으로 해쉬맵에 저장 ,같은 키로 생성시 레퍼런스카운트+1
 	void CreateTextureResource(std::wstring TextureName, std::wstring textureFilePath);
 	void CreateDefaultTextures();
 
-	//ҽ ۷īƮ-1 /0  ҽı
+	//리소스 레퍼런스카운트-1 /0으로 내려가면 리소스파괴
 	void DeleteTextureResource(std::wstring textureName);
 
-	//  ӹȯ
+	//현재 렌더 프레임반환
 	uint32_t GetCurrentFrameIndex() { return m_renderQueue->GetCurrentFramesCount() % FramesCount; }
 	UINT64 GetCurrentFrameCount() { return m_renderQueue->GetCurrentFramesCount(); }
 
-	//DescriptorHeapҴ
+	//DescriptorHeap할당
 	DescriptorHeapAllocation CpuDescriptorHeapAlloc(D3D12_DESCRIPTOR_HEAP_TYPE heapType, size_t count);
 	DescriptorHeapAllocation GpuDynamicDescriptorHeapAlloc(D3D12_DESCRIPTOR_HEAP_TYPE heapType, size_t count);
 
-	//DescriptorHeap View
+	//DescriptorHeap에 View생성
 	void CreateCBV(D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle, D3D12_CONSTANT_BUFFER_VIEW_DESC& viewDesc);
 	void CreateSRV(ID3D12Resource* pResource, D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle, D3D12_SHADER_RESOURCE_VIEW_DESC& viewDesc);
 	void CreateRTV(ID3D12Resource* pResource, D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle, D3D12_RENDER_TARGET_VIEW_DESC* viewDesc);
 
-	//ʴ ڿ 
+	//사용되지않는 자원 해제
 	void Update();
 
 	void Render(const DescriptorHeapAllocation& passDescriptorHeapAllocation);
 
-	//Render ׸ ߰ ߰  GPUó  
+	//Render 항목 추가 추가된 아이템은 GPU처리가 끝날때까지 보관
 	void PushRenderItem(std::shared_ptr<SceneObject> addItem);
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(const void* initData, UINT64 byteSize, Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
@@ -76,7 +76,10 @@ public:
 
 	void CopyDescriptorHeapAllocation(DescriptorHeapAllocation& source, DescriptorHeapAllocation& dest);
 
-	//MainWindow ѹ ȣ
+	//Update마다 갱신되는 DescriptorHeap 통계
+	const std::vector<DescriptorHeapStats>& GetAllocatorStats() const { return m_allocatorStats; }
+
+	//MainWindow에서 한번만 호출
 	void CreateSwapChain(DXGI_SWAP_CHAIN_DESC& swapDesc);
 	void ResizeSwapChain(int width, int height);
 	void InitializeImGUID3D12();
@@ -93,22 +96,23 @@ private:
 private:
 	void BuildDescriptorHeaps(ID3D12Device* device);
 
-	//н nullptr
+	//실패시 nullptr
 	TextureResourcePair* GetTextureResourcePair(std::wstring textureName);
 
 	bool InitDirect3D();
 
-	//Log Լ
+	//Log 함수들
 	void LogAdapters();
 	void LogAdapterOutputs(IDXGIAdapter* adapter);
 	void LogOutputDisplayModes(IDXGIOutput* output, DXGI_FORMAT format);
 
-	//ʴ Ҵ
+	//사용되지않는 할당해제
 	void UpdateStaleAllocations();
+	void UpdateAllocatorStats();
 
 	void DrawRenderLists(D3D12_CPU_DESCRIPTOR_HANDLE backbufferView, D3D12_CPU_DESCRIPTOR_HANDLE depthStencilView, RenderType renderType, D3D12_GPU_DESCRIPTOR_HANDLE passDescriptorHandle);
 
-	//D3Dڿ 
+	//D3D자원 생성
 	void BuildPipelineState();
 	void BuildShaders();
 	void BuildBlendState();
@@ -116,23 +120,26 @@ private:
 
 private:
 
-	//key -> ( ۷īƮ ,ؽó GPU ҽ)  
+	//key -> ( 레퍼런스카운트 ,텍스처 GPU 리소스) 페어 
 	std::unordered_map<std::wstring, TextureResourcePair> m_textureResourceMap;
 
 	//cbv_srv_Uav , sampler,rtv ,dsv
 	std::map<D3D12_DESCRIPTOR_HEAP_TYPE, CPUDescriptorHeap> m_cpuDescriptorHeapsMap;
 
 	//cbv_srv_uav, sampler
-	//Mesh (objCB*1 + MaterialCount*(materialCB + diffuse texture SRV + normal texture srv + ...)
+	//Mesh 당(objCB*1 + MaterialCount*(materialCB + diffuse texture SRV + normal texture srv + ...)
 	std::map<D3D12_DESCRIPTOR_HEAP_TYPE, GPUDescriptorHeap> m_gpuDescriptorHeapsMap;
 
-	//Render  (FramesCountŭ)
+	//CPU힙들, GPU힙들의 static, dynamic 순서
+	std::vector<DescriptorHeapStats> m_allocatorStats;
+
+	//Render할 아이템 보관함(FramesCount만큼)
 	std::array<std::vector<std::shared_ptr<SceneObject>>, FramesCount> m_renderLists;
 
-	//m_gpuDescriptorHeap staticκ 
+	//m_gpuDescriptorHeap의 static부분 
 	std::map<std::wstring, DescriptorHeapAllocation> m_staticItems;
 
-	//D3D12 ҽ
+	//D3D12관련 리소스들
 	Microsoft::WRL::ComPtr<ID3D12Device> m_device;
 	Microsoft::WRL::ComPtr<IDXGIFactory4> m_dxgiFactory;
 
@@ -0,0 +1,98 @@
+#include "DescriptorChunkCache.h"
+#include <atomic>
+#include <utility>
+
+DescriptorChunkCache::DescriptorChunkCache(IDescriptorChunkSource* source, uint32_t chunkSize)
+	: m_source(source), m_chunkSize(chunkSize)
+{
+}
+
+DescriptorRange DescriptorChunkCache::Allocate(uint32_t count)
+{
+	if (count == 0 || count > m_chunkSize)
+	{
+		return DescriptorRange();
+	}
+
+	//남은 부분이 모자라면 현재 청크를 돌려주고 새로 받음
+	if (m_chunk.IsNull() || m_usedCount + count > m_chunk.Count)
+	{
+		Flush();
+		m_chunk = m_source->AllocateChunk(m_chunkSize);
+		if (m_chunk.IsNull())
+		{
+			return DescriptorRange();
+		}
+	}
+
+	DescriptorRange range;
+	range.Owner = m_chunk.Owner;
+	range.Offset = m_chunk.Offset + m_usedCount;
+	range.Count = count;
+
+	m_usedCount += count;
+	m_usedSizes.push_back(count);
+	return range;
+}
+
+void DescriptorChunkCache::Flush()
+{
+	if (m_chunk.IsNull())
+	{
+		return;
+	}
+
+	m_source->ReturnChunk(m_chunk, m_usedSizes);
+
+	m_chunk = DescriptorRange();
+	m_usedCount = 0;
+	m_usedSizes.clear();
+}
+
+ThreadDescriptorCaches::ThreadDescriptorCaches(IDescriptorChunkSource* source, uint32_t chunkSize)
+	: m_source(source), m_chunkSize(chunkSize),
+	m_id([]()
+		{
+			static std::atomic<uint64_t> nextId = 1;
+			return nextId++;
+		}())
+{
+}
+
+DescriptorRange ThreadDescriptorCaches::Allocate(uint32_t count)
+{
+	if (IsEnabled() == false || count > m_chunkSize)
+	{
+		return DescriptorRange();
+	}
+
+	return GetThreadCache()->Allocate(count);
+}
+
+void ThreadDescriptorCaches::Flush()
+{
+	std::lock_guard<std::mutex> lockGuard(m_cachesMutex);
+	for (auto& cache : m_caches)
+	{
+		cache->Flush();
+	}
+}
+
+DescriptorChunkCache* ThreadDescriptorCaches::GetThreadCache()
+{
+	//(m_id, 캐시) 목록, 힙 종류 수만큼이라 선형 탐색
+	thread_local std::vector<std::pair<uint64_t, DescriptorChunkCache*>> threadCaches;
+
+	for (auto& element : threadCaches)
+	{
+		if (element.first == m_id)
+		{
+			return element.second;
+		}
+	}
+
+	std::lock_guard<std::mutex> lockGuard(m_cachesMutex);
+	m_caches.push_back(std::make_unique<DescriptorChunkCache>(m_source, m_chunkSize));
+	threadCaches.emplace_back(m_id, m_caches.back().get());
+	return m_caches.back().get();
+}
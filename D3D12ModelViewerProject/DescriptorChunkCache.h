@@ -0,0 +1,87 @@
+#pragma once
+
+#include "VariableAllocationManager.h"
+#include <mutex>
+#include <memory>
+#include <vector>
+
+//힙 안의 연속된 디스크립터 구간
+struct DescriptorRange
+{
+	//청크를 내준 쪽이 채우는 값, 캐시는 그대로 복사만 함
+	void* Owner = nullptr;
+	OffsetType Offset = VariableSizeAllocationsManager::InvalidOffset;
+	uint32_t Count = 0;
+
+	bool IsNull() const { return Offset == VariableSizeAllocationsManager::InvalidOffset; }
+};
+
+//캐시가 청크를 받아오고 돌려주는 곳
+//디바이스 없이 VariableSizeAllocationsManager만으로 구현해서 테스트할수 있음
+class IDescriptorChunkSource
+{
+public:
+	virtual ~IDescriptorChunkSource() = default;
+
+	//실패시 IsNull
+	virtual DescriptorRange AllocateChunk(uint32_t count) = 0;
+	//청크 앞에서부터 usedSizes 크기의 할당들로 나누고 남은 뒷부분은 해제
+	virtual void ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes) = 0;
+};
+
+//한 스레드 전용 캐시, 청크 하나를 앞에서부터 잘라서 락 없이 할당
+class DescriptorChunkCache
+{
+public:
+	DescriptorChunkCache(IDescriptorChunkSource* source, uint32_t chunkSize);
+
+	DescriptorChunkCache(const DescriptorChunkCache&) = delete;
+	DescriptorChunkCache& operator=(const DescriptorChunkCache&) = delete;
+
+	//count가 청크보다 크거나 청크를 못받으면 IsNull, 호출측에서 공유 매니저로 할당
+	DescriptorRange Allocate(uint32_t count);
+	//현재 청크 반환
+	void Flush();
+
+	uint32_t GetChunkSize() const { return m_chunkSize; }
+	//현재 청크에서 남은 개수
+	uint32_t GetRemainCount() const { return m_chunk.IsNull() ? 0 : m_chunk.Count - m_usedCount; }
+
+private:
+	IDescriptorChunkSource* m_source = nullptr;
+	const uint32_t m_chunkSize = 0;
+
+	DescriptorRange m_chunk;
+	uint32_t m_usedCount = 0;
+	std::vector<uint32_t> m_usedSizes;
+};
+
+//스레드마다 DescriptorChunkCache 하나씩, 스레드가 처음 쓸때만 락
+//Flush는 프레임 끝에 작업 스레드들이 할당하지 않을때 호출
+class ThreadDescriptorCaches
+{
+public:
+	//chunkSize가 0이면 캐시를 쓰지 않음
+	ThreadDescriptorCaches(IDescriptorChunkSource* source, uint32_t chunkSize);
+
+	ThreadDescriptorCaches(const ThreadDescriptorCaches&) = delete;
+	ThreadDescriptorCaches& operator=(const ThreadDescriptorCaches&) = delete;
+
+	bool IsEnabled() const { return m_chunkSize > 0; }
+	//캐시를 안쓰거나 count가 청크보다 크면 IsNull
+	DescriptorRange Allocate(uint32_t count);
+	//모든 스레드의 남은 청크를 한번에 반환
+	void Flush();
+
+private:
+	DescriptorChunkCache* GetThreadCache();
+
+private:
+	IDescriptorChunkSource* m_source = nullptr;
+	const uint32_t m_chunkSize = 0;
+	//스레드쪽 조회용, 파괴된 객체와 주소가 겹쳐도 구분됨
+	const uint64_t m_id = 0;
+
+	std::mutex m_cachesMutex;
+	std::vector<std::unique_ptr<DescriptorChunkCache>> m_caches;
+};
@@ -7,6 +7,7 @@
 #include "D3DUtil.h"
 #include "D3DResourceManager.h"
 #include <algorithm>
+#include <numeric>
 
 
 
@@ -16,14 +17,29 @@ DescriptorHeapAllocationManager::~DescriptorHeapAllocationManager()
 
 DescriptorHeapAllocation DescriptorHeapAllocationManager::Allocate(uint32_t count)
 {
-	std::lock_guard<std::mutex> lockGuard(m_allocationMutex);
-
-	OffsetType descriptorHandleOffset = m_freeBlockManager.Allocate(count);
+	OffsetType descriptorHandleOffset = AllocateRange(count);
 	if (descriptorHandleOffset == VariableSizeGPUAllocationsManager::InvalidOffset)
 	{
 		return DescriptorHeapAllocation();
 	}
 
+	return CreateAllocation(descriptorHandleOffset, count);
+}
+
+OffsetType DescriptorHeapAllocationManager::AllocateRange(uint32_t count)
+{
+	std::lock_guard<std::mutex> lockGuard(m_allocationMutex);
+	return m_freeBlockManager.Allocate(count);
+}
+
+void DescriptorHeapAllocationManager::SplitRange(OffsetType offset, uint32_t count, const std::vector<uint32_t>& sizes)
+{
+	std::lock_guard<std::mutex> lockGuard(m_allocationMutex);
+	m_freeBlockManager.SplitAllocation(offset, count, sizes);
+}
+
+DescriptorHeapAllocation DescriptorHeapAllocationManager::CreateAllocation(OffsetType descriptorHandleOffset, uint32_t count)
+{
 	auto CPUHandle = m_firstCPUHandle;
 	CPUHandle.ptr += descriptorHandleOffset * m_descriptorSize;
 
@@ -42,6 +58,12 @@ void DescriptorHeapAllocationManager::ReleaseStaleAllocations(uint64_t NumComple
 	m_freeBlockManager.ReleaseCompletedFrames(NumCompletedFrames);
 }
 
+VariableSizeAllocationStats DescriptorHeapAllocationManager::GetStats()
+{
+	std::lock_guard<std::mutex> lockGuard(m_allocationMutex);
+	return m_freeBlockManager.GetStats();
+}
+
 void DescriptorHeapAllocationManager::Free(DescriptorHeapAllocation&& allocation)
 {
 	std::lock_guard<std::mutex> lockGuard(m_allocationMutex);
@@ -91,7 +113,7 @@ DescriptorHeapAllocation::DescriptorHeapAllocation(IDescriptorAllocator* pAlloca
 	m_descriptorSize = device->GetDescriptorHandleIncrementSize(m_pDescriptorHeap->GetDesc().Type);
 }
 
-CPUDescriptorHeap::CPUDescriptorHeap(ID3D12Device* device, uint32_t numDescriptorsInHeap, D3D12_DESCRIPTOR_HEAP_TYPE type, D3D12_DESCRIPTOR_HEAP_FLAGS flags)
+CPUDescriptorHeap::CPUDescriptorHeap(ID3D12Device* device, uint32_t numDescriptorsInHeap, D3D12_DESCRIPTOR_HEAP_TYPE type, D3D12_DESCRIPTOR_HEAP_FLAGS flags, uint32_t threadCacheChunkSize)
 	:m_device(device),
 	m_descriptorSize(device->GetDescriptorHandleIncrementSize(type)),
 	m_heapDesc
@@ -100,7 +122,8 @@ CPUDescriptorHeap::CPUDescriptorHeap(ID3D12Device* device, uint32_t numDescripto
 	numDescriptorsInHeap,
 	flags,
 	0
-}
+},
+m_threadCaches(this, threadCacheChunkSize)
 {
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap;
 	ThrowIfFailed(device->CreateDescriptorHeap(&m_heapDesc, IID_PPV_ARGS(descriptorHeap.ReleaseAndGetAddressOf())));
@@ -116,38 +139,90 @@ CPUDescriptorHeap::~CPUDescriptorHeap()
 
 DescriptorHeapAllocation CPUDescriptorHeap::Allocate(uint32_t count)
 {
+	//스레드 캐시에서 락 없이 할당, 안되면 풀에서
+	DescriptorRange range = m_threadCaches.Allocate(count);
+	if (range.IsNull() == false)
+	{
+		return static_cast<DescriptorHeapAllocationManager*>(range.Owner)->CreateAllocation(range.Offset, range.Count);
+	}
+
 	std::lock_guard<std::recursive_mutex> lockGuard(m_heapPoolMutex);
-	DescriptorHeapAllocation allocation;
+	OffsetType offset;
+	DescriptorHeapAllocationManager* heapManager = AllocateRange(count, offset);
+	if (heapManager == nullptr)
+	{
+		return DescriptorHeapAllocation();
+	}
+
+	m_currentSize += count;
+	m_maxHeapSize = std::max(m_maxHeapSize, m_currentSize);
 
-	//аִ  ˻ Ҵ
-	for (auto& availableHeap : m_availableHeaps)
+	return heapManager->CreateAllocation(offset, count);
+}
+
+DescriptorHeapAllocationManager* CPUDescriptorHeap::AllocateRange(uint32_t count, OffsetType& offset)
+{
+	//여분공간이있는 힙 검색후 할당
+	for (auto iter = m_availableHeaps.begin(); iter != m_availableHeaps.end();)
 	{
-		allocation = m_heapPool.at(availableHeap)->Allocate(count);
-		if (m_heapPool.at(availableHeap)->GetNumAvailableDescriptors() == 0)
+		DescriptorHeapAllocationManager* heapManager = m_heapPool.at(*iter).get();
+		offset = heapManager->AllocateRange(count);
+		if (heapManager->GetNumAvailableDescriptors() == 0)
+		{
+			iter = m_availableHeaps.erase(iter);
+		}
+		else
 		{
-			m_availableHeaps.erase(availableHeap);
+			++iter;
 		}
 
-		if (allocation.IsNull() == false)
+		if (offset != VariableSizeAllocationsManager::InvalidOffset)
 		{
-			break;
+			return heapManager;
 		}
 	}
 
-	if (allocation.IsNull() == true)
-	{
-		m_heapDesc.NumDescriptors = std::max(m_heapDesc.NumDescriptors, static_cast<UINT>(count));
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap;
-		ThrowIfFailed(m_device->CreateDescriptorHeap(&m_heapDesc, IID_PPV_ARGS(descriptorHeap.ReleaseAndGetAddressOf())));
-		m_heapPool.emplace_back(std::make_unique<DescriptorHeapAllocationManager>(this, m_heapPool.size(), descriptorHeap.Get(), 0, m_heapDesc.NumDescriptors));
+	m_heapDesc.NumDescriptors = std::max(m_heapDesc.NumDescriptors, static_cast<UINT>(count));
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+	ThrowIfFailed(m_device->CreateDescriptorHeap(&m_heapDesc, IID_PPV_ARGS(descriptorHeap.ReleaseAndGetAddressOf())));
+	m_heapPool.emplace_back(std::make_unique<DescriptorHeapAllocationManager>(this, m_heapPool.size(), descriptorHeap.Get(), 0, m_heapDesc.NumDescriptors));
+	m_availableHeaps.insert(m_heapPool.size() - 1);
 
-		auto newHeapIter = m_availableHeaps.insert(m_heapPool.size() - 1);
-		allocation = m_heapPool.at(*(newHeapIter.first))->Allocate(count);
+	DescriptorHeapAllocationManager* heapManager = m_heapPool.back().get();
+	offset = heapManager->AllocateRange(count);
+	return (offset != VariableSizeAllocationsManager::InvalidOffset) ? heapManager : nullptr;
+}
+
+DescriptorRange CPUDescriptorHeap::AllocateChunk(uint32_t count)
+{
+	std::lock_guard<std::recursive_mutex> lockGuard(m_heapPoolMutex);
+	DescriptorRange chunk;
+	chunk.Owner = AllocateRange(count, chunk.Offset);
+	if (chunk.Owner == nullptr)
+	{
+		return DescriptorRange();
 	}
-	m_currentSize += (allocation.GetCpuHandle().ptr != 0) ? count : 0;
+	chunk.Count = count;
+
+	//청크 전체를 사용중으로 세고 ReturnChunk때 남은 부분을 뺌
+	m_currentSize += count;
 	m_maxHeapSize = std::max(m_maxHeapSize, m_currentSize);
+	return chunk;
+}
+
+void CPUDescriptorHeap::ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes)
+{
+	std::lock_guard<std::recursive_mutex> lockGuard(m_heapPoolMutex);
+	auto heapManager = static_cast<DescriptorHeapAllocationManager*>(chunk.Owner);
+	heapManager->SplitRange(chunk.Offset, chunk.Count, usedSizes);
+
+	uint32_t usedCount = std::accumulate(usedSizes.begin(), usedSizes.end(), 0u);
+	m_currentSize -= chunk.Count - usedCount;
 
-	return allocation;
+	if (heapManager->GetNumAvailableDescriptors() > 0)
+	{
+		m_availableHeaps.insert(heapManager->GetManagerId());
+	}
 }
 
 void CPUDescriptorHeap::Free(DescriptorHeapAllocation&& allocation)
@@ -160,6 +235,9 @@ void CPUDescriptorHeap::Free(DescriptorHeapAllocation&& allocation)
 
 void CPUDescriptorHeap::ReleaseStaleAllocations(uint64_t numCompletedFrames)
 {
+	//캐시에서 잘라준 할당들을 먼저 독립된 블록으로 만들어야 해제할수 있음
+	m_threadCaches.Flush();
+
 	std::lock_guard<std::recursive_mutex> lockGuard(m_heapPoolMutex);
 	for (size_t heapManagerId = 0; heapManagerId < m_heapPool.size(); ++heapManagerId)
 	{
@@ -172,7 +250,35 @@ void CPUDescriptorHeap::ReleaseStaleAllocations(uint64_t numCompletedFrames)
 	}
 }
 
-GPUDescriptorHeap::GPUDescriptorHeap(ID3D12Device* device, uint32_t numDescriptorsInHeap, uint32_t numDynamicDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE type, D3D12_DESCRIPTOR_HEAP_FLAGS flags)
+DescriptorHeapStats CPUDescriptorHeap::GetStats()
+{
+	std::lock_guard<std::recursive_mutex> lockGuard(m_heapPoolMutex);
+	DescriptorHeapStats stats;
+	stats.HeapCount = m_heapPool.size();
+
+	VariableSizeAllocationStats& total = stats.Blocks;
+	for (auto& heapManager : m_heapPool)
+	{
+		VariableSizeAllocationStats heapStats = heapManager->GetStats();
+		total.TotalSize += heapStats.TotalSize;
+		total.FreeSize += heapStats.FreeSize;
+		total.LargestFreeBlock = std::max(total.LargestFreeBlock, heapStats.LargestFreeBlock);
+		total.FreeBlockCount += heapStats.FreeBlockCount;
+		total.AllocationCount += heapStats.AllocationCount;
+		total.AlignmentPaddingCount += heapStats.AlignmentPaddingCount;
+		total.AlignmentPaddingSize += heapStats.AlignmentPaddingSize;
+		total.AllocateCount += heapStats.AllocateCount;
+		total.FreeCount += heapStats.FreeCount;
+		total.FailedAllocateCount += heapStats.FailedAllocateCount;
+		total.StaleAllocationCount += heapStats.StaleAllocationCount;
+		total.StaleSize += heapStats.StaleSize;
+	}
+	//힙마다 최고치를 찍은 시점이 달라서 합치지 않음
+	total.PeakUsedSize = m_maxHeapSize;
+	return stats;
+}
+
+GPUDescriptorHeap::GPUDescriptorHeap(ID3D12Device* device, uint32_t numDescriptorsInHeap, uint32_t numDynamicDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE type, D3D12_DESCRIPTOR_HEAP_FLAGS flags, uint32_t threadCacheChunkSize)
 	:m_device(device),
 	m_heapDesc
 {
@@ -192,9 +298,10 @@ m_descriptorHeap
 },
 m_descriptorSize(device->GetDescriptorHandleIncrementSize(type)),
 m_heapAllocationManager(this, 0, m_descriptorHeap.Get(), 0, numDescriptorsInHeap),
-m_dynamicAllocationsManager(this, 1, m_descriptorHeap.Get(), numDescriptorsInHeap, numDynamicDescriptors)
+m_dynamicAllocationsManager(this, 1, m_descriptorHeap.Get(), numDescriptorsInHeap, numDynamicDescriptors),
+m_threadCaches(this, threadCacheChunkSize)
 {
-	//
+	//본문
 }
 
 GPUDescriptorHeap::~GPUDescriptorHeap()
@@ -216,8 +323,38 @@ void GPUDescriptorHeap::Free(DescriptorHeapAllocation&& allocation)
 }
 
 
+DescriptorHeapAllocation GPUDescriptorHeap::AllocateDynamic(uint32_t Count)
+{
+	DescriptorRange range = m_threadCaches.Allocate(Count);
+	if (range.IsNull() == false)
+	{
+		return m_dynamicAllocationsManager.CreateAllocation(range.Offset, range.Count);
+	}
+
+	return m_dynamicAllocationsManager.Allocate(Count);
+}
+
+DescriptorRange GPUDescriptorHeap::AllocateChunk(uint32_t count)
+{
+	DescriptorRange chunk;
+	chunk.Offset = m_dynamicAllocationsManager.AllocateRange(count);
+	if (chunk.IsNull())
+	{
+		return DescriptorRange();
+	}
+	chunk.Owner = &m_dynamicAllocationsManager;
+	chunk.Count = count;
+	return chunk;
+}
+
+void GPUDescriptorHeap::ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes)
+{
+	m_dynamicAllocationsManager.SplitRange(chunk.Offset, chunk.Count, usedSizes);
+}
+
 void GPUDescriptorHeap::ReleaseStaleAllocations(uint64_t numCompletedFrames)
 {
+	m_threadCaches.Flush();
 	m_heapAllocationManager.ReleaseStaleAllocations(numCompletedFrames);
 	m_dynamicAllocationsManager.ReleaseStaleAllocations(numCompletedFrames);
 }
\ No newline at end of file
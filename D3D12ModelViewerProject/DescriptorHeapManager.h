@@ -1,14 +1,27 @@
 #pragma once
 
 #include "VariableAllocationManager.h"
+#include "DescriptorChunkCache.h"
 #include <d3d12.h>
 #include <wrl.h>
 #include <mutex>
 #include <unordered_set>
+#include <string>
 
 class DescriptorHeapAllocation;
 class IDescriptorAllocator;
 
+//힙 하나(또는 CPU 힙 풀 전체)의 통계 스냅샷
+struct DescriptorHeapStats
+{
+	std::string Name;
+	VariableSizeAllocationStats Blocks;
+	size_t HeapCount = 1;
+	//직전 스냅샷 이후 할당/해제 횟수
+	uint64_t AllocationsPerFrame = 0;
+	uint64_t FreesPerFrame = 0;
+};
+
 class IDescriptorAllocator
 {
 public:
@@ -17,7 +30,7 @@ public:
 	virtual uint32_t GetDescriptorSize() const = 0;
 };
 
-//DescriptorHeap  Ҵ
+//DescriptorHeap 내의 가상할당
 class DescriptorHeapAllocation
 {
 public:
@@ -111,7 +124,7 @@ private:
 	size_t m_allocationManagerId = static_cast<size_t>(-1);
 };
 
-//DescriptorHeapAllocation Ҵϴ ŴŬ
+//DescriptorHeapAllocation를 할당하는 매니저클래스
 class DescriptorHeapAllocationManager
 {
 public:
@@ -135,8 +148,16 @@ public:
 	void ReleaseStaleAllocations(uint64_t NumCompletedFrames);
 	void Free(DescriptorHeapAllocation&& allocation);
 
+	//스레드 캐시용, 실패시 InvalidOffset
+	OffsetType AllocateRange(uint32_t count);
+	void SplitRange(OffsetType offset, uint32_t count, const std::vector<uint32_t>& sizes);
+	//AllocateRange로 받은 구간에서 할당 생성, 락 없음
+	DescriptorHeapAllocation CreateAllocation(OffsetType offset, uint32_t count);
+
+	size_t GetManagerId() const { return m_thisManagerId; }
 	uint32_t GetNumAvailableDescriptors() const { return m_freeBlockManager.GetFreeSize(); }
 	uint32_t GetMaxDescriptors() const { return m_descriptorSize; }
+	VariableSizeAllocationStats GetStats();
 
 private:
 	VariableSizeGPUAllocationsManager m_freeBlockManager;
@@ -158,7 +179,7 @@ private:
 };
 
 
-class CPUDescriptorHeap final : public IDescriptorAllocator
+class CPUDescriptorHeap final : public IDescriptorAllocator, public IDescriptorChunkSource
 {
 private:
 	static enum class EGPUDescriptorHeapType : int
@@ -173,7 +194,8 @@ public:
 		ID3D12Device* device,
 		uint32_t numDescriptorsInHeap,
 		D3D12_DESCRIPTOR_HEAP_TYPE  type,
-		D3D12_DESCRIPTOR_HEAP_FLAGS flags);
+		D3D12_DESCRIPTOR_HEAP_FLAGS flags,
+		uint32_t threadCacheChunkSize = 0);
 
 	CPUDescriptorHeap(const CPUDescriptorHeap&) = delete;
 	CPUDescriptorHeap(CPUDescriptorHeap&&) = delete;
@@ -185,7 +207,17 @@ public:
 	virtual DescriptorHeapAllocation Allocate(uint32_t count) override final;
 	virtual void Free(DescriptorHeapAllocation&& allocation) override final;
 	virtual uint32_t GetDescriptorSize() const override final { return m_descriptorSize; }
+	//스레드 캐시의 남은 청크를 먼저 반환함
 	void ReleaseStaleAllocations(uint64_t numCompletedFrames);
+	//풀 안의 힙 통계를 합침, 최고 사용량은 m_maxHeapSize
+	DescriptorHeapStats GetStats();
+
+	virtual DescriptorRange AllocateChunk(uint32_t count) override final;
+	virtual void ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes) override final;
+
+private:
+	//풀에서 빈 힙을 찾아 할당, 없으면 힙 추가
+	DescriptorHeapAllocationManager* AllocateRange(uint32_t count, OffsetType& offset);
 
 private:
 
@@ -203,9 +235,11 @@ private:
 	uint32_t m_currentSize = 0;
 
 	ID3D12Device* m_device;
+
+	ThreadDescriptorCaches m_threadCaches;
 };
 
-class GPUDescriptorHeap final : public IDescriptorAllocator
+class GPUDescriptorHeap final : public IDescriptorAllocator, public IDescriptorChunkSource
 {
 public:
 	GPUDescriptorHeap(
@@ -213,7 +247,8 @@ public:
 		uint32_t numDescriptorsInHeap,
 		uint32_t numDynamicDescriptors,
 		D3D12_DESCRIPTOR_HEAP_TYPE  type,
-		D3D12_DESCRIPTOR_HEAP_FLAGS flags);
+		D3D12_DESCRIPTOR_HEAP_FLAGS flags,
+		uint32_t threadCacheChunkSize = 0);
 
 	GPUDescriptorHeap(const GPUDescriptorHeap&) = delete;
 	GPUDescriptorHeap(GPUDescriptorHeap&&) = delete;
@@ -230,10 +265,8 @@ public:
 	virtual void Free(DescriptorHeapAllocation&& allocation) override final;
 	virtual uint32_t GetDescriptorSize() const override final { return m_descriptorSize; }
 
-	DescriptorHeapAllocation AllocateDynamic(uint32_t Count)
-	{
-		return m_dynamicAllocationsManager.Allocate(Count);
-	}
+	//dynamic 부분은 스레드 캐시를 먼저 사용
+	DescriptorHeapAllocation AllocateDynamic(uint32_t Count);
 
 	const D3D12_DESCRIPTOR_HEAP_DESC& GetHeapDesc() const { return m_heapDesc; }
 	uint32_t GetMaxStaticDescriptors() const { return m_heapAllocationManager.GetMaxDescriptors(); }
@@ -241,6 +274,13 @@ public:
 
 	ID3D12DescriptorHeap* GetDescriptorHeap() { return m_descriptorHeap.Get(); }
 	void ReleaseStaleAllocations(uint64_t numCompletedFrames);
+
+	VariableSizeAllocationStats GetStaticStats() { return m_heapAllocationManager.GetStats(); }
+	VariableSizeAllocationStats GetDynamicStats() { return m_dynamicAllocationsManager.GetStats(); }
+
+	//dynamic 부분의 청크
+	virtual DescriptorRange AllocateChunk(uint32_t count) override final;
+	virtual void ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes) override final;
 protected:
 	ID3D12Device* m_device;
 
@@ -254,6 +294,8 @@ protected:
 
 	// Allocation manager for dynamic part
 	DescriptorHeapAllocationManager m_dynamicAllocationsManager;
+
+	ThreadDescriptorCaches m_threadCaches;
 };
 
 
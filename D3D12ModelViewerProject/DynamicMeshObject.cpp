@@ -2,6 +2,9 @@
 #include "DynamicMeshObject.h"
 #include "D3DResourceManager.h"
 #include "FileUtil.h"
+#include "GameTimer.h"
+#include "AnimationBaking.h"
+#include "Skinning.h"
 
 using namespace std;
 using namespace DirectX;
@@ -12,21 +15,191 @@ std::shared_ptr<DynamicMesh> DynamicMesh::Create(std::string name, const MeshRes
 }
 
 DynamicMesh::DynamicMesh(std::string name, const MeshResources& meshResource)
-	:MeshObject(name, meshResource, 3, 2, MeshType::DynamicMesh)
+	:MeshObject(name, meshResource, 6, 2, MeshType::DynamicMesh)
 {
 	m_instanceAnimatonBuffer.resize(FramesCount);
+	m_instanceDualQuaternionBuffer.resize(FramesCount);
+	m_frameBakedPaletteBuffers.resize(FramesCount);
+	m_frameBakedClipBuffers.resize(FramesCount);
 }
 
 void DynamicMesh::Update()
 {
+	//디스크립터를 다시 만들기 전에 이번 프레임에 쓸 구운 클립을 모두 올려둠
+	RegisterBakedAnimations();
 	MeshObject::Update();
 }
 
+void DynamicMesh::RegisterBakedAnimations()
+{
+	bool isDirty = m_InstanceUpdateDirty != 0;
+	for (auto& meshInstance : m_meshInstances)
+	{
+		isDirty |= meshInstance->GetAnimationDirty() != 0;
+	}
+	if (isDirty == false)
+	{
+		return;
+	}
+
+	//인스턴스가 쓰는 구운 클립
+	std::vector<const AnimationClip*> usedClips;
+	for (auto& meshInstance : m_meshInstances)
+	{
+		const std::shared_ptr<const AnimationClip>& clip = meshInstance->GetBakedAnimation();
+		if (clip != nullptr && std::find(usedClips.begin(), usedClips.end(), clip.get()) == usedClips.end())
+		{
+			usedClips.push_back(clip.get());
+		}
+	}
+
+	//아무 인스턴스도 쓰지 않는 클립은 비우고, 다른 인스턴스의 clip id가 바뀌지 않도록 빈 자리로 남김
+	bool isChanged = false;
+	for (size_t clipId = 0; clipId < m_bakedClips.size(); ++clipId)
+	{
+		if (m_bakedClips[clipId] != nullptr && std::find(usedClips.begin(), usedClips.end(), m_bakedClips[clipId].get()) == usedClips.end())
+		{
+			m_bakedClips[clipId].reset();
+			isChanged = true;
+		}
+	}
+
+	//새 클립은 빈 자리부터 채움
+	for (auto& meshInstance : m_meshInstances)
+	{
+		const std::shared_ptr<const AnimationClip>& clip = meshInstance->GetBakedAnimation();
+		if (clip == nullptr || GetBakedClipId(clip.get()) != BakedClipNone)
+		{
+			continue;
+		}
+
+		size_t clipId = std::find(m_bakedClips.begin(), m_bakedClips.end(), nullptr) - m_bakedClips.begin();
+		if (clipId == m_bakedClips.size())
+		{
+			m_bakedClips.emplace_back();
+			m_bakedClipBounds.emplace_back();
+		}
+		m_bakedClips[clipId] = clip;
+		m_bakedClipBounds[clipId] = ComputeBakedClipBounds(*clip->Baked);
+		isChanged = true;
+	}
+
+	while (m_bakedClips.empty() == false && m_bakedClips.back() == nullptr)
+	{
+		m_bakedClips.pop_back();
+		m_bakedClipBounds.pop_back();
+	}
+
+	if (isChanged)
+	{
+		RebuildBakedAnimationBuffers();
+		m_HeapAllocationDirty = FramesCount;
+	}
+}
+
+BoundingBox DynamicMesh::ComputeBakedClipBounds(const BakedAnimation& baked) const
+{
+	//재생 위치를 알수 없으므로 모든 프레임 포함
+	BoundingBox clipBounds = m_bounds;
+	for (UINT frame = 0; frame < baked.FrameCount; ++frame)
+	{
+		BoundingBox frameBounds;
+		Skinning::ComputeSkinnedBounds(baked.Palettes.data() + frame * baked.BoneCount, m_skeleton.SkinnedJointBounds, frameBounds);
+		if (frame == 0)
+		{
+			clipBounds = frameBounds;
+		}
+		else
+		{
+			BoundingBox::CreateMerged(clipBounds, clipBounds, frameBounds);
+		}
+	}
+	return clipBounds;
+}
+
+void DynamicMesh::RebuildBakedAnimationBuffers()
+{
+	//빈 자리는 FrameCount 0
+	std::vector<BakedClipInfo> clipInfos(m_bakedClips.size());
+	size_t paletteCount = 0;
+	for (size_t clipId = 0; clipId < m_bakedClips.size(); ++clipId)
+	{
+		if (m_bakedClips[clipId] == nullptr)
+		{
+			continue;
+		}
+		const BakedAnimation& baked = *m_bakedClips[clipId]->Baked;
+
+		BakedClipInfo& clipInfo = clipInfos[clipId];
+		clipInfo.PaletteOffset = static_cast<UINT>(paletteCount);
+		clipInfo.FrameCount = baked.FrameCount;
+		clipInfo.FramePerSecond = baked.FramePerSecond;
+		clipInfo.BoneCount = baked.BoneCount;
+
+		paletteCount += baked.Palettes.size();
+	}
+
+	//비어있어도 디스크립터를 만들 수 있게 최소 1개
+	D3DResourceManager& resourceManager = D3DResourceManager::GetInstance();
+	m_bakedPaletteBuffer = resourceManager.CreateUploadBuffer<BoneTransform3x4>(static_cast<UINT>((std::max)(paletteCount, size_t(1))), false);
+	m_bakedClipBuffer = resourceManager.CreateUploadBuffer<BakedClipInfo>(static_cast<UINT>((std::max)(clipInfos.size(), size_t(1))), false);
+
+	for (size_t clipId = 0; clipId < m_bakedClips.size(); ++clipId)
+	{
+		if (m_bakedClips[clipId] != nullptr)
+		{
+			const BakedAnimation& baked = *m_bakedClips[clipId]->Baked;
+			m_bakedPaletteBuffer->CopyData(static_cast<int>(clipInfos[clipId].PaletteOffset), baked.Palettes.data(), baked.Palettes.size());
+		}
+		m_bakedClipBuffer->CopyData(static_cast<int>(clipId), clipInfos[clipId]);
+	}
+}
+
+void DynamicMesh::WriteInstancePalette(int frameIndex, size_t instanceIndex, const InstanceAnimations* palette)
+{
+	const size_t boneCount = m_skeleton.Joints.size();
+	const int offset = static_cast<int>(instanceIndex * boneCount);
+
+	BoundingBox bounds;
+	Skinning::ComputeSkinnedBounds(palette, m_skeleton.SkinnedJointBounds, bounds);
+
+	if (m_skinningMode == SkinningModes::DualQuaternion)
+	{
+		m_dualQuaternionPalette.resize(boneCount);
+		Skinning::ToDualQuaternions(palette, m_dualQuaternionPalette.data(), boneCount);
+		m_instanceDualQuaternionBuffer.at(frameIndex)->CopyData(offset, m_dualQuaternionPalette.data(), boneCount);
+
+		//듀얼쿼터니언은 본 스케일을 버리므로 강체 변환 박스도 합침
+		//같이 섞이는 본끼리 회전 차이가 아주 크면 정점이 호를 따라 박스를 조금 벗어날 수 있음
+		BoundingBox rigidBounds;
+		Skinning::ComputeSkinnedBounds(m_dualQuaternionPalette.data(), m_skeleton.SkinnedJointBounds, rigidBounds);
+		BoundingBox::CreateMerged(bounds, bounds, rigidBounds);
+	}
+	else
+	{
+		m_instanceAnimatonBuffer.at(frameIndex)->CopyData(offset, palette, boneCount);
+	}
+
+	m_meshInstances[instanceIndex]->SetLocalBounds(bounds);
+}
+
+UINT DynamicMesh::GetBakedClipId(const AnimationClip* clip) const
+{
+	for (size_t clipId = 0; clipId < m_bakedClips.size(); ++clipId)
+	{
+		if (m_bakedClips[clipId].get() == clip)
+		{
+			return static_cast<UINT>(clipId);
+		}
+	}
+	return BakedClipNone;
+}
+
 void DynamicMesh::Render(ID3D12GraphicsCommandList* cmdList, RenderType renderType)
 {
 	int frameIndex = D3DResourceManager::GetInstance().GetCurrentFrameIndex();
 
-	if (m_enable == false)
+	if (m_enable == false || m_visibleInstanceCount == 0)
 	{
 		return;
 	}
@@ -68,7 +241,7 @@ void DynamicMesh::Render(ID3D12GraphicsCommandList* cmdList, RenderType renderTy
 
 		cmdList->DrawIndexedInstanced(
 			renderItem.IndexCount,
-			m_meshInstances.size(),
+			m_visibleInstanceCount,
 			renderItem.StartIndexLocation,
 			renderItem.BaseVertexLocation,
 			0
@@ -125,10 +298,37 @@ void DynamicMesh::ReAllocateDescriptorHeaps(int frameIndex)
 	instanceAnimationDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
 	instanceAnimationDesc.Format = DXGI_FORMAT_UNKNOWN;
 	instanceAnimationDesc.Buffer.FirstElement = 0;
-	instanceAnimationDesc.Buffer.NumElements = m_skeleton.Joints.size() * m_maxInstanceCount;
+	instanceAnimationDesc.Buffer.NumElements = instanceAnimationBuffer->GetMaxElementCount();
 	instanceAnimationDesc.Buffer.StructureByteStride = instanceAnimationBuffer->GetElementByteSize();
 
 	resourceManager.CreateSRV(instanceAnimationBuffer->Resource(), heapAllocation.GetCpuHandle(Offset++), instanceAnimationDesc);
+
+	auto& instanceDualQuaternionBuffer = m_instanceDualQuaternionBuffer.at(frameIndex);
+	D3D12_SHADER_RESOURCE_VIEW_DESC instanceDualQuaternionDesc = instanceAnimationDesc;
+	instanceDualQuaternionDesc.Buffer.NumElements = instanceDualQuaternionBuffer->GetMaxElementCount();
+	instanceDualQuaternionDesc.Buffer.StructureByteStride = instanceDualQuaternionBuffer->GetElementByteSize();
+
+	resourceManager.CreateSRV(instanceDualQuaternionBuffer->Resource(), heapAllocation.GetCpuHandle(Offset++), instanceDualQuaternionDesc);
+
+	//구운 클립, 이 프레임이 끝날때까지 이전 버퍼를 유지
+	if (m_bakedPaletteBuffer == nullptr)
+	{
+		RebuildBakedAnimationBuffers();
+	}
+	m_frameBakedPaletteBuffers.at(frameIndex) = m_bakedPaletteBuffer;
+	m_frameBakedClipBuffers.at(frameIndex) = m_bakedClipBuffer;
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC bakedPaletteDesc = instanceAnimationDesc;
+	bakedPaletteDesc.Buffer.NumElements = m_bakedPaletteBuffer->GetMaxElementCount();
+	bakedPaletteDesc.Buffer.StructureByteStride = m_bakedPaletteBuffer->GetElementByteSize();
+
+	resourceManager.CreateSRV(m_bakedPaletteBuffer->Resource(), heapAllocation.GetCpuHandle(Offset++), bakedPaletteDesc);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC bakedClipDesc = instanceAnimationDesc;
+	bakedClipDesc.Buffer.NumElements = m_bakedClipBuffer->GetMaxElementCount();
+	bakedClipDesc.Buffer.StructureByteStride = m_bakedClipBuffer->GetElementByteSize();
+
+	resourceManager.CreateSRV(m_bakedClipBuffer->Resource(), heapAllocation.GetCpuHandle(Offset++), bakedClipDesc);
 	///
 
 
@@ -170,21 +370,200 @@ void DynamicMesh::ReAllocateDescriptorHeaps(int frameIndex)
 
 void DynamicMesh::UpdateInstanceBuffers(int frameIndex)
 {
-	int i = 0;
-	for (auto& meshInstance : m_meshInstances)
+	const size_t boneCount = m_skeleton.Joints.size();
+	const float deltaTime = GetMainTimer().DeltaTime();
+
+	AnimationLodSystem& lodSystem = GetAnimationLodSystem();
+	AnimationLodStats& lodStats = lodSystem.GetStats();
+
+	m_poseBatch.Begin(m_skeleton);
+	m_interpolatedInstances.clear();
+	m_sharedPaletteInstances.clear();
+
+	for (size_t i = 0; i < m_meshInstances.size(); ++i)
 	{
-		if (meshInstance->GetAnimationDirty() > 0 || m_InstanceUpdateDirty > 0)
+		MeshInstance& meshInstance = *m_meshInstances[i];
+		if (meshInstance.GetAnimationDirty() == 0 && m_InstanceUpdateDirty == 0)
+		{
+			continue;
+		}
+
+		//구운 클립은 셰이더에서 팔레트를 읽음
+		const std::shared_ptr<const AnimationClip>& bakedClip = meshInstance.GetBakedAnimation();
+		const UINT bakedClipId = bakedClip != nullptr ? GetBakedClipId(bakedClip.get()) : BakedClipNone;
+		meshInstance.SetBakedClipId(bakedClipId);
+		if (bakedClip != nullptr)
+		{
+			if (bakedClipId != BakedClipNone)
+			{
+				meshInstance.SetLocalBounds(m_bakedClipBounds[bakedClipId]);
+			}
+			continue;
+		}
+
+		AnimationCalcuator& animationCalculator = meshInstance.GetAnimationCalculator();
+		AnimationLodState& lod = meshInstance.GetAnimationLod();
+		if (animationCalculator.HasAnimation() == false)
 		{
-			const std::vector<InstanceAnimations> animations = meshInstance->GetInstanceAnimations();
-			m_instanceAnimatonBuffer.at(frameIndex)->CopyData(i * m_skeleton.Joints.size(), animations.data(), animations.size());
+			lod = AnimationLodState();
+			meshInstance.SetAnimationOffset(static_cast<UINT>(i * boneCount));
+			m_bindposePalette.resize(boneCount);
+			WriteInstancePalette(frameIndex, i, m_bindposePalette.data());
+			continue;
 		}
-		i++;
+
+		int level = 0;
+		if (lodSystem.IsEnabled())
+		{
+			BoundingBox worldBox;
+			meshInstance.GetLocalBounds().Transform(worldBox, XMMatrixMultiply(meshInstance.GetTransform().GetFinalTransformMatrix(), m_finalTransform));
+
+			BoundingSphere worldSphere;
+			BoundingSphere::CreateFromBoundingBox(worldSphere, worldBox);
+			level = lodSystem.SelectLevel(worldSphere);
+		}
+
+		//화면밖이면 마지막 포즈 유지, 인스턴스 위치가 바뀌었거나 계산한 적이 없으면 가장 낮은 단계로 계산
+		if (level == AnimationLodSystem::OffscreenLevel)
+		{
+			if (lodSystem.IsFreezeOffscreen() && lod.Level >= 0 && m_InstanceUpdateDirty == 0)
+			{
+				lod.FromPalette.clear();
+				lod.ToPalette.clear();
+				lodStats.FrozenInstances++;
+				lodStats.SkippedBones += boneCount;
+				continue;
+			}
+			level = AnimationLodSystem::LevelCount - 1;
+		}
+
+		const AnimationLodLevel& lodLevel = lodSystem.GetLevel(level);
+		const size_t activeBoneCount = m_poseBatch.GetActiveBoneCount(lodLevel.DroppedLeafLevels);
+
+		if (lodLevel.UpdateInterval <= 1)
+		{
+			lod.Level = level;
+			lod.FromPalette.clear();
+			lod.ToPalette.clear();
+
+			//같이 재생중인 인스턴스가 이미 계산한 팔레트를 읽음
+			//멈춘 인스턴스는 더 갱신되지 않으므로 항상 자기 위치를 씀
+			const AnimationClip* clip = nullptr;
+			float time = 0.0f;
+			size_t ownerIndex = i;
+			if (meshInstance.IsAnimationPlaying() && animationCalculator.GetSingleClipSample(clip, time) &&
+				m_poseBatch.FindSharedPalette(clip, time, lodLevel.DroppedLeafLevels, i, ownerIndex))
+			{
+				meshInstance.SetAnimationOffset(static_cast<UINT>(ownerIndex * boneCount));
+				m_sharedPaletteInstances.emplace_back(i, ownerIndex);
+
+				lodStats.FullRateInstances++;
+				lodStats.SharedPalettes++;
+				lodStats.SkippedBones += boneCount;
+				continue;
+			}
+
+			meshInstance.SetAnimationOffset(static_cast<UINT>(i * boneCount));
+			animationCalculator.AddPoseSamples(m_poseBatch, m_poseBatch.AddPose(i, lodLevel.DroppedLeafLevels));
+
+			lodStats.FullRateInstances++;
+			lodStats.EvaluatedBones += activeBoneCount;
+			lodStats.SkippedBones += boneCount - activeBoneCount;
+			continue;
+		}
+
+		//갱신 주기마다 다음 갱신 시점 포즈를 계산하고 사이 프레임은 두 팔레트를 보간
+		meshInstance.SetAnimationOffset(static_cast<UINT>(i * boneCount));
+		lodStats.ReducedRateInstances++;
+		m_interpolatedInstances.push_back(i);
+
+		bool isKeyFrame = lod.ToPalette.empty() || lod.Level != level || ++lod.FramesSinceUpdate >= lodLevel.UpdateInterval;
+		lod.Level = level;
+		if (isKeyFrame == false)
+		{
+			lodStats.SkippedBones += boneCount;
+			continue;
+		}
+
+		float timeOffset = 0.0f;
+		if (lod.ToPalette.empty() == false)
+		{
+			lod.FromPalette.swap(lod.ToPalette);
+			if (meshInstance.IsAnimationPlaying())
+			{
+				timeOffset = deltaTime * lodLevel.UpdateInterval;
+			}
+		}
+		else
+		{
+			lod.FromPalette.clear();
+		}
+		lod.FramesSinceUpdate = 0;
+
+		animationCalculator.AddPoseSamples(m_poseBatch, m_poseBatch.AddPose(i, lodLevel.DroppedLeafLevels, &lod.ToPalette), timeOffset);
+
+		lodStats.EvaluatedBones += activeBoneCount;
+		lodStats.SkippedBones += boneCount - activeBoneCount;
+	}
+
+	//샘플의 재생상태 참조는 이번 프레임에만 유효
+	//선형 스키닝은 업로드 버퍼에 바로 쓰고, 듀얼쿼터니언은 변환해야 하므로 팔레트를 넘겨받음
+	if (m_skinningMode == SkinningModes::DualQuaternion)
+	{
+		m_poseBatch.Execute([this, frameIndex](size_t instanceIndex, const InstanceAnimations* palette)
+			{
+				WriteInstancePalette(frameIndex, instanceIndex, palette);
+			});
 	}
+	else
+	{
+		m_poseBatch.Execute(m_instanceAnimatonBuffer.at(frameIndex)->GetMappedData(), m_skeleton.SkinnedJointBounds,
+			[this](size_t instanceIndex, const BoundingBox& bounds)
+			{
+				m_meshInstances[instanceIndex]->SetLocalBounds(bounds);
+			});
+	}
+
+	for (auto& element : m_sharedPaletteInstances)
+	{
+		m_meshInstances[element.first]->SetLocalBounds(m_meshInstances[element.second]->GetLocalBounds());
+	}
+
+	m_interpolatedPalette.resize(boneCount);
+	for (size_t instanceIndex : m_interpolatedInstances)
+	{
+		AnimationLodState& lod = m_meshInstances[instanceIndex]->GetAnimationLod();
+		if (lod.FromPalette.empty())
+		{
+			lod.FromPalette = lod.ToPalette;
+		}
+
+		float alpha = static_cast<float>(lod.FramesSinceUpdate) / lodSystem.GetLevel(lod.Level).UpdateInterval;
+		for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+		{
+			InstanceAnimations& result = m_interpolatedPalette[boneIndex];
+			const InstanceAnimations& from = lod.FromPalette[boneIndex];
+			const InstanceAnimations& to = lod.ToPalette[boneIndex];
+			for (int row = 0; row < 3; ++row)
+			{
+				XMStoreFloat4(&result.Rows[row], XMVectorLerp(XMLoadFloat4(&from.Rows[row]), XMLoadFloat4(&to.Rows[row]), alpha));
+			}
+		}
+
+		WriteInstancePalette(frameIndex, instanceIndex, m_interpolatedPalette.data());
+	}
+
 	MeshObject::UpdateInstanceBuffers(frameIndex);
 }
 
 void DynamicMesh::ReAllocateInstanceBuffer(int frameIndex)
 {
 	MeshObject::ReAllocateInstanceBuffer(frameIndex);
-	m_instanceAnimatonBuffer.at(frameIndex) = D3DResourceManager::GetInstance().CreateUploadBuffer<InstanceAnimations>(m_maxInstanceCount * m_skeleton.Joints.size(), false);
+	D3DResourceManager& resourceManager = D3DResourceManager::GetInstance();
+	const UINT paletteCount = static_cast<UINT>(m_maxInstanceCount * m_skeleton.Joints.size());
+
+	//쓰지 않는 형식은 디스크립터용으로 1개만
+	bool isDualQuaternion = m_skinningMode == SkinningModes::DualQuaternion;
+	m_instanceAnimatonBuffer.at(frameIndex) = resourceManager.CreateUploadBuffer<InstanceAnimations>(isDualQuaternion ? 1 : paletteCount, false);
+	m_instanceDualQuaternionBuffer.at(frameIndex) = resourceManager.CreateUploadBuffer<DualQuaternionTransform>(isDualQuaternion ? paletteCount : 1, false);
 }
\ No newline at end of file
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "MeshObject.h"
+#include "AnimationPoseBatch.h"
 
 class DynamicMesh : public MeshObject, public std::enable_shared_from_this<DynamicMesh>
 {
 private:
 	friend class MeshObject;
 	using InstanceAnimationBuffer = UploadBuffer<InstanceAnimations>;
+	using InstanceDualQuaternionBuffer = UploadBuffer<DualQuaternionTransform>;
+	using BakedPaletteBuffer = UploadBuffer<BoneTransform3x4>;
+	using BakedClipBuffer = UploadBuffer<BakedClipInfo>;
 private:
 	DynamicMesh(std::string name, const MeshResources& meshResource);
 	static std::shared_ptr<DynamicMesh> Create(std::string name, const MeshResources& meshResources);
@@ -20,8 +24,42 @@ protected:
 public:
 	virtual void Update() override;
 	virtual void Render(ID3D12GraphicsCommandList* cmdList, RenderType renderType);
+private:
+	//인스턴스가 새로 쓰는 구운 클립을 버퍼에 추가하고 더 쓰지 않는 클립은 뺌
+	void RegisterBakedAnimations();
+	DirectX::BoundingBox ComputeBakedClipBounds(const BakedAnimation& baked) const;
+	void RebuildBakedAnimationBuffers();
+	UINT GetBakedClipId(const AnimationClip* clip) const;
+
+	//스키닝 모드에 맞는 버퍼에 팔레트를 쓰고 인스턴스 바운딩박스를 갱신
+	void WriteInstancePalette(int frameIndex, size_t instanceIndex, const InstanceAnimations* palette);
 
 private:
 	std::vector<std::unique_ptr<InstanceAnimationBuffer>> m_instanceAnimatonBuffer;
+	//SkinningModes::DualQuaternion일때만 인스턴스 크기만큼, 아니면 1개
+	std::vector<std::unique_ptr<InstanceDualQuaternionBuffer>> m_instanceDualQuaternionBuffer;
+	std::vector<DualQuaternionTransform> m_dualQuaternionPalette;
+
+	//구운 클립, 인덱스가 clip id, 쓰지 않게 된 자리는 nullptr
+	std::vector<std::shared_ptr<const AnimationClip>> m_bakedClips;
+	//클립이 추가되면 새로 만들고 프레임마다 디스크립터를 다시 만들때 교체
+	std::shared_ptr<BakedPaletteBuffer> m_bakedPaletteBuffer;
+	std::shared_ptr<BakedClipBuffer> m_bakedClipBuffer;
+	std::vector<std::shared_ptr<BakedPaletteBuffer>> m_frameBakedPaletteBuffers;
+	std::vector<std::shared_ptr<BakedClipBuffer>> m_frameBakedClipBuffers;
+	//구운 클립의 모든 프레임을 합친 바운딩박스, m_bakedClips와 같은 인덱스
+	std::vector<DirectX::BoundingBox> m_bakedClipBounds;
+
+	//인스턴스마다 클립, 크로스페이드, 레이어를 섞은 포즈를 한번에 계산
+	AnimationPoseBatch m_poseBatch;
+	//클립이 없는 인스턴스
+	std::vector<InstanceAnimations> m_bindposePalette;
+
+	//다른 인스턴스 팔레트를 읽는 인스턴스, 팔레트 주인 위치
+	std::vector<std::pair<size_t, size_t>> m_sharedPaletteInstances;
+
+	//LOD로 갱신 주기가 줄어 팔레트를 보간하는 인스턴스
+	std::vector<size_t> m_interpolatedInstances;
+	std::vector<InstanceAnimations> m_interpolatedPalette;
 };
 
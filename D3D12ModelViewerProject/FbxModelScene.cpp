@@ -7,15 +7,36 @@
 #include <algorithm>
 #include "GameTimer.h"
 #include "FileUtil.h"
+#include "ThreadManager.h"
 
 using namespace std;
 using namespace DirectX;
 
+namespace
+{
+	VertexKey CreateVertexKey(const MeshVertexStreams& streams, size_t index)
+	{
+		const XMFLOAT3& position = streams.Positions[index];
+		const XMFLOAT3& normal = streams.Normals[index];
+		const XMFLOAT2& texC = streams.TexCoords[index];
+
+		VertexKey key;
+		key.Position[0] = VertexKey::CanonicalFloatBits(position.x);
+		key.Position[1] = VertexKey::CanonicalFloatBits(position.y);
+		key.Position[2] = VertexKey::CanonicalFloatBits(position.z);
+		key.Normal[0] = VertexKey::CanonicalFloatBits(normal.x);
+		key.Normal[1] = VertexKey::CanonicalFloatBits(normal.y);
+		key.Normal[2] = VertexKey::CanonicalFloatBits(normal.z);
+		key.TexC[0] = VertexKey::CanonicalFloatBits(texC.x);
+		key.TexC[1] = VertexKey::CanonicalFloatBits(texC.y);
+		key.MaterialIndex = streams.MaterialIndices[index];
+		return key;
+	}
+}
+
 
 FbxModelScene::FbxModelScene(std::wstring filename)
 {
-	bool result;
-
 	m_manager = FbxManager::Create();
 	assert(m_manager != nullptr);
 
@@ -27,13 +48,20 @@ FbxModelScene::FbxModelScene(std::wstring filename)
 
 	std::string fileStr = WstringToUTF8(filename);
 	FbxString filePath(fileStr.c_str());
-	result = LoadScene(m_manager, m_scene, filePath.Buffer());
-	m_sceneEvaluator = m_scene->GetAnimationEvaluator();
-	ProcessMaterialTable(m_scene);
-	ProcessScene(m_scene);
+	m_isLoaded = LoadScene(m_manager, m_scene, filePath.Buffer());
 
 	m_directory = FileUtil::GetDirectory(filename);
 	m_name = WstringToUTF8(FileUtil::GetFileNameWithoutExtension(filename));
+
+	//실패한 씬은 처리하지 않음, 호출측에서 IsLoaded 확인
+	if (m_isLoaded == false)
+	{
+		return;
+	}
+
+	m_sceneEvaluator = m_scene->GetAnimationEvaluator();
+	ProcessMaterialTable(m_scene);
+	ProcessScene(m_scene);
 }
 
 FbxModelScene::~FbxModelScene()
@@ -63,6 +91,7 @@ bool FbxModelScene::LoadScene(FbxManager* pManager, FbxDocument* pScene, const c
 	if (!ImportStatus)
 	{
 		FbxString error = importer->GetStatus().GetErrorString();
+		importer->Destroy();
 		return false;
 	}
 
@@ -70,6 +99,7 @@ bool FbxModelScene::LoadScene(FbxManager* pManager, FbxDocument* pScene, const c
 
 	if (status == false || (importer->GetStatus() != FbxStatus::eSuccess))
 	{
+		importer->Destroy();
 		return false;
 	}
 
@@ -80,7 +110,7 @@ bool FbxModelScene::LoadScene(FbxManager* pManager, FbxDocument* pScene, const c
 	return status;
 }
 
-void FbxModelScene::ProcessNode(FbxNode* pNode)
+void FbxModelScene::ProcessNode(FbxNode* pNode, std::vector<FbxNode*>& meshNodes)
 {
 	FbxNodeAttribute* attribute = pNode->GetNodeAttribute();
 
@@ -89,7 +119,7 @@ void FbxModelScene::ProcessNode(FbxNode* pNode)
 		switch (attribute->GetAttributeType())
 		{
 		case FbxNodeAttribute::eMesh:
-			LoadMesh(pNode);
+			meshNodes.push_back(pNode);
 			break;
 		default:
 			break;
@@ -99,7 +129,7 @@ void FbxModelScene::ProcessNode(FbxNode* pNode)
 	int childCount = pNode->GetChildCount();
 	for (int i = 0; i < childCount; ++i)
 	{
-		ProcessNode(pNode->GetChild(i));
+		ProcessNode(pNode->GetChild(i), meshNodes);
 	}
 }
 
@@ -113,23 +143,63 @@ void FbxModelScene::ProcessScene(FbxScene* pScene)
 	}
 
 	ProcessSkeletonHierachy(node);
+	m_jointBakeSources.resize(m_skeleton.Joints.size());
 
+	std::vector<FbxNode*> meshNodes;
 	for (int i = 0; i < node->GetChildCount(); ++i)
 	{
-		ProcessNode(node->GetChild(i));
+		ProcessNode(node->GetChild(i), meshNodes);
 	}
 
+	LoadMeshes(meshNodes);
+	BakeAnimations();
 }
 
-void FbxModelScene::LoadMesh(FbxNode* pNode)
+bool FbxModelScene::LoadMesh(FbxNode* pNode, MeshPolygonData& meshData)
 {
 	FbxMesh* mesh = (FbxMesh*)pNode->GetNodeAttribute();
 
 	if (mesh->RemoveBadPolygons() < 0)
 	{
-		return;
+		return false;
+	}
+
+	if (pNode->GetMaterialCount() <= 0)
+	{
+		return false;
+	}
+
+	meshData.Mesh = mesh;
+	meshData.Transform = m_sceneEvaluator->GetNodeLocalTransform(pNode);
+	ProcessJointsAndAnimations(pNode, meshData.SkinWeights);
+	return true;
+}
+
+void FbxModelScene::LoadMeshes(const std::vector<FbxNode*>& meshNodes)
+{
+	//Scene을 수정하거나 Evaluator를 쓰는 작업은 순서대로 처리
+	std::vector<MeshPolygonData> meshDatas;
+	meshDatas.reserve(meshNodes.size());
+	for (FbxNode* meshNode : meshNodes)
+	{
+		MeshPolygonData meshData;
+		if (LoadMesh(meshNode, meshData))
+		{
+			meshDatas.push_back(std::move(meshData));
+		}
+	}
+
+	//메쉬별 정점추출, 중복제거는 메쉬끼리 독립적이므로 병렬처리
+	ThreadManager::GetInstance().ParallelFor(meshDatas.size(), [this, &meshDatas](size_t index)
+		{
+			ProcessPolygons(meshDatas[index]);
+		});
+
+	//직렬처리와 결과가 같도록 노드 순서대로 합침
+	for (auto& meshData : meshDatas)
+	{
+		MergeMeshPolygons(meshData);
 	}
-	ProcessPolygons(mesh);
 }
 
 void FbxModelScene::RenameDuplicatedMaterial(FbxScene* pScene)
@@ -144,7 +214,7 @@ void FbxModelScene::RenameDuplicatedMaterial(FbxScene* pScene)
 		std::function<void(const string&)> applyFunction)
 	{
 		string	uniqueName(assetName);
-		//ߺ  ̸
+		//중복이 있으면 이름수정
 		if (AllMaterialAndTextureNames.find(uniqueName) != AllMaterialAndTextureNames.end())
 		{
 			string assetBaseName = uniqueName + "_v_";
@@ -163,11 +233,11 @@ void FbxModelScene::RenameDuplicatedMaterial(FbxScene* pScene)
 	{
 		FbxSurfaceMaterial* material = materialArray[materialIndex];
 		std::string materialName = material->GetName();
-		//׸  ؽó  
+		//마테리얼 별 텍스처 가져온후 저장
 		auto texSet = GetFbxMaterialTextures(*material);
 		MaterialTextures.insert(texSet.begin(), texSet.end());
 
-		//׸ ߺ̸ ġ
+		//마테리얼 중복이름 고치기
 		FixName(materialName,
 			[&](const string uniqueName) { material->SetName(uniqueName.c_str()); });
 	}
@@ -186,6 +256,7 @@ void FbxModelScene::ProcessMaterialTable(FbxScene* pScene)
 
 	for (int i = 0; i < materialArray.Size(); ++i)
 	{
+		m_fbxMaterialIndices.emplace(materialArray.GetAt(i), static_cast<int>(m_fbxMaterials.size()));
 		m_fbxMaterials.push_back(materialArray.GetAt(i));
 	}
 }
@@ -196,7 +267,7 @@ FbxSurfaceMaterial* FbxModelScene::FindFbxMaterial(std::string UTF8MaterialName)
 }
 
 
-std::shared_ptr<MeshResources> FbxModelScene::CreateMeshResource()
+MeshResourcesInfo FbxModelScene::CreateMeshResourcesInfo()
 {
 	MeshResourcesInfo meshResourceInfo;
 
@@ -219,51 +290,27 @@ std::shared_ptr<MeshResources> FbxModelScene::CreateMeshResource()
 
 	//submeshVertex ->vertex
 	meshResourceInfo.VertexTable.reserve(m_vertexTable.size());
-	std::transform(m_vertexTable.begin(), m_vertexTable.end(), std::back_inserter(meshResourceInfo.VertexTable), VertexConverter::ConvertFromSubMeshVertex);
+	for (const SubMeshVertex& subMeshVertex : m_vertexTable)
+	{
+		meshResourceInfo.VertexTable.push_back(VertexConverter::ConvertFromSubMeshVertex(subMeshVertex, m_skinWeights.at(subMeshVertex.SkinIndex)));
+	}
 
 	meshResourceInfo.SubMeshes = m_subMeshes;
 	meshResourceInfo.Skeleton = m_skeleton;
 
-	return make_shared<MeshResources>(meshResourceInfo);
+	return meshResourceInfo;
 }
 
-void FbxModelScene::Triangulate(TempPolygon& polygon, std::vector<TempPolygon>& output)
+void FbxModelScene::ProcessPolygons(MeshPolygonData& meshData)
 {
-	assert(polygon.Count >= 3);
-
-	output.clear();
-
-	for (int i = 0; i < polygon.Count - 2; ++i)
-	{
-		TempPolygon temp;
-		temp.Count = 3;
-
-		temp.Vertices.push_back(polygon.Vertices.at(0));
-		temp.Vertices.push_back(polygon.Vertices.at(i + 1));
-		temp.Vertices.push_back(polygon.Vertices.at(i + 2));
-
-		output.push_back(std::move(temp));
-	}
-}
-
-
-
-void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
-{
-	if (pMesh->GetNode()->GetMaterialCount() <= 0)
-	{
-		return;
-	}
+	FbxMesh* pMesh = meshData.Mesh;
 
 	int polygonCount = pMesh->GetPolygonCount();
 	FbxVector4* controlPoints = pMesh->GetControlPoints();
 
-	FbxAMatrix transform = m_sceneEvaluator->GetNodeLocalTransform(pMesh->GetNode());
-
-	std::vector<ControlPoint> controlPointboneWeights;
-	ProcessJointsAndAnimations(pMesh->GetNode(), controlPointboneWeights);
+	const FbxAMatrix& transform = meshData.Transform;
 
-	//Ž Ƽ  üũ
+	//매쉬내 머티리얼이 같은지 체크
 	bool isAllSame = true;
 	for (int i = 0; i < pMesh->GetElementMaterialCount(); ++i)
 	{
@@ -275,33 +322,62 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 		}
 	}
 
-	// ﺰ   Ƽ ؽ÷,븻,źƮ   
-	vector<SubMeshVertex> vertexInfoArray;
-
-	vector<TempPolygon> polygonArray;
-	polygonArray.reserve(polygonCount);
+	//각 폴리곤별 정점에 대한 머티리얼 버텍스컬러,노말,탄젠트 등의 정보를 저장
+	MeshVertexStreams streams;
+	streams.Reserve(pMesh->GetPolygonVertexCount(), polygonCount);
 
 	int vertexId = 0;
 	for (int polygonIndex = 0; polygonIndex < polygonCount; ++polygonIndex)
 	{
 		int polygonSize = pMesh->GetPolygonSize(polygonIndex);
 		assert(polygonSize >= 3);
-		TempPolygon newPolygon;
-		newPolygon.Count = polygonSize;
+
+		int matId = -1;
+		if (isAllSame)
+		{
+			FbxGeometryElementMaterial* materialElement = pMesh->GetElementMaterial(0);
+			matId = materialElement->GetIndexArray().GetAt(0);
+		}
+		else
+		{
+			for (int elementalMaterialIndex = 0; elementalMaterialIndex < pMesh->GetElementMaterialCount(); ++elementalMaterialIndex)
+			{
+				FbxGeometryElementMaterial* materialElement = pMesh->GetElementMaterial(elementalMaterialIndex);
+				matId = materialElement->GetIndexArray().GetAt(polygonIndex);
+			}
+		}
+
+		int materialIndex = -1;
+		if (matId >= 0)
+		{
+			auto findResult = m_fbxMaterialIndices.find(pMesh->GetNode()->GetMaterial(matId));
+			if (findResult != m_fbxMaterialIndices.end())
+			{
+				materialIndex = findResult->second;
+			}
+		}
+
+		//삼각형 분할은 폴리곤 첫 정점 기준 fan으로 인덱스만 추가
+		IndexBufferFormat firstVertex = static_cast<IndexBufferFormat>(vertexId);
+		for (int i = 0; i < polygonSize - 2; ++i)
+		{
+			streams.TriangleIndices.push_back(firstVertex);
+			streams.TriangleIndices.push_back(firstVertex + i + 1);
+			streams.TriangleIndices.push_back(firstVertex + i + 2);
+		}
 
 		for (int i = 0; i < polygonSize; i++)
 		{
-			SubMeshVertex vInfo;
+			XMFLOAT3 position;
+			XMFLOAT3 normal = { 0.0f,0.0f,0.0f };
+			XMFLOAT2 texC = { 0.0f,0.0f };
 			int controlPointIndex = pMesh->GetPolygonVertex(polygonIndex, i);
 			FbxVector4 verPos = controlPoints[controlPointIndex];
 			verPos = transform.MultT(verPos);
 
-			vInfo.Position.x = (float)verPos[0];
-			vInfo.Position.y = (float)verPos[1];
-			vInfo.Position.z = (float)verPos[2];
-
-			std::vector<BlendingIndexWeightPair>& boneWeights = controlPointboneWeights[controlPointIndex].BlendingInfo;
-			vInfo.BoneWeights.insert(vInfo.BoneWeights.begin(), boneWeights.begin(), boneWeights.end());
+			position.x = (float)verPos[0];
+			position.y = (float)verPos[1];
+			position.z = (float)verPos[2];
 
 			//for (int elementIndex = 0; elementIndex < pMesh->GetElementVertexColorCount(); ++elementIndex)
 			//{
@@ -348,7 +424,7 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 			//	}
 			//}
 
-			// Get UV / FBX UVǥ 1и
+			// Get UV / FBX UV좌표는 1사분면
 			for (int elementIndex = 0; elementIndex < pMesh->GetElementUVCount(); ++elementIndex)
 			{
 				FbxGeometryElementUV* eVerUV = pMesh->GetElementUV(elementIndex);
@@ -365,16 +441,16 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 
 						int UVIndex = controlPointIndex;
 						FbxVector2 UV = eVerUV->GetDirectArray().GetAt(UVIndex);
-						vInfo.TexC.x = (float)UV[0];
-						vInfo.TexC.y = 1 - (float)UV[1];
+						texC.x = (float)UV[0];
+						texC.y = 1 - (float)UV[1];
 						break;
 					}
 					case FbxGeometryElement::eIndexToDirect:
 					{
 						int UVIndex = eVerUV->GetIndexArray().GetAt(controlPointIndex);
 						FbxVector2 UV = eVerUV->GetDirectArray().GetAt(UVIndex);
-						vInfo.TexC.x = (float)UV[0];
-						vInfo.TexC.y = 1 - (float)UV[1];
+						texC.x = (float)UV[0];
+						texC.y = 1 - (float)UV[1];
 						break;
 					}
 					default:
@@ -392,8 +468,8 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 					{
 						int UVIndex = textureUVIndex;
 						FbxVector2 UV = eVerUV->GetDirectArray().GetAt(UVIndex);
-						vInfo.TexC.x = (float)UV[0];
-						vInfo.TexC.y = 1 - (float)UV[1];
+						texC.x = (float)UV[0];
+						texC.y = 1 - (float)UV[1];
 						break;
 					}
 					default:
@@ -420,18 +496,18 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 					{
 						int NormalIndex = vertexId;
 						FbxVector4 Normal = eVerNormal->GetDirectArray().GetAt(NormalIndex);
-						vInfo.Normal.x = (float)Normal[0];
-						vInfo.Normal.y = (float)Normal[1];
-						vInfo.Normal.z = (float)Normal[2];
+						normal.x = (float)Normal[0];
+						normal.y = (float)Normal[1];
+						normal.z = (float)Normal[2];
 						break;
 					}
 					case FbxGeometryElement::eIndexToDirect:
 					{
 						int NormalIndex = eVerNormal->GetIndexArray().GetAt(vertexId);
 						FbxVector4 Normal = eVerNormal->GetDirectArray().GetAt(NormalIndex);
-						vInfo.Normal.x = (float)Normal[0];
-						vInfo.Normal.y = (float)Normal[1];
-						vInfo.Normal.z = (float)Normal[2];
+						normal.x = (float)Normal[0];
+						normal.y = (float)Normal[1];
+						normal.z = (float)Normal[2];
 						break;
 					}
 					default:
@@ -480,78 +556,68 @@ void FbxModelScene::ProcessPolygons(FbxMesh* pMesh)
 			//	}
 			//}
 
-			int matId = -1;
-			if (isAllSame)
-			{
-				FbxGeometryElementMaterial* materialElement = pMesh->GetElementMaterial(0);
-				matId = materialElement->GetIndexArray().GetAt(0);
-			}
-			else
-			{
-				for (int elementalMaterialIndex = 0; elementalMaterialIndex < pMesh->GetElementMaterialCount(); ++elementalMaterialIndex)
-				{
-					FbxGeometryElementMaterial* materialElement = pMesh->GetElementMaterial(elementalMaterialIndex);
-					matId = materialElement->GetIndexArray().GetAt(polygonIndex);
-				}
-			}
-			if (matId >= 0)
-			{
-				FbxSurfaceMaterial* surfaceMaterial = pMesh->GetNode()->GetMaterial(matId);
-				vInfo.MaterialName = surfaceMaterial->GetName();
-			}
+			streams.Positions.push_back(position);
+			streams.Normals.push_back(normal);
+			streams.TexCoords.push_back(texC);
+			streams.MaterialIndices.push_back(materialIndex);
+			streams.ControlPointIndices.push_back(controlPointIndex);
 
 			vertexId++;
-			newPolygon.Vertices.push_back(std::move(vInfo));
 		}
-		polygonArray.push_back(std::move(newPolygon));
 	}
 
-	vertexInfoArray.reserve(polygonArray.size() * 3);
-	for (auto& element : polygonArray)
-	{
-		std::vector<TempPolygon> trianglePolygons;
-		Triangulate(element, trianglePolygons);
+	//겹치는 정점 최적화
+	std::vector<SubMeshVertex>& vertexTable = meshData.VertexTable;
+
+	VertexDedupeTable dedupeTable(streams.Positions.size());
+	std::vector<IndexBufferFormat>& tempIndexTable = meshData.IndexTable;
+	tempIndexTable.reserve(streams.TriangleIndices.size());
 
-		for (auto& triPolygon : trianglePolygons)
+	for (IndexBufferFormat streamIndex : streams.TriangleIndices)
+	{
+		auto [index, isNew] = dedupeTable.Insert(CreateVertexKey(streams, streamIndex));
+		if (isNew)
 		{
-			vertexInfoArray.push_back(triPolygon.Vertices.at(0));
-			vertexInfoArray.push_back(triPolygon.Vertices.at(1));
-			vertexInfoArray.push_back(triPolygon.Vertices.at(2));
+			SubMeshVertex vertex;
+			vertex.Position = streams.Positions[streamIndex];
+			vertex.Normal = streams.Normals[streamIndex];
+			vertex.TexC = streams.TexCoords[streamIndex];
+			vertex.MaterialIndex = streams.MaterialIndices[streamIndex];
+			if (vertex.MaterialIndex >= 0)
+			{
+				vertex.MaterialName = m_fbxMaterials[vertex.MaterialIndex]->GetName();
+			}
+			vertex.SkinIndex = streams.ControlPointIndices[streamIndex];
+
+			vertexTable.push_back(std::move(vertex));
 		}
+		tempIndexTable.push_back(index);
 	}
+}
 
-	//ġ  ȭ
-
-	std::unordered_map<SubMeshVertex, IndexBufferFormat> hashMap;
-	std::vector<IndexBufferFormat> tempIndexTable;
-	tempIndexTable.reserve(vertexInfoArray.size());
+void FbxModelScene::MergeMeshPolygons(MeshPolygonData& meshData)
+{
+	IndexBufferFormat offset = static_cast<IndexBufferFormat>(m_vertexTable.size());
+	uint32_t skinOffset = static_cast<uint32_t>(m_skinWeights.size());
 
-	int indexTableElement = 0;
-	for (auto& vInfo : vertexInfoArray)
+	m_skinWeights.insert(m_skinWeights.end(), meshData.SkinWeights.begin(), meshData.SkinWeights.end());
+	for (auto& vertex : meshData.VertexTable)
 	{
-		auto findResult = hashMap.find(vInfo);
-
-		if (findResult == hashMap.end())
-		{
-			hashMap[vInfo] = m_vertexTable.size();
-			indexTableElement = m_vertexTable.size();
-			m_vertexTable.push_back(vInfo);
-		}
-		else
-		{
-			indexTableElement = findResult->second;
-		}
-		tempIndexTable.push_back(indexTableElement);
+		vertex.SkinIndex += skinOffset;
 	}
 
-
-	//׸  и
-	for (auto& tempIndex : tempIndexTable)
+	//마테리얼 별로 분리
+	for (auto& tempIndex : meshData.IndexTable)
 	{
-		string matName = m_vertexTable.at(tempIndex).MaterialName;
+		const string& matName = meshData.VertexTable.at(tempIndex).MaterialName;
 
-		m_subMeshes[matName].push_back(tempIndex);
+		m_subMeshes[matName].push_back(tempIndex + offset);
 	}
+
+	m_vertexTable.insert(m_vertexTable.end(),
+		std::make_move_iterator(meshData.VertexTable.begin()),
+		std::make_move_iterator(meshData.VertexTable.end()));
+	meshData.VertexTable.clear();
 }
 
 void FbxModelScene::ProcessSkeletonHierachy(FbxNode* pRootNode)
@@ -559,11 +625,12 @@ void FbxModelScene::ProcessSkeletonHierachy(FbxNode* pRootNode)
 	for (int childIndex = 0; childIndex < pRootNode->GetChildCount(); ++childIndex)
 	{
 		FbxNode* childNode = pRootNode->GetChild(childIndex);
-		ProcessSkeletonHierachyRecursively(childNode, 0, 0, -1);
+		ProcessSkeletonHierachyRecursively(childNode, 0, -1);
 	}
 }
 
-void FbxModelScene::ProcessSkeletonHierachyRecursively(FbxNode* pNode, int depth, int index, int parentIndex)
+//조인트는 부모가 항상 먼저 오도록 추가됨, 스켈레톤이 아닌 노드는 건너뛰고 가장 가까운 조인트가 부모
+void FbxModelScene::ProcessSkeletonHierachyRecursively(FbxNode* pNode, int depth, int parentIndex)
 {
 	if (pNode->GetNodeAttribute() && pNode->GetNodeAttribute()->GetAttributeType() == FbxNodeAttribute::eSkeleton)
 	{
@@ -571,27 +638,29 @@ void FbxModelScene::ProcessSkeletonHierachyRecursively(FbxNode* pNode, int depth
 		currJoint.ParentIndex = parentIndex;
 		currJoint.Name = pNode->GetName();
 		currJoint.Depth = depth++;
+		currJoint.Node = pNode;
 		m_skeleton.Joints.push_back(currJoint);
+
+		parentIndex = static_cast<int>(m_skeleton.Joints.size()) - 1;
 	}
 
 	for (int i = 0; i < pNode->GetChildCount(); i++)
 	{
-		ProcessSkeletonHierachyRecursively(pNode->GetChild(i), depth, m_skeleton.Joints.size(), index);
+		ProcessSkeletonHierachyRecursively(pNode->GetChild(i), depth, parentIndex);
 	}
 }
 
-void FbxModelScene::ProcessJointsAndAnimations(FbxNode* pNode, std::vector<ControlPoint>& controlPoints)
+void FbxModelScene::ProcessJointsAndAnimations(FbxNode* pNode, std::vector<SkinWeight>& skinWeights)
 {
 	FbxMesh* currMesh = pNode->GetMesh();
-	controlPoints.clear();
-	controlPoints.resize(currMesh->GetControlPointsCount());
+	SkinWeightTableBuilder skinWeightBuilder(currMesh->GetControlPointsCount());
 
 	FbxAMatrix geometryTransform = FbxUtil::GetGeometryTransformation(pNode);
 	size_t numOfDeformers = currMesh->GetDeformerCount();
 
 	for (size_t deformerIndex = 0; deformerIndex < numOfDeformers; ++deformerIndex)
 	{
-		//skin ó
+		//skin만 처리
 		FbxSkin* currSkin = reinterpret_cast<FbxSkin*>(currMesh->GetDeformer(deformerIndex, FbxDeformer::eSkin));
 
 		if (!currSkin) { continue; }
@@ -606,7 +675,7 @@ void FbxModelScene::ProcessJointsAndAnimations(FbxNode* pNode, std::vector<Contr
 			FbxAMatrix transformMatrix;
 			FbxAMatrix transformLinkMatrix;
 
-			//Get matrix associated with the node containing the link. κǰ ׵
+			//Get matrix associated with the node containing the link. 대부분의경우 항등행렬
 			currCluster->GetTransformMatrix(transformMatrix);
 
 			// The transformation of the mesh at binding time 
@@ -622,60 +691,247 @@ void FbxModelScene::ProcessJointsAndAnimations(FbxNode* pNode, std::vector<Contr
 
 			// Associate each joint with the control points it affects 
 			size_t numOfIndices = currCluster->GetControlPointIndicesCount();
+			int* controlPointIndices = currCluster->GetControlPointIndices();
+			double* controlPointWeights = currCluster->GetControlPointWeights();
 			for (size_t i = 0; i < numOfIndices; ++i)
 			{
-				BlendingIndexWeightPair currBlendingIndexWeightPair;
-				currBlendingIndexWeightPair.BlendingIndex = currJointIndex;
-				currBlendingIndexWeightPair.BlendingWeight = currCluster->GetControlPointWeights()[i];
+				skinWeightBuilder.Add(static_cast<uint32_t>(controlPointIndices[i]), static_cast<uint32_t>(currJointIndex), static_cast<float>(controlPointWeights[i]));
+			}
 
-				controlPoints[currCluster->GetControlPointIndices()[i]].BlendingInfo.push_back(currBlendingIndexWeightPair);
+			//애니메이션은 BakeAnimations에서 조인트마다 한번만 구움
+			JointBakeSource& bakeSource = m_jointBakeSources[currJointIndex];
+			if (bakeSource.Link == nullptr)
+			{
+				bakeSource.MeshNode = pNode;
+				bakeSource.GeometryTransform = geometryTransform;
+				bakeSource.Link = currCluster->GetLink();
 			}
+		}
+	}
 
-			int animStackCount = m_scene->GetSrcObjectCount<FbxAnimStack>();
+	skinWeights = skinWeightBuilder.Build();
+}
 
-			for (int i = 0; i < animStackCount; ++i)
-			{
-				FbxAnimStack* currAnimStack = m_scene->GetSrcObject<FbxAnimStack>(i);
-				FbxString animStackName = currAnimStack->GetName();
+void FbxModelScene::BakeAnimations()
+{
+	struct JointBakeTarget
+	{
+		size_t JointIndex;
+		//-1이면 기준 메쉬에 대한 변환
+		int ParentNodeIndex;
+		int LinkNodeIndex;
+	};
+
+	struct StackBakeJob
+	{
+		FbxAnimStack* Stack = nullptr;
+		AnimationClip* Clip = nullptr;
+		FbxLongLong StartFrame = 0;
+		FbxLongLong FrameCount = 0;
+		//비어있으면 Evaluator로 순서대로 처리
+		std::vector<FbxNodeTransformTrack> Tracks;
+		//targets 순서, 압축전 프레임별 로컬변환
+		std::vector<std::vector<AffineMatrix>> Frames;
+	};
+
+	//루트 조인트는 처음 스킨된 메쉬를 기준으로 구움 (바인드포즈 역행렬과 같은 공간)
+	auto reference = std::find_if(m_jointBakeSources.begin(), m_jointBakeSources.end(),
+		[](const JointBakeSource& bakeSource) { return bakeSource.Link != nullptr; });
+	if (reference == m_jointBakeSources.end())
+	{
+		return;
+	}
 
-				string clipName = animStackName.Buffer();
+	//굽는 조인트, 메쉬노드와 그 부모노드들 (부모가 먼저 오도록)
+	std::vector<FbxNode*> bakeNodes;
+	std::vector<int> parentIndices;
+	std::unordered_map<FbxNode*, int> bakeNodeIndices;
 
-				AnimationClip& animClip = m_animations[clipName];
-				animClip.Name = clipName;
-				animClip.BoneAnimations.resize(m_skeleton.Joints.size());
-				animClip.BoneAnimations[currJointIndex].Joint = m_skeleton.Joints[currJointIndex];
+	std::function<int(FbxNode*)> addBakeNode = [&](FbxNode* pNode) -> int
+	{
+		if (pNode == nullptr)
+		{
+			return -1;
+		}
 
-				FbxTakeInfo* takeInfo = m_scene->GetTakeInfo(animStackName);
-				FbxTime start = takeInfo->mLocalTimeSpan.GetStart();
-				FbxTime end = takeInfo->mLocalTimeSpan.GetStop();
+		auto findResult = bakeNodeIndices.find(pNode);
+		if (findResult != bakeNodeIndices.end())
+		{
+			return findResult->second;
+		}
 
-				for (FbxLongLong i = start.GetFrameCount(FbxTime::eFrames24); i <= end.GetFrameCount(FbxTime::eFrames24); ++i)
-				{
-					Keyframe currFrame;
-					FbxTime currTime;
-					currTime.SetFrame(i, FbxTime::eFrames24);
-					currFrame.FrameNum = i;
+		int parentIndex = addBakeNode(pNode->GetParent());
+		int index = static_cast<int>(bakeNodes.size());
+		bakeNodes.push_back(pNode);
+		parentIndices.push_back(parentIndex);
+		bakeNodeIndices.emplace(pNode, index);
+		return index;
+	};
 
-					FbxAMatrix currentTransformOffset = pNode->EvaluateGlobalTransform(currTime) * geometryTransform;
-					currFrame.GlobalTransform = currentTransformOffset.Inverse() * currCluster->GetLink()->EvaluateGlobalTransform(currTime);
-					currFrame.Transform = FbxUtil::ConvertToAffineMatrix(currFrame.GlobalTransform);
+	int referenceNodeIndex = addBakeNode(reference->MeshNode);
+	FbxAMatrix referenceGeometryTransform = reference->GeometryTransform;
 
-					animClip.BoneAnimations[currJointIndex].keyFrames.push_back(std::move(currFrame));
-				}
+	//조인트마다 부모 조인트 기준 로컬변환
+	std::vector<JointBakeTarget> targets;
+	for (size_t jointIndex = 0; jointIndex < m_skeleton.Joints.size(); ++jointIndex)
+	{
+		const Joint& joint = m_skeleton.Joints[jointIndex];
+		if (joint.Node == nullptr)
+		{
+			continue;
+		}
+
+		FbxNode* parentNode = joint.ParentIndex >= 0 ? m_skeleton.Joints[joint.ParentIndex].Node : nullptr;
+
+		JointBakeTarget target;
+		target.JointIndex = jointIndex;
+		target.ParentNodeIndex = addBakeNode(parentNode);
+		target.LinkNodeIndex = addBakeNode(joint.Node);
+		targets.push_back(target);
+	}
+
+	bool isTrackSupported = std::all_of(bakeNodes.begin(), bakeNodes.end(), FbxNodeTransformTrack::IsSupported);
+
+	//Scene을 읽는 준비작업은 순서대로 처리
+	std::vector<StackBakeJob> jobs;
+	int animStackCount = m_scene->GetSrcObjectCount<FbxAnimStack>();
+	for (int i = 0; i < animStackCount; ++i)
+	{
+		FbxAnimStack* currAnimStack = m_scene->GetSrcObject<FbxAnimStack>(i);
+		FbxString animStackName = currAnimStack->GetName();
+
+		string clipName = animStackName.Buffer();
+
+		FbxTakeInfo* takeInfo = m_scene->GetTakeInfo(animStackName);
+		if (takeInfo == nullptr || m_animations.find(clipName) != m_animations.end())
+		{
+			continue;
+		}
+
+		FbxTime start = takeInfo->mLocalTimeSpan.GetStart();
+		FbxTime end = takeInfo->mLocalTimeSpan.GetStop();
+
+		StackBakeJob job;
+		job.Stack = currAnimStack;
+		job.StartFrame = start.GetFrameCount(FbxTime::eFrames24);
+		job.FrameCount = (std::max)<FbxLongLong>(0, end.GetFrameCount(FbxTime::eFrames24) - job.StartFrame + 1);
+
+		AnimationClip& animClip = m_animations[clipName];
+		animClip.Name = clipName;
+		animClip.BoneAnimations.resize(m_skeleton.Joints.size());
+		for (size_t jointIndex = 0; jointIndex < m_skeleton.Joints.size(); ++jointIndex)
+		{
+			animClip.BoneAnimations[jointIndex].Joint = m_skeleton.Joints[jointIndex];
+		}
+		job.Clip = &animClip;
+		job.Frames.resize(targets.size(), std::vector<AffineMatrix>(static_cast<size_t>(job.FrameCount)));
+
+		//레이어 블렌딩은 직접 계산하지 않음
+		if (isTrackSupported && currAnimStack->GetMemberCount<FbxAnimLayer>() <= 1)
+		{
+			FbxAnimLayer* layer = currAnimStack->GetMember<FbxAnimLayer>(0);
+			job.Tracks.reserve(bakeNodes.size());
+			for (FbxNode* bakeNode : bakeNodes)
+			{
+				job.Tracks.emplace_back(bakeNode, layer);
 			}
 		}
+
+		jobs.push_back(std::move(job));
 	}
 
+	//한 프레임의 노드 전역변환으로 조인트 로컬변환 기록
+	auto writeKeyframes = [&](StackBakeJob& job, size_t keyIndex, const std::vector<FbxAMatrix>& globalTransforms)
+	{
+		FbxAMatrix referenceTransform = globalTransforms[referenceNodeIndex] * referenceGeometryTransform;
+		for (size_t targetIndex = 0; targetIndex < targets.size(); ++targetIndex)
+		{
+			const JointBakeTarget& target = targets[targetIndex];
+			const FbxAMatrix& parentTransform = target.ParentNodeIndex >= 0 ? globalTransforms[target.ParentNodeIndex] : referenceTransform;
+
+			FbxAMatrix localTransform = parentTransform.Inverse() * globalTransforms[target.LinkNodeIndex];
+			job.Frames[targetIndex][keyIndex] = FbxUtil::ConvertToAffineMatrix(localTransform);
+		}
+	};
+
+	//클립 하나는 한 작업에서만 압축하므로 통계도 그대로 기록
+	AnimationCompressionSettings compressionSettings;
+	auto compressJob = [&targets, &compressionSettings](StackBakeJob& job)
+	{
+		AnimationClip& animClip = *job.Clip;
+		for (size_t targetIndex = 0; targetIndex < targets.size(); ++targetIndex)
+		{
+			BoneAnimation& boneAnimation = animClip.BoneAnimations[targets[targetIndex].JointIndex];
+			boneAnimation.Track = AnimationCompressor::Compress(job.Frames[targetIndex], compressionSettings, animClip.CompressionStats);
+		}
+		job.Frames.clear();
+		job.Frames.shrink_to_fit();
+	};
+
+	//커브로 직접 계산하는 스택은 워커쓰레드에 나눠서 처리
+	//프레임마다 노드별 전역변환을 한번만 계산
+	ThreadManager::GetInstance().ParallelFor(jobs.size(), [&](size_t jobIndex)
+		{
+			StackBakeJob& job = jobs[jobIndex];
+			if (job.Tracks.empty())
+			{
+				return;
+			}
+
+			std::vector<FbxAMatrix> globalTransforms(bakeNodes.size());
+			std::vector<int> cursors(bakeNodes.size() * FbxNodeTransformTrack::ChannelCount, 0);
+
+			for (FbxLongLong keyIndex = 0; keyIndex < job.FrameCount; ++keyIndex)
+			{
+				FbxTime currTime;
+				currTime.SetFrame(job.StartFrame + keyIndex, FbxTime::eFrames24);
+
+				for (size_t nodeIndex = 0; nodeIndex < bakeNodes.size(); ++nodeIndex)
+				{
+					FbxAMatrix localTransform = job.Tracks[nodeIndex].EvaluateLocalTransform(currTime, &cursors[nodeIndex * FbxNodeTransformTrack::ChannelCount]);
+					int parentIndex = parentIndices[nodeIndex];
+					globalTransforms[nodeIndex] = parentIndex >= 0 ? globalTransforms[parentIndex] * localTransform : localTransform;
+				}
+
+				writeKeyframes(job, static_cast<size_t>(keyIndex), globalTransforms);
+			}
+
+			compressJob(job);
+		});
 
-	//bone weight  4 ƴҼ ְ, weight  1 ƴҼִ
-	BlendingIndexWeightPair currBlendIndexWeightPair;
-	for (auto iter = controlPoints.begin(); iter != controlPoints.end(); ++iter)
+	//나머지는 Evaluator로 처리, Evaluator는 현재 스택 기준이므로 순서대로
+	std::vector<FbxAMatrix> globalTransforms(bakeNodes.size());
+	for (StackBakeJob& job : jobs)
 	{
-		for (size_t i = iter->BlendingInfo.size(); i < 4; ++i)
+		if (job.Tracks.empty() == false)
 		{
-			iter->BlendingInfo.push_back(currBlendIndexWeightPair);
+			continue;
+		}
+
+		m_scene->SetCurrentAnimationStack(job.Stack);
+		for (FbxLongLong keyIndex = 0; keyIndex < job.FrameCount; ++keyIndex)
+		{
+			FbxTime currTime;
+			currTime.SetFrame(job.StartFrame + keyIndex, FbxTime::eFrames24);
+
+			for (size_t nodeIndex = 0; nodeIndex < bakeNodes.size(); ++nodeIndex)
+			{
+				globalTransforms[nodeIndex] = bakeNodes[nodeIndex]->EvaluateGlobalTransform(currTime);
+			}
+
+			writeKeyframes(job, static_cast<size_t>(keyIndex), globalTransforms);
 		}
 	}
+
+	//Evaluator로 구운 스택 압축
+	ThreadManager::GetInstance().ParallelFor(jobs.size(), [&](size_t jobIndex)
+		{
+			StackBakeJob& job = jobs[jobIndex];
+			if (job.Tracks.empty())
+			{
+				compressJob(job);
+			}
+		});
 }
 
 size_t FbxModelScene::FindJointIndexUsingName(const std::string& jointName)
@@ -8,27 +8,10 @@
 #include "FbxUtil.h"
 #include <map>
 #include "MeshResources.h"
+#include "VertexDedupeTable.h"
 
 
-namespace std
-{
-	//ؽʿ ؽԼ
-	template<>
-	struct hash<SubMeshVertex>
-	{
-		std::size_t operator()(const SubMeshVertex& vertex) const
-		{
-			return (hash<float>()(vertex.Position.x) ^
-				hash<float>()(vertex.Position.y) ^
-				hash<float>()(vertex.Position.z) ^
-				hash<string>()(vertex.MaterialName) ^
-				hash<float>()(vertex.TexC.x) ^
-				hash<float>()(vertex.TexC.y));
-		}
-	};
-}
-
-// FBX  UTF8 
+// FBX는 내부적으로 UTF8을 사용함
 class FbxModelScene
 {
 public:
@@ -36,25 +19,28 @@ public:
 	~FbxModelScene();
 
 	std::string GetName() { return m_name; }
-	std::shared_ptr<MeshResources> CreateMeshResource();
+	//false면 파일을 읽지 못해 빈 모델임
+	bool IsLoaded() const { return m_isLoaded; }
+	MeshResourcesInfo CreateMeshResourcesInfo();
 	std::unordered_map<std::string, AnimationClip>& GetAnimationClips() { return m_animations; }
 private:
 	bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename);
-	void ProcessNode(FbxNode* pNode);
+	void ProcessNode(FbxNode* pNode, std::vector<FbxNode*>& meshNodes);
 	void ProcessScene(FbxScene* pScene);
-	void LoadMesh(FbxNode* pNode);
+	bool LoadMesh(FbxNode* pNode, MeshPolygonData& meshData);
+	void LoadMeshes(const std::vector<FbxNode*>& meshNodes);
 	void RenameDuplicatedMaterial(FbxScene* pScene);
 	void ProcessMaterialTable(FbxScene* pScene);
-	void ProcessPolygons(FbxMesh* pMesh);
+	void ProcessPolygons(MeshPolygonData& meshData);
+	void MergeMeshPolygons(MeshPolygonData& meshData);
 	void ProcessSkeletonHierachy(FbxNode* pRootNode);
-	void ProcessSkeletonHierachyRecursively(FbxNode* pNode, int depth, int index, int parentIndex);
-	void ProcessJointsAndAnimations(FbxNode* pNode, std::vector<ControlPoint>& controlPoints);
+	void ProcessSkeletonHierachyRecursively(FbxNode* pNode, int depth, int parentIndex);
+	void ProcessJointsAndAnimations(FbxNode* pNode, std::vector<SkinWeight>& skinWeights);
+	void BakeAnimations();
 	size_t FindJointIndexUsingName(const std::string& jointName);
 	FbxSurfaceMaterial* FindFbxMaterial(std::string UTF8MaterialName);
 
 
-	void Triangulate(TempPolygon& polygon, std::vector<TempPolygon>& Output);
-
 private:
 	FbxScene* m_scene;
 	FbxManager* m_manager;
@@ -65,15 +51,22 @@ private:
 	std::map<FbxFileTexture*, std::string> m_allFbxFileTexture;
 
 	std::vector<FbxSurfaceMaterial*> m_fbxMaterials;
+	//fbxMaterial -> m_fbxMaterials 인덱스
+	std::unordered_map<FbxSurfaceMaterial*, int> m_fbxMaterialIndices;
 
 	std::vector<SubMeshVertex> m_vertexTable;
+	//모든 메쉬의 SkinWeight, SubMeshVertex::SkinIndex로 참조
+	std::vector<SkinWeight> m_skinWeights;
 	std::map<std::string, IndexTableType> m_subMeshes;
 
 	std::string m_name;
 
-	FbxAnimEvaluator* m_sceneEvaluator;
+	FbxAnimEvaluator* m_sceneEvaluator = nullptr;
+	bool m_isLoaded = false;
 
 	Skeleton m_skeleton;
+	//조인트 인덱스 -> 굽는데 사용할 클러스터 정보, Link가 nullptr이면 참조한 메쉬가 없음
+	std::vector<JointBakeSource> m_jointBakeSources;
 
 	std::unordered_map<std::string, AnimationClip> m_animations;
 };
@@ -227,41 +227,150 @@ PBRMaterial MaterialConverter::ToPBRMaterial(FbxSurfaceMaterial* fbxMaterial)
 	return pbrMaterial;
 }
 
-Vertex VertexConverter::ConvertFromSubMeshVertex(SubMeshVertex subMeshVertex)
+Vertex VertexConverter::ConvertFromSubMeshVertex(const SubMeshVertex& subMeshVertex, const SkinWeight& skinWeight)
 {
 	Vertex vertex;
 	vertex.Pos = subMeshVertex.Position;
 	vertex.Normal = subMeshVertex.Normal;
 	vertex.TexC = subMeshVertex.TexC;
+	vertex.BoneIndices = skinWeight.BoneIndices;
+	vertex.BoneWeights = skinWeight.BoneWeights;
 
-	std::vector<BlendingIndexWeightPair>& boneWeightPairs = subMeshVertex.BoneWeights;
-	sort(boneWeightPairs.begin(), boneWeightPairs.end(), [](const BlendingIndexWeightPair& w1, const BlendingIndexWeightPair& w2) {return w1.BlendingWeight > w2.BlendingWeight; });
+	return vertex;
+}
 
-	if (subMeshVertex.BoneWeights.size() >= 4)
+void SkinWeightTableBuilder::Add(uint32_t controlPointIndex, uint32_t jointIndex, float weight)
+{
+	if (controlPointIndex >= m_controlPointCount)
 	{
-		vertex.BoneIndices.x = boneWeightPairs.at(0).BlendingIndex;
-		vertex.BoneIndices.y = boneWeightPairs.at(1).BlendingIndex;
-		vertex.BoneIndices.z = boneWeightPairs.at(2).BlendingIndex;
-		vertex.BoneIndices.w = boneWeightPairs.at(3).BlendingIndex;
-
-		vertex.BoneWeights.x = boneWeightPairs.at(0).BlendingWeight;
-		vertex.BoneWeights.y = boneWeightPairs.at(1).BlendingWeight;
-		vertex.BoneWeights.z = boneWeightPairs.at(2).BlendingWeight;
-		vertex.BoneWeights.w = boneWeightPairs.at(3).BlendingWeight;
-
-		float sumOfWeights = 0;
-		sumOfWeights += vertex.BoneWeights.x;
-		sumOfWeights += vertex.BoneWeights.y;
-		sumOfWeights += vertex.BoneWeights.z;
-		sumOfWeights += vertex.BoneWeights.w;
-
-		vertex.BoneWeights.x /= sumOfWeights;
-		vertex.BoneWeights.y /= sumOfWeights;
-		vertex.BoneWeights.z /= sumOfWeights;
-		vertex.BoneWeights.w /= sumOfWeights;
+		return;
 	}
 
-	return vertex;
+	BlendingIndexWeightPair influence;
+	influence.BlendingIndex = jointIndex;
+	influence.BlendingWeight = weight;
+
+	m_controlPointIndices.push_back(controlPointIndex);
+	m_influences.push_back(influence);
+}
+
+std::vector<SkinWeight> SkinWeightTableBuilder::Build() const
+{
+	//컨트롤포인트별 시작위치
+	std::vector<uint32_t> offsets(m_controlPointCount + 1, 0);
+	for (uint32_t controlPointIndex : m_controlPointIndices)
+	{
+		++offsets[controlPointIndex + 1];
+	}
+	for (size_t i = 0; i < m_controlPointCount; ++i)
+	{
+		offsets[i + 1] += offsets[i];
+	}
+
+	std::vector<BlendingIndexWeightPair> influences(m_influences.size());
+	std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < m_influences.size(); ++i)
+	{
+		influences[cursors[m_controlPointIndices[i]]++] = m_influences[i];
+	}
+
+	//bone weight의 개수는 4가 아닐수 있고, weight의 합은 1이 아닐수있다
+	std::vector<SkinWeight> result(m_controlPointCount);
+	for (size_t controlPointIndex = 0; controlPointIndex < m_controlPointCount; ++controlPointIndex)
+	{
+		auto begin = influences.begin() + offsets[controlPointIndex];
+		auto end = influences.begin() + offsets[controlPointIndex + 1];
+		size_t count = std::min<size_t>(end - begin, MaxInfluenceCount);
+
+		std::partial_sort(begin, begin + count, end, [](const BlendingIndexWeightPair& w1, const BlendingIndexWeightPair& w2) {return w1.BlendingWeight > w2.BlendingWeight; });
+
+		uint32_t indices[MaxInfluenceCount] = {};
+		float weights[MaxInfluenceCount] = {};
+		float sumOfWeights = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			indices[i] = (begin + i)->BlendingIndex;
+			weights[i] = (begin + i)->BlendingWeight;
+			sumOfWeights += weights[i];
+		}
+
+		if (sumOfWeights > 0.0f)
+		{
+			for (float& weight : weights)
+			{
+				weight /= sumOfWeights;
+			}
+		}
+
+		SkinWeight& skinWeight = result[controlPointIndex];
+		skinWeight.BoneIndices = XMUINT4(indices[0], indices[1], indices[2], indices[3]);
+		skinWeight.BoneWeights = XMFLOAT4(weights[0], weights[1], weights[2], weights[3]);
+	}
+
+	return result;
+}
+
+
+FbxNodeTransformTrack::FbxNodeTransformTrack(FbxNode* pNode, FbxAnimLayer* pLayer)
+{
+	FbxPropertyT<FbxDouble3>* properties[3] = { &pNode->LclTranslation, &pNode->LclRotation, &pNode->LclScaling };
+	const char* components[3] = { FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z };
+
+	for (int propertyIndex = 0; propertyIndex < 3; ++propertyIndex)
+	{
+		FbxDouble3 value = properties[propertyIndex]->Get();
+		for (int component = 0; component < 3; ++component)
+		{
+			int channel = propertyIndex * 3 + component;
+			m_values[channel] = value[component];
+			m_curves[channel] = pLayer != nullptr ? properties[propertyIndex]->GetCurve(pLayer, components[component]) : nullptr;
+		}
+	}
+
+	FbxVector4 preRotation;
+	FbxVector4 postRotation;
+	if (pNode->GetRotationActive())
+	{
+		pNode->GetRotationOrder(FbxNode::eSourcePivot, m_rotationOrder);
+		preRotation = pNode->GetPreRotation(FbxNode::eSourcePivot);
+		postRotation = pNode->GetPostRotation(FbxNode::eSourcePivot);
+	}
+
+	FbxAMatrix rotationOffset, rotationPivot, preRotationMatrix, postRotationMatrix;
+	FbxAMatrix scalingOffset, scalingPivot;
+	rotationOffset.SetT(pNode->GetRotationOffset(FbxNode::eSourcePivot));
+	rotationPivot.SetT(pNode->GetRotationPivot(FbxNode::eSourcePivot));
+	preRotationMatrix.SetR(preRotation);
+	postRotationMatrix.SetR(postRotation);
+	scalingOffset.SetT(pNode->GetScalingOffset(FbxNode::eSourcePivot));
+	scalingPivot.SetT(pNode->GetScalingPivot(FbxNode::eSourcePivot));
+
+	m_preRotation = rotationOffset * rotationPivot * preRotationMatrix;
+	m_postRotation = postRotationMatrix.Inverse() * rotationPivot.Inverse() * scalingOffset * scalingPivot;
+	m_postScaling = scalingPivot.Inverse();
+}
+
+FbxAMatrix FbxNodeTransformTrack::EvaluateLocalTransform(const FbxTime& time, int* cursors) const
+{
+	double values[ChannelCount];
+	for (int channel = 0; channel < ChannelCount; ++channel)
+	{
+		values[channel] = m_curves[channel] != nullptr ? m_curves[channel]->Evaluate(time, &cursors[channel]) : m_values[channel];
+	}
+
+	FbxAMatrix translation, rotation, scaling;
+	translation.SetT(FbxVector4(values[TranslationX], values[TranslationY], values[TranslationZ]));
+	FbxRotationOrder(m_rotationOrder).V2M(rotation, FbxVector4(values[RotationX], values[RotationY], values[RotationZ]));
+	scaling.SetS(FbxVector4(values[ScalingX], values[ScalingY], values[ScalingZ]));
+
+	return translation * m_preRotation * rotation * m_postRotation * scaling * m_postScaling;
+}
+
+bool FbxNodeTransformTrack::IsSupported(FbxNode* pNode)
+{
+	FbxTransform::EInheritType inheritType;
+	pNode->GetTransformationInheritType(inheritType);
+	return inheritType == FbxTransform::eInheritRSrs;
 }
 
 
@@ -299,54 +408,24 @@ bool IsFbx(std::wstring filePath)
 	return (FileUtil::GetFileExtension(filePath) == _TEXT(".fbx"));
 }
 
-void BoneAnimation::Interpolate(float time, DirectX::XMMATRIX& boneTransform) const
+void BoneAnimation::Interpolate(float time, DirectX::XMMATRIX& localTransform, BoneTrackCursor* cursor) const
 {
 	using namespace DirectX;
-	XMMATRIX globalBindposeInverse = Joint.GlobalBindposeInverseTransform.GetFinalTransformMatrix();
 
-	if (keyFrames.empty())
+	if (Track.FrameCount == 0)
 	{
-		boneTransform = globalBindposeInverse;
+		localTransform = XMMatrixIdentity();
 		return;
 	}
 
-	if (time < 0)
-	{
-
-		boneTransform = XMMatrixMultiply(globalBindposeInverse, keyFrames.front().Transform.GetFinalTransformMatrix());
-
-	}
-	else if (time > GetEndTime())
-	{
-
-		boneTransform = XMMatrixMultiply(globalBindposeInverse, keyFrames.back().Transform.GetFinalTransformMatrix());
-
-	}
-	else
-	{
-		float currentFrame = time * GetFramePerSecond();
-
-		for (size_t i = 0; i < keyFrames.size() - 1; ++i)
-		{
-			const int leftframe = i;
-			const int rightframe = i + 1;
-
-			if (currentFrame >= leftframe && currentFrame <= rightframe)
-			{
-				float lerpPercent = (currentFrame - leftframe);
-
-				const AffineMatrix& leftFrameTransform = keyFrames.at(leftframe).Transform;
-				const AffineMatrix& rightFrameTransform = keyFrames.at(rightframe).Transform;
+	//범위 밖은 처음/마지막 프레임으로 고정
+	float lastFrame = static_cast<float>(Track.FrameCount - 1);
+	float currentFrame = (std::max)(0.0f, (std::min)(time * GetFramePerSecond(), lastFrame));
 
-				XMVECTOR scale = XMVectorLerp(leftFrameTransform.Scale, rightFrameTransform.Scale, lerpPercent);
-				XMVECTOR translation = XMVectorLerp(leftFrameTransform.Translation, rightFrameTransform.Translation, lerpPercent);
-				XMVECTOR quarternion = XMQuaternionSlerp(leftFrameTransform.Quaternion, rightFrameTransform.Quaternion, lerpPercent);
+	XMVECTOR scale, quarternion, translation;
+	Track.Sample(currentFrame, scale, quarternion, translation, cursor);
 
-				boneTransform = XMMatrixMultiply(globalBindposeInverse, XMMatrixAffineTransformation(scale, XMVectorZero(), quarternion, translation));
-				break;
-			}
-		}
-	}
+	localTransform = XMMatrixAffineTransformation(scale, XMVectorZero(), quarternion, translation);
 }
 
 float BoneAnimation::GetFramePerSecond() const
@@ -365,20 +444,30 @@ float BoneAnimation::GetFramePerSecond() const
 	return framePerSecond;
 }
 
-void AnimationClip::Interpolate(float time, std::vector<DirectX::XMMATRIX>& boneTransforms) const
+void AnimationClip::Interpolate(float time, std::vector<DirectX::XMMATRIX>& boneTransforms, std::vector<BoneTrackCursor>* cursors) const
 {
 	boneTransforms.resize(BoneAnimations.size());
+	if (cursors != nullptr)
+	{
+		cursors->resize(BoneAnimations.size());
+	}
+
+	//조인트는 부모가 먼저 오므로 한번에 전역변환까지 계산
 	for (size_t i = 0; i < BoneAnimations.size(); ++i)
 	{
 		const BoneAnimation& boneAnimation = BoneAnimations.at(i);
-		if (boneAnimation.keyFrames.empty() == true)
-		{
-			boneTransforms.at(i) = boneTransforms.at(boneAnimation.Joint.ParentIndex);
-		}
-		else
-		{
-			boneAnimation.Interpolate(time, boneTransforms.at(i));
-		}
+
+		DirectX::XMMATRIX localTransform;
+		boneAnimation.Interpolate(time, localTransform, cursors ? &cursors->at(i) : nullptr);
+
+		int parentIndex = boneAnimation.Joint.ParentIndex;
+		boneTransforms.at(i) = parentIndex < 0 ? localTransform : DirectX::XMMatrixMultiply(localTransform, boneTransforms.at(parentIndex));
+	}
+
+	for (size_t i = 0; i < BoneAnimations.size(); ++i)
+	{
+		DirectX::XMMATRIX globalBindposeInverse = BoneAnimations.at(i).Joint.GlobalBindposeInverseTransform.GetFinalTransformMatrix();
+		boneTransforms.at(i) = DirectX::XMMatrixMultiply(globalBindposeInverse, boneTransforms.at(i));
 	}
 }
 
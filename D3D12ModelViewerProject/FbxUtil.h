@@ -13,12 +13,14 @@
 #include <map> 
 #include "D3DUtil.h" 
 #include "RenderTypes.h"
+#include "AnimationCompression.h"
 
-struct Keyframe;
-struct TempPolygon;
+struct MeshVertexStreams;
 struct BlendingIndexWeightPair;
 struct Skeleton;
-struct ControlPoint;
+struct SkinWeight;
+struct JointBakeSource;
+class FbxNodeTransformTrack;
 struct MeshMaterialConstants;
 struct MeshMaterial;
 struct SubMeshVertex;
@@ -26,14 +28,15 @@ class FbxUtil;
 class MaterialConverter;
 class VertexConverter;
 struct LayerRenderItems;
-struct TempPolygon;
-struct Keyframe;
 struct Joint;
+struct JointBounds;
 struct Skeleton;
 struct BlendingIndexWeightPair;
-struct ControlPoint;
+class SkinWeightTableBuilder;
+struct MeshPolygonData;
 struct BoneAnimation;
 struct AnimationClip;
+struct BakedAnimation;
 enum class KeyFrameModes;
 
 struct MeshMaterialConstants
@@ -52,8 +55,11 @@ struct SubMeshVertex
 	DirectX::XMFLOAT3 TangentU = { 0.0f,0.0f ,0.0f };
 	DirectX::XMFLOAT2 TexC = { 0.0f,0.0f };
 	std::string MaterialName;
+	//Scene 머티리얼 인덱스, 중복정점 검사에 사용
+	int MaterialIndex = -1;
 
-	std::vector<BlendingIndexWeightPair> BoneWeights;
+	//메쉬의 SkinWeight 테이블 인덱스 (컨트롤포인트)
+	uint32_t SkinIndex = 0;
 
 	bool operator==(const SubMeshVertex& rhs) const
 	{
@@ -166,21 +172,31 @@ private:
 class VertexConverter
 {
 public:
-	static Vertex ConvertFromSubMeshVertex(SubMeshVertex subMeshVertex);
+	static Vertex ConvertFromSubMeshVertex(const SubMeshVertex& subMeshVertex, const SkinWeight& skinWeight);
 };
 
-struct TempPolygon
+//Import중 폴리곤 정점(코너)별 데이터, 인덱스는 FbxMesh의 polygon vertex 순서
+struct MeshVertexStreams
 {
-	std::vector<SubMeshVertex> Vertices;
-	int Count = 3;
-};
+	std::vector<DirectX::XMFLOAT3> Positions;
+	std::vector<DirectX::XMFLOAT3> Normals;
+	std::vector<DirectX::XMFLOAT2> TexCoords;
+	std::vector<int> MaterialIndices;
+	std::vector<int> ControlPointIndices;
 
-struct Keyframe
-{
-	FbxLongLong FrameNum;
-	FbxAMatrix GlobalTransform;
+	//폴리곤을 fan 분할한 삼각형 인덱스
+	std::vector<IndexBufferFormat> TriangleIndices;
 
-	AffineMatrix Transform;
+	void Reserve(size_t vertexCount, size_t polygonCount)
+	{
+		Positions.reserve(vertexCount);
+		Normals.reserve(vertexCount);
+		TexCoords.reserve(vertexCount);
+		MaterialIndices.reserve(vertexCount);
+		ControlPointIndices.reserve(vertexCount);
+		//n각형 fan은 삼각형 n-2개, 점이나 선 폴리곤이 섞이면 음수가 될수있음
+		TriangleIndices.reserve(vertexCount > polygonCount * 2 ? (vertexCount - polygonCount * 2) * 3 : 0);
+	}
 };
 
 struct Joint
@@ -195,22 +211,104 @@ struct Joint
 	int Depth;
 };
 
+//본 하나가 영향을 주는 정점들의 바인드포즈 기준 바운딩박스
+struct JointBounds
+{
+	UINT JointIndex = 0;
+	DirectX::BoundingBox Bounds;
+};
+
 struct Skeleton
 {
 	std::string Name;
 	std::vector<Joint> Joints;
+	//영향을 주는 정점이 있는 본만, MeshResources에서 정점으로 만듦
+	std::vector<JointBounds> SkinnedJointBounds;
 };
 
 struct BlendingIndexWeightPair
 {
-	size_t BlendingIndex = 0;
-	double BlendingWeight = 0;
+	uint32_t BlendingIndex = 0;
+	float BlendingWeight = 0;
 };
 
+//컨트롤포인트 하나의 최종 가중치, 상위 4개를 골라 합이 1이 되도록 정규화됨
+struct SkinWeight
+{
+	DirectX::XMUINT4 BoneIndices = { 0,0,0,0 };
+	DirectX::XMFLOAT4 BoneWeights = { 0.0f,0.0f,0.0f,0.0f };
+};
 
-struct ControlPoint
+//클러스터를 돌면서 Add한 가중치를 컨트롤포인트별로 모아(CSR) SkinWeight 테이블을 만듬
+class SkinWeightTableBuilder
 {
-	std::vector<BlendingIndexWeightPair> BlendingInfo;
+public:
+	static constexpr size_t MaxInfluenceCount = 4;
+public:
+	SkinWeightTableBuilder(size_t controlPointCount) : m_controlPointCount(controlPointCount) {}
+
+	void Add(uint32_t controlPointIndex, uint32_t jointIndex, float weight);
+	std::vector<SkinWeight> Build() const;
+private:
+	size_t m_controlPointCount;
+
+	std::vector<uint32_t> m_controlPointIndices;
+	std::vector<BlendingIndexWeightPair> m_influences;
+};
+
+//메쉬 하나의 폴리곤 처리 입력과 결과, 워커쓰레드에서 채워짐
+struct MeshPolygonData
+{
+	FbxMesh* Mesh = nullptr;
+	FbxAMatrix Transform;
+	//컨트롤포인트 인덱스 -> SkinWeight
+	std::vector<SkinWeight> SkinWeights;
+
+	//인덱스는 메쉬 내부 기준, Merge할때 오프셋 더함
+	std::vector<SubMeshVertex> VertexTable;
+	std::vector<IndexBufferFormat> IndexTable;
+};
+
+//조인트 애니메이션을 굽는데 필요한 정보, 조인트를 처음 참조한 클러스터 기준
+struct JointBakeSource
+{
+	FbxNode* MeshNode = nullptr;
+	FbxAMatrix GeometryTransform;
+	FbxNode* Link = nullptr;
+};
+
+//애니메이션 레이어 하나에서 노드의 로컬변환을 커브로 직접 계산
+//T * Roff * Rp * Rpre * R * Rpost^-1 * Rp^-1 * Soff * Sp * S * Sp^-1
+//FbxAnimCurve::Evaluate만 사용하므로 스택별로 다른 쓰레드에서 계산할수 있음
+class FbxNodeTransformTrack
+{
+public:
+	enum Channel
+	{
+		TranslationX, TranslationY, TranslationZ,
+		RotationX, RotationY, RotationZ,
+		ScalingX, ScalingY, ScalingZ,
+		ChannelCount
+	};
+public:
+	FbxNodeTransformTrack(FbxNode* pNode, FbxAnimLayer* pLayer);
+
+	//cursors : 채널별 커브 검색 시작위치, 시간순으로 계산할때 재사용
+	FbxAMatrix EvaluateLocalTransform(const FbxTime& time, int* cursors) const;
+
+	//부모 행렬을 그대로 곱하는 상속방식(RSrs)만 직접 계산 가능
+	static bool IsSupported(FbxNode* pNode);
+private:
+	FbxAnimCurve* m_curves[ChannelCount] = {};
+	double m_values[ChannelCount] = {};
+	FbxEuler::EOrder m_rotationOrder = FbxEuler::eOrderXYZ;
+
+	//Roff * Rp * Rpre
+	FbxAMatrix m_preRotation;
+	//Rpost^-1 * Rp^-1 * Soff * Sp
+	FbxAMatrix m_postRotation;
+	//Sp^-1
+	FbxAMatrix m_postScaling;
 };
 
 enum class KeyFrameModes : int
@@ -222,16 +320,19 @@ struct BoneAnimation
 {
 public:
 	Joint Joint;
-	std::vector<Keyframe> keyFrames;
+	//부모 조인트 기준 로컬변환 (루트는 메쉬 기준), 프레임 0 = 스택 시작프레임
+	//FrameCount가 0이면 부모 변환을 따라감
+	CompressedBoneTrack Track;
 	KeyFrameModes FrameMode = KeyFrameModes::KeyFrame24;
 
-	void Interpolate(float time, DirectX::XMMATRIX& boneTransform) const;
+	//로컬변환, cursor : 같은 트랙을 연속으로 샘플링할때 키 검색 시작위치
+	void Interpolate(float time, DirectX::XMMATRIX& localTransform, BoneTrackCursor* cursor = nullptr) const;
 
 	float GetFramePerSecond() const;	
 
 	float GetEndTime() const
 	{
-		return keyFrames.size() / GetFramePerSecond();
+		return Track.FrameCount / GetFramePerSecond();
 	}
 };
 
@@ -240,8 +341,13 @@ struct AnimationClip
 	std::string Name;
 	//Joint
 	std::vector<BoneAnimation> BoneAnimations;
+	AnimationCompressionStats CompressionStats;
+	//임포트할때 구운 팔레트, 굽지 않았으면 nullptr
+	std::shared_ptr<const BakedAnimation> Baked;
 
-	void Interpolate(float time, std::vector<DirectX::XMMATRIX>& boneTransforms) const;
+	//로컬변환을 부모부터 누적한뒤 바인드포즈 역행렬을 곱한 스키닝 행렬
+	//cursors : BoneAnimations 크기로 맞춰짐
+	void Interpolate(float time, std::vector<DirectX::XMMATRIX>& boneTransforms, std::vector<BoneTrackCursor>* cursors = nullptr) const;
 
 	float GetEndTime() const;
 };
\ No newline at end of file
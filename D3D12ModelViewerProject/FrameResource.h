@@ -14,20 +14,68 @@ struct Vertex
 	DirectX::XMUINT4 BoneIndices;
 };
 
+enum class SkinningModes : UINT
+{
+	Linear = 0,
+	//스케일은 무시됨
+	DualQuaternion
+};
+
 struct ObjectConstants
 {
 	DirectX::XMFLOAT4X4 ObjectTransform = MathHelper::Identity4x4();
+	SkinningModes SkinningMode = SkinningModes::Linear;
 };
 
+//구운 클립을 쓰지 않는 인스턴스
+constexpr UINT BakedClipNone = 0xffffffff;
+
 struct InstanceConstants
 {
 	DirectX::XMFLOAT4X4 Transform = MathHelper::Identity4x4();
 	UINT numOfBones = 0;
+	//InstanceAnimations 버퍼에서 팔레트 시작 위치, 같은 포즈를 쓰는 인스턴스끼리 공유
+	UINT animationOffset = 0;
+	//BakedClipNone이 아니면 구운 클립에서 (TotalTime + bakedTimeOffset) 시간의 팔레트를 읽음
+	UINT bakedClipId = BakedClipNone;
+	float bakedTimeOffset = 0.0f;
+};
+
+//4x4 스키닝 행렬을 전치한 상위 3행, 마지막 행은 (0,0,0,1)
+struct BoneTransform3x4
+{
+	DirectX::XMFLOAT4 Rows[3] = {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f } };
+
+	//행벡터 기준 아핀 행렬을 전치해서 앞 3행만 저장
+	void Store(DirectX::FXMMATRIX boneTransform)
+	{
+		DirectX::XMMATRIX transposed = DirectX::XMMatrixTranspose(boneTransform);
+		DirectX::XMStoreFloat4(&Rows[0], transposed.r[0]);
+		DirectX::XMStoreFloat4(&Rows[1], transposed.r[1]);
+		DirectX::XMStoreFloat4(&Rows[2], transposed.r[2]);
+	}
+};
+
+//인스턴스 팔레트, 본마다 48byte
+using InstanceAnimations = BoneTransform3x4;
+
+//회전 + 이동 듀얼쿼터니언, 본마다 32byte
+struct DualQuaternionTransform
+{
+	DirectX::XMFLOAT4 Real = { 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT4 Dual = { 0.0f, 0.0f, 0.0f, 0.0f };
 };
 
-struct InstanceAnimations
+//구운 클립 정보, PaletteOffset : 구운 팔레트 버퍼에서 클립 시작 위치
+struct BakedClipInfo
 {
-	DirectX::XMFLOAT4X4 BoneTransform = MathHelper::Identity4x4();
+	UINT PaletteOffset = 0;
+	UINT FrameCount = 0;
+	float FramePerSecond = 0.0f;
+	UINT BoneCount = 0;
 };
 
 struct PassConstants
@@ -4,6 +4,8 @@
 #include "GameTimer.h"
 #include "FileDialog.h"
 #include "MeshObject.h"
+#include "MeshCache.h"
+#include "AnimationBaking.h"
 
 using namespace std;
 
@@ -13,13 +15,8 @@ ImportListControl::ImportListControl()
 }
 
 
-std::string ImportListControl::RegisterMeshResources(const std::string key, FbxModelScene* fbxmodel)
+std::string ImportListControl::RegisterMeshResources(const std::string key, MeshResourcesInfo& meshResourcesInfo)
 {
-	if (fbxmodel == nullptr)
-	{
-		return string();
-	}
-
 	auto meshResource = m_model.MeshResources.lock();
 	if (meshResource == nullptr)
 	{
@@ -35,7 +32,7 @@ std::string ImportListControl::RegisterMeshResources(const std::string key, FbxM
 		uniqueName = baseName + to_string(nameIndex++);
 	}
 
-	meshResource->emplace(uniqueName, fbxmodel->CreateMeshResource());
+	meshResource->emplace(uniqueName, make_shared<MeshResources>(meshResourcesInfo));
 
 	return uniqueName;
 }
@@ -61,7 +58,7 @@ void ImportListControl::RegisterMeshObject(const std::string name, MeshResources
 }
 
 
-std::string ImportListControl::RegisterAnimationClip(const std::string key, AnimationClip& animationClip)
+std::string ImportListControl::RegisterAnimationClip(const std::string key, std::shared_ptr<const AnimationClip> animationClip)
 {
 	auto animations = m_model.Animations.lock();
 	if (animations == nullptr)
@@ -83,7 +80,7 @@ std::string ImportListControl::RegisterAnimationClip(const std::string key, Anim
 }
 
 
-void ImportListControl::fbxImport(std::wstring filePath)
+void ImportListControl::fbxImport(std::wstring filePath, bool bakeAnimations)
 {
 	if (IsFbx(filePath) == false)
 	{
@@ -92,27 +89,59 @@ void ImportListControl::fbxImport(std::wstring filePath)
 	SetImportingState(true);
 
 	auto start = std::chrono::system_clock::now();
-	auto fbxModel = make_shared<FbxModelScene>(filePath);
+
+	//캐시가 유효하면 FbxModelScene을 만들지 않음
+	auto cacheData = make_shared<MeshCacheData>();
+	shared_ptr<FbxModelScene> fbxModel;
+	if (MeshCache::Load(filePath, *cacheData) == false)
+	{
+		fbxModel = make_shared<FbxModelScene>(filePath);
+
+		//실패한 결과를 캐시에 남기지 않음
+		if (fbxModel->IsLoaded() == false)
+		{
+			SetImportingState(false);
+			return;
+		}
+
+		cacheData->Name = fbxModel->GetName();
+		cacheData->MeshInfo = fbxModel->CreateMeshResourcesInfo();
+		cacheData->Animations = fbxModel->GetAnimationClips();
+
+		MeshCache::Save(filePath, *cacheData);
+	}
+
+	//구운 팔레트는 캐시에 저장하지 않고 압축된 트랙에서 다시 만듦
+	if (bakeAnimations)
+	{
+		for (auto& element : cacheData->Animations)
+		{
+			element.second.Baked = make_shared<const BakedAnimation>(BakedAnimation::Bake(element.second));
+		}
+	}
+
 	auto end = std::chrono::system_clock::now();
 
 	auto delta = std::chrono::duration_cast<std::chrono::duration<float>>(end - start);
 
 	std::function func([=]()
 		{
-			auto fbxModels = m_model.FbxModels.lock();
-			if (fbxModels == nullptr)
+			if (fbxModel != nullptr)
 			{
-				return;
+				auto fbxModels = m_model.FbxModels.lock();
+				if (fbxModels == nullptr)
+				{
+					return;
+				}
+				fbxModels->emplace(cacheData->Name, fbxModel);
 			}
-			string modelName = fbxModel->GetName();
-			fbxModels->emplace(modelName, fbxModel);
 
-			RegisterMeshResources(modelName, fbxModel.get());
+			RegisterMeshResources(cacheData->Name, cacheData->MeshInfo);
 
-			unordered_map<string, AnimationClip>& animClips = fbxModel->GetAnimationClips();
-			for (auto& element : animClips)
+			//클립은 여기서 한번만 만들고 인스턴스들은 참조만 함
+			for (auto& element : cacheData->Animations)
 			{
-				RegisterAnimationClip(element.first, element.second);
+				RegisterAnimationClip(element.first, make_shared<const AnimationClip>(std::move(element.second)));
 			}
 
 			m_lastImportTime = delta.count();
@@ -129,9 +158,10 @@ void ImportListControl::fbxImportAsync(std::wstring filePath)
 		return;
 	}
 
+	bool bakeAnimations = m_bakeAnimations;
 	std::function asyncImportFunc([=]()
 		{
-			fbxImport(filePath);
+			fbxImport(filePath, bakeAnimations);
 		});
 	ThreadManager::GetInstance().EnqueueJob(asyncImportFunc);
 }
@@ -163,6 +193,8 @@ void ImportListControl::Show()
 				fbxImportAsync(dialog.GetSelectedItem());
 			}
 			ImGui::SameLine();
+			ImGui::Checkbox("Bake Animations", &m_bakeAnimations);
+			ImGui::SameLine();
 			ImGui::Text("Import Time :");
 			ImGui::SameLine();
 			ImGui::Text(to_string(m_lastImportTime).c_str());
@@ -197,7 +229,7 @@ void ImportListControl::Show()
 						ImGuiTreeNodeFlags_Leaf |
 						ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-					//׸߰
+					//항목추가
 					ImGui::TreeNodeEx((void*)(intptr_t)treeId++, node_flags, meshResourceName.c_str());
 					if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
 					{
@@ -242,12 +274,20 @@ void ImportListControl::Show()
 						ImGuiTreeNodeFlags_Leaf |
 						ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-					//׸߰
+					//항목추가
 					ImGui::TreeNodeEx((void*)(intptr_t)treeId++, node_flags, animationName.c_str());
 					if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
 					{
 						ImGui::OpenPopup(popupId.c_str());
 					}
+					//압축 결과
+					if (ImGui::IsItemHovered())
+					{
+						const AnimationCompressionStats& stats = iter->second->CompressionStats;
+						ImGui::SetTooltip("Raw : %.1f KB\nCompressed : %.1f KB\nMax Error T : %f, R : %f rad, S : %f",
+							stats.RawSize / 1024.0f, stats.CompressedSize / 1024.0f,
+							stats.MaxTranslationError, stats.MaxRotationError, stats.MaxScaleError);
+					}
 					if (ImGui::BeginPopup(popupId.c_str()))
 					{
 						if (ImGui::Selectable("DeleteAnimations"))
@@ -12,7 +12,7 @@ struct ImportListModel
 	std::weak_ptr<Scene> CurrentScene;
 	std::weak_ptr<std::map<std::string, std::shared_ptr<FbxModelScene>>> FbxModels;
 	std::weak_ptr<std::map<std::string, std::shared_ptr<MeshResources>>> MeshResources;
-	std::weak_ptr<std::map<std::string, AnimationClip>> Animations;
+	std::weak_ptr<std::map<std::string, std::shared_ptr<const AnimationClip>>> Animations;
 };
 
 class ImportListControl
@@ -21,14 +21,15 @@ public:
 	ImportListControl();
 
 private:
-	std::string RegisterMeshResources(const std::string key, FbxModelScene* fbxmodel);
+	std::string RegisterMeshResources(const std::string key, MeshResourcesInfo& meshResourcesInfo);
 	void RegisterMeshObject(const std::string name, MeshResources* meshResources);
 
-	std::string RegisterAnimationClip(const std::string key, AnimationClip& animationClip);
+	std::string RegisterAnimationClip(const std::string key, std::shared_ptr<const AnimationClip> animationClip);
 
-	//FBXε FbxModels ߰ MeshResource 
-	void fbxImport(std::wstring filePath);
-	//񵿱 FBXε FbxModels ߰ MeshResource 
+	//FBX로딩 FbxModels에 추가 MeshResource 생성
+	//bakeAnimations : 클립 팔레트를 미리 구움 (구운 애니메이션 재생용)
+	void fbxImport(std::wstring filePath, bool bakeAnimations);
+	//비동기 FBX로딩 FbxModels에 추가 MeshResource 생성
 	void fbxImportAsync(std::wstring filePath);
 
 	void SetImportingState(bool state);
@@ -42,6 +43,8 @@ private:
 	ImportListModel m_model;
 
 	float m_lastImportTime = 0.0f;
+	//클립마다 프레임 * 본 * 48B, 필요할때만 켬
+	bool m_bakeAnimations = false;
 
 	std::mutex m_isImportingMutex;
 	bool m_isImporting = false;
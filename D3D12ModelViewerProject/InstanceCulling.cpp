@@ -0,0 +1,70 @@
+#include "InstanceCulling.h"
+
+using namespace DirectX;
+
+void InstanceCullingSystem::BeginFrame(const Camera& camera)
+{
+	m_lastFrameStats = m_stats;
+	m_stats = InstanceCullingStats();
+
+	//행벡터 기준이라 viewProj의 열에서 클립 평면을 구함
+	XMMATRIX columns = XMMatrixTranspose(XMMatrixMultiply(camera.GetView(), camera.GetProj()));
+
+	const XMVECTOR planes[8] = {
+		XMVectorAdd(columns.r[3], columns.r[0]),		//left
+		XMVectorSubtract(columns.r[3], columns.r[0]),	//right
+		XMVectorAdd(columns.r[3], columns.r[1]),		//bottom
+		XMVectorSubtract(columns.r[3], columns.r[1]),	//top
+		columns.r[2],									//near
+		XMVectorSubtract(columns.r[3], columns.r[2]),	//far
+		columns.r[2],
+		XMVectorSubtract(columns.r[3], columns.r[2])
+	};
+
+	for (int group = 0; group < 2; ++group)
+	{
+		XMMATRIX transposed = XMMatrixTranspose(XMMATRIX(planes[group * 4], planes[group * 4 + 1], planes[group * 4 + 2], planes[group * 4 + 3]));
+		XMStoreFloat4(&m_planeX[group], transposed.r[0]);
+		XMStoreFloat4(&m_planeY[group], transposed.r[1]);
+		XMStoreFloat4(&m_planeZ[group], transposed.r[2]);
+		XMStoreFloat4(&m_planeW[group], transposed.r[3]);
+	}
+}
+
+bool InstanceCullingSystem::IsVisible(const BoundingBox& worldBounds) const
+{
+	XMVECTOR centerX = XMVectorReplicate(worldBounds.Center.x);
+	XMVECTOR centerY = XMVectorReplicate(worldBounds.Center.y);
+	XMVECTOR centerZ = XMVectorReplicate(worldBounds.Center.z);
+	XMVECTOR extentsX = XMVectorReplicate(worldBounds.Extents.x);
+	XMVECTOR extentsY = XMVectorReplicate(worldBounds.Extents.y);
+	XMVECTOR extentsZ = XMVectorReplicate(worldBounds.Extents.z);
+
+	//평면 4개를 한번에, 중심 거리 + 평면 방향 반크기가 음수면 완전히 바깥
+	for (int group = 0; group < 2; ++group)
+	{
+		XMVECTOR planeX = XMLoadFloat4(&m_planeX[group]);
+		XMVECTOR planeY = XMLoadFloat4(&m_planeY[group]);
+		XMVECTOR planeZ = XMLoadFloat4(&m_planeZ[group]);
+
+		XMVECTOR distance = XMVectorMultiplyAdd(centerX, planeX, XMLoadFloat4(&m_planeW[group]));
+		distance = XMVectorMultiplyAdd(centerY, planeY, distance);
+		distance = XMVectorMultiplyAdd(centerZ, planeZ, distance);
+
+		XMVECTOR radius = XMVectorMultiply(extentsX, XMVectorAbs(planeX));
+		radius = XMVectorMultiplyAdd(extentsY, XMVectorAbs(planeY), radius);
+		radius = XMVectorMultiplyAdd(extentsZ, XMVectorAbs(planeZ), radius);
+
+		if (XMVector4NotEqualInt(XMVectorLess(XMVectorAdd(distance, radius), XMVectorZero()), XMVectorZero()))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+InstanceCullingSystem& GetInstanceCullingSystem()
+{
+	static InstanceCullingSystem cullingSystem;
+	return cullingSystem;
+}
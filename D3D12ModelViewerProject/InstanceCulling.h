@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Camera.h"
+
+//프레임마다 초기화되는 카운터
+struct InstanceCullingStats
+{
+	size_t TestedInstances = 0;
+	size_t VisibleInstances = 0;
+};
+
+//카메라 절두체 밖의 인스턴스를 업로드, 드로우에서 제외
+class InstanceCullingSystem
+{
+public:
+	//씬 업데이트 전에 호출, 통계는 지난 프레임 것으로 넘어감
+	void BeginFrame(const Camera& camera);
+	//월드 공간 박스가 절두체와 겹치거나 안에 있으면 true
+	bool IsVisible(const DirectX::BoundingBox& worldBounds) const;
+
+	bool IsEnabled() const { return m_enable; }
+	void SetEnable(bool enable) { m_enable = enable; }
+
+	InstanceCullingStats& GetStats() { return m_stats; }
+	const InstanceCullingStats& GetLastFrameStats() const { return m_lastFrameStats; }
+private:
+	//평면 6개를 4개씩 두 묶음으로 성분별 저장, 남는 자리는 마지막 평면 반복
+	//ax + by + cz + d >= 0 이면 안쪽
+	DirectX::XMFLOAT4 m_planeX[2];
+	DirectX::XMFLOAT4 m_planeY[2];
+	DirectX::XMFLOAT4 m_planeZ[2];
+	DirectX::XMFLOAT4 m_planeW[2];
+
+	bool m_enable = true;
+
+	InstanceCullingStats m_stats;
+	InstanceCullingStats m_lastFrameStats;
+};
+
+InstanceCullingSystem& GetInstanceCullingSystem();
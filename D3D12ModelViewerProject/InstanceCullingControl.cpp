@@ -0,0 +1,26 @@
+#include "InstanceCullingControl.h"
+
+void InstanceCullingControl::Show()
+{
+	if (ImGui::Begin("Instance Culling") == false)
+	{
+		ImGui::End();
+		return;
+	}
+
+	InstanceCullingSystem& cullingSystem = GetInstanceCullingSystem();
+
+	bool enable = cullingSystem.IsEnabled();
+	if (ImGui::Checkbox("Enable", &enable))
+	{
+		cullingSystem.SetEnable(enable);
+	}
+
+	//지난 프레임 카운터
+	const InstanceCullingStats& stats = cullingSystem.GetLastFrameStats();
+	ImGui::Separator();
+	ImGui::Text("Drawn Instances : %zu", stats.VisibleInstances);
+	ImGui::Text("Culled Instances : %zu", stats.TestedInstances - stats.VisibleInstances);
+
+	ImGui::End();
+}
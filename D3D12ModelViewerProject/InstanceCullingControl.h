@@ -0,0 +1,10 @@
+#pragma once
+
+#include "ImGUIControl.h"
+#include "InstanceCulling.h"
+
+class InstanceCullingControl
+{
+public:
+	void Show();
+};
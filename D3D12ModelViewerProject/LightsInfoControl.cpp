@@ -38,7 +38,7 @@ void LightsInfoControl::Show()
 
 			string popupId = "directionalLightsPopup" + to_string(treeIndex);
 
-			//׸߰  þ 
+			//항목추가 및 선택아이템 변경
 			if (ImGui::TreeNodeEx((void*)(intptr_t)treeIndex, node_flags, light.name.c_str()))
 			{
 				if (ImGui::IsItemClicked(ImGuiMouseButton_Right))
@@ -110,7 +110,7 @@ void LightsInfoControl::Show()
 
 			string popupId = "PointLightsPopup" + to_string(treeIndex);
 
-			//׸߰  þ 
+			//항목추가 및 선택아이템 변경
 			if (ImGui::TreeNodeEx((void*)(intptr_t)controlId++, node_flags, light.name.c_str()))
 			{
 				if (ImGui::IsItemClicked(ImGuiMouseButton_Right))
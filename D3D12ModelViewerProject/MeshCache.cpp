@@ -0,0 +1,643 @@
+
+#include "MeshCache.h"
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+using namespace std;
+using namespace DirectX;
+
+namespace
+{
+	const uint32_t MeshCacheMagic = 0x4843534D; // "MSCH"
+
+	struct MeshCacheHeader
+	{
+		uint32_t Magic = MeshCacheMagic;
+		uint32_t ImporterVersion = MeshCache::ImporterVersion;
+		uint64_t SourceFileSize = 0;
+		int64_t SourceWriteTime = 0;
+		//header 뒤에오는 데이터 크기
+		uint64_t PayloadSize = 0;
+	};
+
+	struct SourceFileKey
+	{
+		std::wstring Path;
+		uint64_t Size = 0;
+		int64_t WriteTime = 0;
+	};
+
+	bool GetSourceFileKey(const std::wstring& filePath, SourceFileKey& key)
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code errorCode;
+		fs::path path = fs::absolute(filePath, errorCode).lexically_normal();
+		if (errorCode)
+		{
+			return false;
+		}
+
+		uint64_t fileSize = fs::file_size(path, errorCode);
+		if (errorCode)
+		{
+			return false;
+		}
+
+		auto writeTime = fs::last_write_time(path, errorCode);
+		if (errorCode)
+		{
+			return false;
+		}
+
+		key.Path = path.wstring();
+		key.Size = fileSize;
+		key.WriteTime = writeTime.time_since_epoch().count();
+		return true;
+	}
+
+	//캐시파일 전체를 읽기전용으로 매핑
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::wstring& filePath)
+		{
+			m_file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (GetFileSizeEx(m_file, &fileSize) == FALSE || fileSize.QuadPart == 0)
+			{
+				return;
+			}
+
+			m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping == nullptr)
+			{
+				return;
+			}
+
+			m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_view != nullptr)
+			{
+				m_size = static_cast<size_t>(fileSize.QuadPart);
+			}
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+			if (m_view != nullptr)
+			{
+				UnmapViewOfFile(m_view);
+			}
+			if (m_mapping != nullptr)
+			{
+				CloseHandle(m_mapping);
+			}
+			if (m_file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_file);
+			}
+		}
+
+		bool IsValid() const { return m_view != nullptr; }
+		const uint8_t* GetData() const { return m_view; }
+		size_t GetSize() const { return m_size; }
+	private:
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = nullptr;
+		const uint8_t* m_view = nullptr;
+		size_t m_size = 0;
+	};
+
+	class BinaryWriter
+	{
+	public:
+		BinaryWriter(std::ofstream& stream) : m_stream(stream) {}
+
+		template<class T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<class T>
+		void WriteVector(const std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			Write<uint64_t>(values.size());
+			m_stream.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+		}
+
+		template<class CharT>
+		void WriteString(const std::basic_string<CharT>& value)
+		{
+			Write<uint64_t>(value.size());
+			m_stream.write(reinterpret_cast<const char*>(value.data()), sizeof(CharT) * value.size());
+		}
+	private:
+		std::ofstream& m_stream;
+	};
+
+	//모든 Read는 범위를 벗어나면 false 반환
+	class BinaryReader
+	{
+	public:
+		BinaryReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+		template<class T>
+		bool Read(T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			if (GetRemainSize() < sizeof(T))
+			{
+				return false;
+			}
+			memcpy(&value, m_data + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		template<class T>
+		bool ReadVector(std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			uint64_t count = 0;
+			if (Read(count) == false || count > GetRemainSize() / sizeof(T))
+			{
+				return false;
+			}
+			values.resize(static_cast<size_t>(count));
+			if (count > 0)
+			{
+				memcpy(values.data(), m_data + m_offset, sizeof(T) * count);
+				m_offset += sizeof(T) * count;
+			}
+			return true;
+		}
+
+		template<class CharT>
+		bool ReadString(std::basic_string<CharT>& value)
+		{
+			uint64_t length = 0;
+			if (Read(length) == false || length > GetRemainSize() / sizeof(CharT))
+			{
+				return false;
+			}
+			value.resize(static_cast<size_t>(length));
+			if (length > 0)
+			{
+				memcpy(value.data(), m_data + m_offset, sizeof(CharT) * length);
+				m_offset += sizeof(CharT) * length;
+			}
+			return true;
+		}
+
+		//파일의 개수값으로 resize하기전 남은 크기로 제한, minElementSize : 원소 하나가 차지하는 최소 바이트
+		bool ReadCount(uint64_t& count, size_t minElementSize)
+		{
+			return Read(count) && count <= GetRemainSize() / minElementSize;
+		}
+
+		size_t GetRemainSize() const { return m_size - m_offset; }
+		bool IsEnd() const { return m_offset == m_size; }
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		size_t m_offset = 0;
+	};
+
+	//직렬화된 최소 크기 (문자열, 벡터는 비어있을때)
+	const size_t MinJointSize = sizeof(int32_t) + sizeof(uint64_t) + sizeof(int32_t) + sizeof(double) * 16 + sizeof(AffineMatrix) * 2;
+	const size_t MinVectorTrackSize = sizeof(uint64_t) * 3 + sizeof(float) * 6;
+	const size_t MinRotationTrackSize = sizeof(uint64_t) * 3;
+	const size_t MinBoneAnimationSize = MinJointSize + sizeof(int32_t) + sizeof(uint32_t) + MinVectorTrackSize * 2 + MinRotationTrackSize;
+
+	//재생때 키 검색과 커서가 프레임이 오름차순이고 FrameCount 안에 있다고 가정함
+	bool IsValidKeyFrames(const std::vector<uint32_t>& frames, uint32_t frameCount)
+	{
+		for (size_t i = 0; i < frames.size(); ++i)
+		{
+			if (frames[i] >= frameCount || (i > 0 && frames[i - 1] >= frames[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//부모가 자식보다 앞에 있어야함 (AnimationPoseBatch가 순서대로 계산)
+	bool IsValidParentIndex(int parentIndex, size_t jointIndex)
+	{
+		return parentIndex < 0 || static_cast<size_t>(parentIndex) < jointIndex;
+	}
+
+	void WriteFbxMatrix(BinaryWriter& writer, const FbxAMatrix& matrix)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			FbxVector4 rowVector = matrix.GetRow(row);
+			for (int column = 0; column < 4; ++column)
+			{
+				writer.Write<double>(rowVector[column]);
+			}
+		}
+	}
+
+	bool ReadFbxMatrix(BinaryReader& reader, FbxAMatrix& matrix)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			double rowValues[4];
+			if (reader.Read(rowValues) == false)
+			{
+				return false;
+			}
+			matrix.SetRow(row, FbxVector4(rowValues[0], rowValues[1], rowValues[2], rowValues[3]));
+		}
+		return true;
+	}
+
+	void WriteJoint(BinaryWriter& writer, const Joint& joint)
+	{
+		writer.Write<int32_t>(joint.ParentIndex);
+		writer.WriteString(joint.Name);
+		writer.Write<int32_t>(joint.Depth);
+		WriteFbxMatrix(writer, joint.GlobalBindposeInverse);
+		writer.Write(joint.GlobalBindposeInverseTransform);
+		writer.Write(joint.LocalTransform);
+	}
+
+	bool ReadJoint(BinaryReader& reader, Joint& joint)
+	{
+		int32_t parentIndex = 0;
+		int32_t depth = 0;
+
+		bool result = reader.Read(parentIndex) &&
+			reader.ReadString(joint.Name) &&
+			reader.Read(depth) &&
+			ReadFbxMatrix(reader, joint.GlobalBindposeInverse) &&
+			reader.Read(joint.GlobalBindposeInverseTransform) &&
+			reader.Read(joint.LocalTransform);
+
+		joint.ParentIndex = parentIndex;
+		joint.Depth = depth;
+		joint.Node = nullptr;
+		return result;
+	}
+
+	template<class TrackT>
+	void WriteTrackKeys(BinaryWriter& writer, const TrackT& track)
+	{
+		writer.WriteVector(track.Frames);
+		writer.WriteVector(track.Values);
+		writer.WriteVector(track.RawValues);
+	}
+
+	//키마다 양자화값 3개, 또는 float rawComponentCount개
+	template<class TrackT>
+	bool ReadTrackKeys(BinaryReader& reader, TrackT& track, uint32_t frameCount, size_t rawComponentCount)
+	{
+		if (reader.ReadVector(track.Frames) == false ||
+			reader.ReadVector(track.Values) == false ||
+			reader.ReadVector(track.RawValues) == false)
+		{
+			return false;
+		}
+		bool isQuantized = track.RawValues.empty() && track.Values.size() == track.Frames.size() * 3;
+		bool isRaw = track.Values.empty() && track.RawValues.size() == track.Frames.size() * rawComponentCount;
+		if ((isQuantized == false && isRaw == false) || IsValidKeyFrames(track.Frames, frameCount) == false)
+		{
+			return false;
+		}
+		return frameCount == 0 || track.Frames.empty() == false;
+	}
+
+	void WriteVectorTrack(BinaryWriter& writer, const CompressedVectorTrack& track)
+	{
+		WriteTrackKeys(writer, track);
+		writer.Write(track.Min);
+		writer.Write(track.Extent);
+	}
+
+	bool ReadVectorTrack(BinaryReader& reader, CompressedVectorTrack& track, uint32_t frameCount)
+	{
+		return ReadTrackKeys(reader, track, frameCount, 3) &&
+			reader.Read(track.Min) &&
+			reader.Read(track.Extent);
+	}
+
+	void WriteAnimationClip(BinaryWriter& writer, const AnimationClip& clip)
+	{
+		writer.WriteString(clip.Name);
+		writer.Write(clip.CompressionStats);
+		writer.Write<uint64_t>(clip.BoneAnimations.size());
+		for (const BoneAnimation& boneAnimation : clip.BoneAnimations)
+		{
+			const CompressedBoneTrack& track = boneAnimation.Track;
+
+			WriteJoint(writer, boneAnimation.Joint);
+			writer.Write<int32_t>(static_cast<int32_t>(boneAnimation.FrameMode));
+			writer.Write<uint32_t>(track.FrameCount);
+			WriteVectorTrack(writer, track.Scale);
+			WriteTrackKeys(writer, track.Rotation);
+			WriteVectorTrack(writer, track.Translation);
+		}
+	}
+
+	//clip의 본은 스켈레톤 조인트와 1:1
+	bool ReadAnimationClip(BinaryReader& reader, AnimationClip& clip, size_t jointCount)
+	{
+		uint64_t boneCount = 0;
+		if (reader.ReadString(clip.Name) == false ||
+			reader.Read(clip.CompressionStats) == false ||
+			reader.ReadCount(boneCount, MinBoneAnimationSize) == false ||
+			boneCount != jointCount)
+		{
+			return false;
+		}
+
+		clip.BoneAnimations.resize(static_cast<size_t>(boneCount));
+		for (size_t boneIndex = 0; boneIndex < clip.BoneAnimations.size(); ++boneIndex)
+		{
+			BoneAnimation& boneAnimation = clip.BoneAnimations[boneIndex];
+			CompressedBoneTrack& track = boneAnimation.Track;
+
+			int32_t frameMode = 0;
+			if (ReadJoint(reader, boneAnimation.Joint) == false ||
+				reader.Read(frameMode) == false ||
+				reader.Read(track.FrameCount) == false ||
+				IsValidParentIndex(boneAnimation.Joint.ParentIndex, boneIndex) == false)
+			{
+				return false;
+			}
+			boneAnimation.FrameMode = static_cast<KeyFrameModes>(frameMode);
+
+			if (ReadVectorTrack(reader, track.Scale, track.FrameCount) == false ||
+				ReadTrackKeys(reader, track.Rotation, track.FrameCount, 4) == false ||
+				ReadVectorTrack(reader, track.Translation, track.FrameCount) == false)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void WriteMeshCacheData(BinaryWriter& writer, const MeshCacheData& data)
+	{
+		const MeshResourcesInfo& meshInfo = data.MeshInfo;
+
+		writer.WriteString(data.Name);
+
+		//Materials
+		writer.Write<uint64_t>(meshInfo.Materials.size());
+		for (const PBRMaterial& material : meshInfo.Materials)
+		{
+			writer.WriteString(material.Name);
+			writer.Write(XMFLOAT4(material.Albedo.x, material.Albedo.y, material.Albedo.z, material.Albedo.w));
+			writer.Write(material.Metalic);
+			writer.Write(material.Roughness);
+			writer.WriteString(material.AlbedoMap);
+		}
+
+		//Vertex, SubMesh
+		writer.WriteVector(meshInfo.VertexTable);
+		writer.Write<uint64_t>(meshInfo.SubMeshes.size());
+		for (auto& element : meshInfo.SubMeshes)
+		{
+			writer.WriteString(element.first);
+			writer.WriteVector(element.second);
+		}
+
+		//Skeleton
+		writer.WriteString(meshInfo.Skeleton.Name);
+		writer.Write<uint64_t>(meshInfo.Skeleton.Joints.size());
+		for (const Joint& joint : meshInfo.Skeleton.Joints)
+		{
+			WriteJoint(writer, joint);
+		}
+
+		//Animations
+		writer.Write<uint64_t>(data.Animations.size());
+		for (auto& element : data.Animations)
+		{
+			writer.WriteString(element.first);
+			WriteAnimationClip(writer, element.second);
+		}
+	}
+
+	bool ReadMeshCacheData(BinaryReader& reader, MeshCacheData& data)
+	{
+		MeshResourcesInfo& meshInfo = data.MeshInfo;
+
+		if (reader.ReadString(data.Name) == false)
+		{
+			return false;
+		}
+
+		//Materials
+		uint64_t materialCount = 0;
+		if (reader.ReadCount(materialCount, sizeof(uint64_t) * 2 + sizeof(XMFLOAT4) + sizeof(float) * 2) == false)
+		{
+			return false;
+		}
+		for (uint64_t i = 0; i < materialCount; ++i)
+		{
+			PBRMaterial material;
+			XMFLOAT4 albedo;
+			if (reader.ReadString(material.Name) == false ||
+				reader.Read(albedo) == false ||
+				reader.Read(material.Metalic) == false ||
+				reader.Read(material.Roughness) == false ||
+				reader.ReadString(material.AlbedoMap) == false)
+			{
+				return false;
+			}
+			material.Albedo = SimpleMath::Color(albedo.x, albedo.y, albedo.z, albedo.w);
+			meshInfo.Materials.push_back(std::move(material));
+		}
+
+		//Vertex, SubMesh
+		uint64_t subMeshCount = 0;
+		if (reader.ReadVector(meshInfo.VertexTable) == false || reader.ReadCount(subMeshCount, sizeof(uint64_t) * 2) == false)
+		{
+			return false;
+		}
+		for (uint64_t i = 0; i < subMeshCount; ++i)
+		{
+			std::string materialName;
+			IndexTableType indexTable;
+			if (reader.ReadString(materialName) == false || reader.ReadVector(indexTable) == false)
+			{
+				return false;
+			}
+			for (IndexBufferFormat index : indexTable)
+			{
+				if (index >= meshInfo.VertexTable.size())
+				{
+					return false;
+				}
+			}
+			meshInfo.SubMeshes.emplace(std::move(materialName), std::move(indexTable));
+		}
+
+		//Skeleton
+		uint64_t jointCount = 0;
+		if (reader.ReadString(meshInfo.Skeleton.Name) == false || reader.ReadCount(jointCount, MinJointSize) == false)
+		{
+			return false;
+		}
+		meshInfo.Skeleton.Joints.resize(static_cast<size_t>(jointCount));
+		for (size_t jointIndex = 0; jointIndex < meshInfo.Skeleton.Joints.size(); ++jointIndex)
+		{
+			Joint& joint = meshInfo.Skeleton.Joints[jointIndex];
+			if (ReadJoint(reader, joint) == false || IsValidParentIndex(joint.ParentIndex, jointIndex) == false)
+			{
+				return false;
+			}
+		}
+
+		//가중치가 있는 영향은 조인트 범위 안이어야함, 빈 영향은 0으로 채워짐
+		for (const Vertex& vertex : meshInfo.VertexTable)
+		{
+			const UINT indices[4] = { vertex.BoneIndices.x, vertex.BoneIndices.y, vertex.BoneIndices.z, vertex.BoneIndices.w };
+			const float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, vertex.BoneWeights.w };
+			for (int i = 0; i < 4; ++i)
+			{
+				if (indices[i] >= jointCount && (indices[i] != 0 || weights[i] != 0.0f))
+				{
+					return false;
+				}
+			}
+		}
+
+		//Animations
+		uint64_t animationCount = 0;
+		if (reader.ReadCount(animationCount, sizeof(uint64_t) * 2 + sizeof(AnimationCompressionStats) + sizeof(uint64_t)) == false)
+		{
+			return false;
+		}
+		for (uint64_t i = 0; i < animationCount; ++i)
+		{
+			std::string clipKey;
+			AnimationClip clip;
+			if (reader.ReadString(clipKey) == false || ReadAnimationClip(reader, clip, meshInfo.Skeleton.Joints.size()) == false)
+			{
+				return false;
+			}
+			data.Animations.emplace(std::move(clipKey), std::move(clip));
+		}
+
+		return true;
+	}
+}
+
+bool MeshCache::Load(const std::wstring& fbxFilePath, MeshCacheData& outData)
+{
+	SourceFileKey key;
+	if (GetSourceFileKey(fbxFilePath, key) == false)
+	{
+		return false;
+	}
+
+	MappedFile cacheFile(GetCacheFilePath(fbxFilePath));
+	if (cacheFile.IsValid() == false)
+	{
+		return false;
+	}
+
+	BinaryReader reader(cacheFile.GetData(), cacheFile.GetSize());
+
+	MeshCacheHeader header;
+	if (reader.Read(header) == false ||
+		header.Magic != MeshCacheMagic ||
+		header.ImporterVersion != ImporterVersion ||
+		header.SourceFileSize != key.Size ||
+		header.SourceWriteTime != key.WriteTime ||
+		header.PayloadSize != reader.GetRemainSize())
+	{
+		return false;
+	}
+
+	std::wstring sourcePath;
+	if (reader.ReadString(sourcePath) == false || sourcePath != key.Path)
+	{
+		return false;
+	}
+
+	MeshCacheData data;
+	if (ReadMeshCacheData(reader, data) == false || reader.IsEnd() == false)
+	{
+		return false;
+	}
+
+	outData = std::move(data);
+	return true;
+}
+
+bool MeshCache::Save(const std::wstring& fbxFilePath, const MeshCacheData& data)
+{
+	namespace fs = std::filesystem;
+
+	SourceFileKey key;
+	if (GetSourceFileKey(fbxFilePath, key) == false)
+	{
+		return false;
+	}
+
+	//쓰는 도중 실패해도 기존 캐시가 깨지지 않도록 임시파일에 쓴후 교체
+	std::wstring cacheFilePath = GetCacheFilePath(fbxFilePath);
+	std::wstring tempFilePath = cacheFilePath + L".tmp";
+	{
+		std::ofstream stream(fs::path(tempFilePath), std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			return false;
+		}
+
+		BinaryWriter writer(stream);
+
+		MeshCacheHeader header;
+		header.SourceFileSize = key.Size;
+		header.SourceWriteTime = key.WriteTime;
+		writer.Write(header);
+
+		std::streampos payloadBegin = stream.tellp();
+		writer.WriteString(key.Path);
+		WriteMeshCacheData(writer, data);
+
+		header.PayloadSize = static_cast<uint64_t>(stream.tellp() - payloadBegin);
+		stream.seekp(0);
+		writer.Write(header);
+
+		if (!stream)
+		{
+			stream.close();
+			std::error_code errorCode;
+			fs::remove(tempFilePath, errorCode);
+			return false;
+		}
+	}
+
+	std::error_code errorCode;
+	fs::rename(tempFilePath, cacheFilePath, errorCode);
+	if (errorCode)
+	{
+		fs::remove(tempFilePath, errorCode);
+		return false;
+	}
+	return true;
+}
+
+std::wstring MeshCache::GetCacheFilePath(const std::wstring& fbxFilePath)
+{
+	return fbxFilePath + L".meshcache";
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "MeshResources.h"
+
+// FbxModelScene Import 결과
+struct MeshCacheData
+{
+	std::string Name;
+	MeshResourcesInfo MeshInfo;
+	std::unordered_map<std::string, AnimationClip> Animations;
+};
+
+// Import 결과를 fbx파일 옆에 바이너리로 저장하고 다시 Import할때 FbxModelScene없이 읽음
+// 키 : 파일경로 + 수정시간 + 파일크기 + ImporterVersion
+class MeshCache
+{
+public:
+	// FbxModelScene의 출력이나 캐시 레이아웃이 바뀌면 증가시켜야함
+	static const uint32_t ImporterVersion = 6;
+public:
+	// 캐시가 없거나 키가 다르면 false 반환
+	static bool Load(const std::wstring& fbxFilePath, MeshCacheData& outData);
+	static bool Save(const std::wstring& fbxFilePath, const MeshCacheData& data);
+
+	static std::wstring GetCacheFilePath(const std::wstring& fbxFilePath);
+};
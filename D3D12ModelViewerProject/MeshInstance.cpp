@@ -6,15 +6,15 @@
 using namespace std;
 using namespace DirectX;
 
-MeshInstance::MeshInstance(std::string name, std::weak_ptr<MeshObject> parent, Transform transform)
+MeshInstance::MeshInstance(std::string name, NumberHandle handle, std::weak_ptr<MeshObject> parent, Transform transform)
 	:m_name(name),
+	m_handle(handle),
 	m_parent(parent),
 	m_transform(transform)
 {
-	if (auto parentMeshObject = parent.lock())
+	if (auto parentObject = parent.lock())
 	{
-		const size_t numOfBones = parentMeshObject->GetSkeleton().Joints.size();
-		m_instanceAnimations.resize(numOfBones);
+		m_localBounds = parentObject->GetBounds();
 	}
 }
 
@@ -24,7 +24,7 @@ void MeshInstance::Update()
 	auto parent = m_parent.lock();
 
 	UpdateInstanceConstants(parent.get());
-	UpdateInstanceAnimations(parent.get(), timer.DeltaTime());
+	UpdateInstanceAnimations(timer.DeltaTime());
 }
 
 void MeshInstance::SetTransform(const Transform& transform)
@@ -33,15 +33,21 @@ void MeshInstance::SetTransform(const Transform& transform)
 	m_instanceConstDirty = FramesCount + 1;
 }
 
-void MeshInstance::SetAnimation(const AnimationClip& animation, bool bPlay, bool bLoop)
+void MeshInstance::SetAnimation(std::shared_ptr<const AnimationClip> animation, bool bPlay, bool bLoop, float blendTime)
 {
+	if (animation == nullptr)
+	{
+		return;
+	}
+
 	if (auto parent = m_parent.lock())
 	{
 		const Skeleton& skeleton = parent->GetSkeleton();
 
-		if (animation.BoneAnimations.size() == skeleton.Joints.size())
+		if (animation->BoneAnimations.size() == skeleton.Joints.size())
 		{
-			m_animationCalculator.SetAnimationClip(animation);
+			m_bakedAnimation = nullptr;
+			m_animationCalculator.SetAnimationClip(animation, blendTime);
 			m_animationCalculator.SetLoop(bLoop);
 			m_isAnimationPlaying = bPlay;
 			m_animationDirty = FramesCount + 1;
@@ -49,11 +55,84 @@ void MeshInstance::SetAnimation(const AnimationClip& animation, bool bPlay, bool
 	}
 }
 
+void MeshInstance::SetAnimationLayer(size_t layerIndex, std::shared_ptr<const AnimationClip> animation, AnimationBlendMode blendMode,
+	float weight, std::shared_ptr<const std::vector<float>> boneMask)
+{
+	if (auto parent = m_parent.lock())
+	{
+		const size_t boneCount = parent->GetSkeleton().Joints.size();
+
+		if (animation != nullptr && animation->BoneAnimations.size() != boneCount)
+		{
+			return;
+		}
+		if (boneMask != nullptr && boneMask->size() != boneCount)
+		{
+			return;
+		}
+
+		m_animationCalculator.SetLayer(layerIndex, std::move(animation), blendMode, weight, std::move(boneMask));
+		m_animationDirty = FramesCount + 1;
+	}
+}
+
+void MeshInstance::SetAnimationLayerWeight(size_t layerIndex, float weight)
+{
+	m_animationCalculator.SetLayerWeight(layerIndex, weight);
+	m_animationDirty = FramesCount + 1;
+}
+
 void MeshInstance::StopAnimation()
 {
 	m_isAnimationPlaying = false;
 	m_animationDirty = FramesCount + 1;
-	m_animationCalculator.SetAnimationClip(AnimationClip());
+	m_animationCalculator.SetAnimationClip(nullptr);
+	m_animationCalculator.ClearLayers();
+	m_bakedAnimation = nullptr;
+}
+
+void MeshInstance::SetBakedAnimation(std::shared_ptr<const AnimationClip> animation, float timeOffset)
+{
+	if (animation == nullptr || animation->Baked == nullptr)
+	{
+		return;
+	}
+
+	if (auto parent = m_parent.lock())
+	{
+		if (animation->BoneAnimations.size() != parent->GetSkeleton().Joints.size())
+		{
+			return;
+		}
+
+		m_animationCalculator.SetAnimationClip(nullptr);
+		m_animationCalculator.ClearLayers();
+		m_isAnimationPlaying = false;
+		m_bakedAnimation = std::move(animation);
+
+		//셰이더에서 gTotalTime + bakedTimeOffset으로 재생시간을 구함
+		m_instanceConsts.bakedTimeOffset = timeOffset - GetMainTimer().TotalTime();
+		m_instanceConstDirty = FramesCount + 1;
+		m_animationDirty = FramesCount + 1;
+	}
+}
+
+void MeshInstance::SetBakedClipId(UINT clipId)
+{
+	if (m_instanceConsts.bakedClipId != clipId)
+	{
+		m_instanceConsts.bakedClipId = clipId;
+		m_instanceConstDirty = FramesCount + 1;
+	}
+}
+
+void MeshInstance::SetAnimationOffset(UINT offset)
+{
+	if (m_instanceConsts.animationOffset != offset)
+	{
+		m_instanceConsts.animationOffset = offset;
+		m_instanceConstDirty = FramesCount + 1;
+	}
 }
 
 void MeshInstance::UpdateInstanceConstants(MeshObject* parent)
@@ -67,7 +146,8 @@ void MeshInstance::UpdateInstanceConstants(MeshObject* parent)
 	XMStoreFloat4x4(&m_instanceConsts.Transform, XMMatrixTranspose(finalTransformMatrix));
 }
 
-void MeshInstance::UpdateInstanceAnimations(MeshObject* parent, float deltaTime)
+//포즈는 DynamicMesh에서 같은 클립끼리 모아서 계산
+void MeshInstance::UpdateInstanceAnimations(float deltaTime)
 {
 	if (m_isAnimationPlaying == true)
 	{
@@ -75,11 +155,6 @@ void MeshInstance::UpdateInstanceAnimations(MeshObject* parent, float deltaTime)
 		m_animationDirty = FramesCount + 1;
 	}
 
-	if (m_animationDirty == FramesCount + 1)
-	{
-		m_animationCalculator.CopyAnimation(m_instanceAnimations, parent->GetSkeleton());
-	}
-
 	DecreaseAnimationDirty();
 }
 
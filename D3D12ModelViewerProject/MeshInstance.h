@@ -2,36 +2,59 @@
 
 #include "FbxUtil.h"
 #include "AnimationCalculator.h"
+#include "AnimationLod.h"
+#include "NumberAllocator.h"
 
 class MeshObject;
 
 class MeshInstance
 {
 public:
-	MeshInstance(std::string name, std::weak_ptr<MeshObject> parent, Transform transform = Transform());
+	MeshInstance(std::string name, NumberHandle handle, std::weak_ptr<MeshObject> parent, Transform transform = Transform());
 public:
-	//dirtyCount
+	//dirtyCount감소
 	void Update();
 
 	int GetInstanceConstDirty() { return m_instanceConstDirty; }
 	int GetAnimationDirty() { return m_animationDirty; }
 
 	std::string GetName() { return m_name; }
+	//MeshObject::FindMeshInstance로 찾을때 사용
+	NumberHandle GetHandle() const { return m_handle; }
 	const InstanceConstants& GetInstanceConstants() const { return m_instanceConsts; }
 	const Transform& GetTransform() { return m_transform; }
 	void SetTransform(const Transform& transform);
-	void SetAnimation(const AnimationClip& animation, bool bPlay = true, bool bLoop = true);
+	//blendTime동안 재생중인 클립에서 크로스페이드
+	void SetAnimation(std::shared_ptr<const AnimationClip> animation, bool bPlay = true, bool bLoop = true, float blendTime = 0.0f);
+	//기본 클립 위에 섞을 레이어, boneMask는 본 개수만큼
+	void SetAnimationLayer(size_t layerIndex, std::shared_ptr<const AnimationClip> animation, AnimationBlendMode blendMode,
+		float weight = 1.0f, std::shared_ptr<const std::vector<float>> boneMask = nullptr);
+	void SetAnimationLayerWeight(size_t layerIndex, float weight);
 	void StopAnimation();
+	//임포트때 구운 클립을 루프 재생, 포즈를 셰이더에서 읽으므로 인스턴스별 CPU 계산이 없음
+	//timeOffset : 재생 시작 위치
+	void SetBakedAnimation(std::shared_ptr<const AnimationClip> animation, float timeOffset = 0.0f);
+	const std::shared_ptr<const AnimationClip>& GetBakedAnimation() const { return m_bakedAnimation; }
+	//DynamicMesh의 구운 클립 버퍼에서 위치
+	void SetBakedClipId(UINT clipId);
 	void PauseAnimation() { m_isAnimationPlaying = false; };
 	void PlayAnimation() { m_isAnimationPlaying = true; };
-	const std::vector<InstanceAnimations>& GetInstanceAnimations() { return m_instanceAnimations; }
+	bool IsAnimationPlaying() const { return m_isAnimationPlaying; }
+	AnimationCalcuator& GetAnimationCalculator() { return m_animationCalculator; }
+	AnimationLodState& GetAnimationLod() { return m_animationLod; }
+	//palette offset : InstanceAnimations 버퍼에서 읽을 팔레트 위치
+	void SetAnimationOffset(UINT offset);
+	//인스턴스 변환 전 바운딩박스, 스킨 메쉬는 마지막으로 쓴 팔레트 기준
+	const DirectX::BoundingBox& GetLocalBounds() const { return m_localBounds; }
+	void SetLocalBounds(const DirectX::BoundingBox& bounds) { m_localBounds = bounds; }
 private:
 	void UpdateInstanceConstants(MeshObject* parent);
-	void UpdateInstanceAnimations(MeshObject* parent,float deltaTime);
+	void UpdateInstanceAnimations(float deltaTime);
 	void DecreaseInstanceConstDirty();
 	void DecreaseAnimationDirty();
 private:
 	std::string m_name;
+	NumberHandle m_handle;
 	std::weak_ptr<MeshObject> m_parent;
 
 	int m_instanceConstDirty = FramesCount + 1;
@@ -39,11 +62,11 @@ private:
 
 	InstanceConstants m_instanceConsts;
 
-	//skeleton bone ŭ
-	std::vector<InstanceAnimations> m_instanceAnimations;
-
 	Transform m_transform;
 
 	AnimationCalcuator m_animationCalculator;
+	AnimationLodState m_animationLod;
+	DirectX::BoundingBox m_localBounds;
+	std::shared_ptr<const AnimationClip> m_bakedAnimation;
 	bool m_isAnimationPlaying = false;
 };
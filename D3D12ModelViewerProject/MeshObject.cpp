@@ -3,6 +3,7 @@
 #include "D3DResourceManager.h"
 #include "DynamicMeshObject.h"
 #include "StaticMeshObject.h"
+#include "InstanceCulling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -12,11 +13,28 @@ MeshObject::MeshObject(std::string name, const MeshResources& meshResources, int
 	m_geometry(meshResources.Geometry),
 	m_materials(meshResources.Materials),
 	m_skeleton(meshResources.Skeleton),
-	m_numberAllocator(100000),
 	m_perInstanceDescriptorCount(perInstanceDescriptorCount),
 	m_perMaterialDescriptorCount(perMaterialDescriptorCount),
 	m_meshType(meshType)
 {
+	bool isFirst = true;
+	for (auto& element : m_geometry->DrawArgs)
+	{
+		if (element.second.IndexCount == 0)
+		{
+			continue;
+		}
+
+		if (isFirst)
+		{
+			m_bounds = element.second.Bounds;
+			isFirst = false;
+		}
+		else
+		{
+			BoundingBox::CreateMerged(m_bounds, m_bounds, element.second.Bounds);
+		}
+	}
 }
 
 
@@ -76,6 +94,18 @@ void MeshObject::SetEnable(bool enable)
 	m_enable = enable;
 }
 
+void MeshObject::SetSkinningMode(SkinningModes skinningMode)
+{
+	if (m_skinningMode != skinningMode)
+	{
+		//팔레트 버퍼 형식이 달라지므로 버퍼, 디스크립터, 팔레트를 모두 다시 만듦
+		m_skinningMode = skinningMode;
+		m_instanceBufferDirty = FramesCount;
+		m_HeapAllocationDirty = FramesCount;
+		m_InstanceUpdateDirty = FramesCount;
+	}
+}
+
 std::string MeshObject::CreateMeshInstance(const Transform& transform)
 {
 	size_t CurrInstanceCount = m_meshInstances.size();
@@ -91,9 +121,13 @@ std::string MeshObject::CreateMeshInstance(const Transform& transform)
 		return string();
 	}
 
-	string instanceName = "instance_" + to_string(m_numberAllocator.Allocate());
+	NumberHandle handle = m_numberAllocator.Allocate();
+	string instanceName = "instance_" + to_string(handle.Index);
+
+	std::shared_ptr<MeshInstance> instance = make_shared<MeshInstance>(instanceName, handle, meshObject, transform);
 
-	std::shared_ptr<MeshInstance> instance = make_shared<MeshInstance>(instanceName, meshObject, transform);
+	m_instancesByHandle.resize(m_numberAllocator.GetCapacity());
+	m_instancesByHandle[handle.Index] = instance;
 
 	m_meshInstances.emplace_back(std::move(instance));
 	m_InstanceUpdateDirty = FramesCount;
@@ -106,10 +140,41 @@ void MeshObject::DeleteMeshInstance(size_t instanceIndex)
 	{
 		return;
 	}
+
+	NumberHandle handle = m_meshInstances[instanceIndex]->GetHandle();
+	m_instancesByHandle[handle.Index].reset();
+	m_numberAllocator.Free(handle);
+
 	m_meshInstances.erase(m_meshInstances.begin() + instanceIndex);
 	m_InstanceUpdateDirty = FramesCount;
 }
 
+void MeshObject::DeleteMeshInstance(NumberHandle handle)
+{
+	if (m_numberAllocator.IsValid(handle) == false)
+	{
+		return;
+	}
+
+	for (size_t instanceIndex = 0; instanceIndex < m_meshInstances.size(); ++instanceIndex)
+	{
+		if (m_meshInstances[instanceIndex]->GetHandle() == handle)
+		{
+			DeleteMeshInstance(instanceIndex);
+			return;
+		}
+	}
+}
+
+std::shared_ptr<MeshInstance> MeshObject::FindMeshInstance(NumberHandle handle) const
+{
+	if (m_numberAllocator.IsValid(handle) == false)
+	{
+		return nullptr;
+	}
+	return m_instancesByHandle[handle.Index].lock();
+}
+
 void MeshObject::SetMaxMeshInstanceCount(uint32_t newCount)
 {
 	if (newCount != m_maxInstanceCount)
@@ -136,17 +201,42 @@ void MeshObject::ChangeMeshMaterials(std::string materialName, const PBRMaterial
 
 void MeshObject::UpdateInstanceBuffers(int frameIndex)
 {
-	int i = 0;
+	InstanceCullingSystem& cullingSystem = GetInstanceCullingSystem();
+	InstanceCullingStats& cullingStats = cullingSystem.GetStats();
+
+	//컬링을 끄면 인덱스 위치로 돌아가므로 모두 다시 씀
+	if (m_isCulling != cullingSystem.IsEnabled())
+	{
+		m_isCulling = cullingSystem.IsEnabled();
+		m_InstanceUpdateDirty = FramesCount;
+	}
+
+	UINT visibleCount = 0;
 	for (auto& meshInstance : m_meshInstances)
 	{
-		if (meshInstance->GetInstanceConstDirty() > 0 || m_InstanceUpdateDirty > 0)
+		if (m_isCulling)
 		{
-			m_instanceCBs.at(frameIndex)->CopyData(i, meshInstance->GetInstanceConstants());
+			BoundingBox worldBounds;
+			meshInstance->GetLocalBounds().Transform(worldBounds, XMMatrixMultiply(meshInstance->GetTransform().GetFinalTransformMatrix(), m_finalTransform));
+			if (cullingSystem.IsVisible(worldBounds) == false)
+			{
+				continue;
+			}
 		}
 
-		i++;
+		//컬링중에는 보이는 인스턴스를 앞으로 모으므로 위치가 프레임마다 바뀔수 있어 항상 씀
+		if (m_isCulling || meshInstance->GetInstanceConstDirty() > 0 || m_InstanceUpdateDirty > 0)
+		{
+			m_instanceCBs.at(frameIndex)->CopyData(visibleCount, meshInstance->GetInstanceConstants());
+		}
+
+		visibleCount++;
 	}
 
+	m_visibleInstanceCount = visibleCount;
+	cullingStats.TestedInstances += m_meshInstances.size();
+	cullingStats.VisibleInstances += visibleCount;
+
 	if (m_InstanceUpdateDirty > 0)
 	{
 		m_InstanceUpdateDirty--;
@@ -172,6 +262,7 @@ void MeshObject::UpdateObjectBuffer(int frameIndex)
 {
 	ObjectConstants objConstant;
 	XMStoreFloat4x4(&objConstant.ObjectTransform, XMMatrixTranspose(m_finalTransform));
+	objConstant.SkinningMode = m_skinningMode;
 
 	m_objectCB.at(frameIndex)->CopyData(0, objConstant);
 }
@@ -31,13 +31,21 @@ public:
 public:
 
 	void SetEnable(bool enable);
+	//스켈레톤이 있는 메쉬만 사용
+	void SetSkinningMode(SkinningModes skinningMode);
+	SkinningModes GetSkinningMode() const { return m_skinningMode; }
 	std::string CreateMeshInstance(const Transform& transform = Transform());
 	void DeleteMeshInstance(size_t instanceIndex);
+	void DeleteMeshInstance(NumberHandle handle);
+	//삭제된 인스턴스의 핸들이면 nullptr
+	std::shared_ptr<MeshInstance> FindMeshInstance(NumberHandle handle) const;
 	void ChangeMeshMaterials(std::string materialName, const PBRMaterial& meshMaterials);
 	const std::vector<PBRMaterial>& GetMaterials() const { return m_materials; }
 	const std::vector<std::shared_ptr<MeshInstance>>& GetMeshInstances() const { return m_meshInstances; }
 	MeshType GetMeshType() const { return m_meshType; }
 	const Skeleton& GetSkeleton() { return m_skeleton; }
+	//서브메쉬 바운딩박스를 합친 로컬 바운딩박스
+	const DirectX::BoundingBox& GetBounds() const { return m_bounds; }
 protected:
 	size_t GetDescriptorsCount() { return  m_perInstanceDescriptorCount + m_perMaterialDescriptorCount * m_materials.size(); }
 	void UpdateMaterialBuffer(int frameIndex);
@@ -46,7 +54,7 @@ protected:
 	void SetMaxMeshInstanceCount(uint32_t newCount);
 	void DeleteTextureResource(std::vector<std::wstring> textureFileNames);
 private:
-	//createԼ  
+	//create함수에서만 사용 
 	void initialize();
 protected:
 	bool m_enable = true;
@@ -55,6 +63,7 @@ protected:
 	int m_perMaterialDescriptorCount = 0;
 
 	std::shared_ptr<MeshGeometry> m_geometry;
+	DirectX::BoundingBox m_bounds;
 	std::vector<RenderItem> m_renderItems;
 
 	//for MaterialCBIndex
@@ -68,17 +77,23 @@ protected:
 	int m_HeapAllocationDirty = FramesCount;
 
 	std::vector<std::unique_ptr<InstanceConstantsBuffer>> m_instanceCBs;
-	int m_InstanceUpdateDirty = FramesCount; // meshInstance  updateؾҶ
-	int m_instanceBufferDirty = FramesCount; // m_maxInstanceCount  ޶
+	int m_InstanceUpdateDirty = FramesCount; // meshInstance 정보를 update해야할때
+	int m_instanceBufferDirty = FramesCount; // m_maxInstanceCount 가 달라졌을때
 
 	std::vector<std::unique_ptr<ObjectConstantsBuffer>> m_objectCB;
 
 	std::vector<std::shared_ptr<MeshInstance>> m_meshInstances;
+	//컬링 후 인스턴스 버퍼 앞쪽에 모은 인스턴스 개수, 드로우에 사용
+	UINT m_visibleInstanceCount = 0;
+	bool m_isCulling = false;
 
 	uint32_t m_maxInstanceCount = 5;
 	NumberAllocator m_numberAllocator;
+	//핸들 번호로 인덱싱
+	std::vector<std::weak_ptr<MeshInstance>> m_instancesByHandle;
 
 	Skeleton m_skeleton;
 
 	MeshType m_meshType = MeshType::StaticMesh;
+	SkinningModes m_skinningMode = SkinningModes::Linear;
 };
\ No newline at end of file
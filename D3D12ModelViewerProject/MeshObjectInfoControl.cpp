@@ -52,6 +52,15 @@ void MeshObjectInfoControl::Show()
 		{
 			meshObject->SetTransform(transform);
 		}
+
+		if (meshObject->GetMeshType() == MeshType::DynamicMesh)
+		{
+			bool dualQuaternion = meshObject->GetSkinningMode() == SkinningModes::DualQuaternion;
+			if (ImGui::Checkbox("Dual Quaternion Skinning", &dualQuaternion))
+			{
+				meshObject->SetSkinningMode(dualQuaternion ? SkinningModes::DualQuaternion : SkinningModes::Linear);
+			}
+		}
 	}
 
 	if (ImGui::CollapsingHeader("Mesh Materials"))
@@ -98,7 +107,7 @@ void MeshObjectInfoControl::Show()
 		ImGui::Separator();
 
 		int treeId = 0;
-		std::vector<size_t> deletedItems;
+		std::vector<NumberHandle> deletedItems;
 
 		for (auto& meshInstance : meshObject->GetMeshInstances())
 		{
@@ -106,7 +115,7 @@ void MeshObjectInfoControl::Show()
 				ImGuiTreeNodeFlags_OpenOnDoubleClick |
 				ImGuiTreeNodeFlags_SpanAvailWidth;
 
-			//׸߰  þ 
+			//항목추가 및 선택아이템 변경
 			if (ImGui::TreeNodeEx((void*)(intptr_t)treeId, node_flags, meshInstance->GetName().c_str()))
 			{
 				string popupId = "meshInstancePopup";
@@ -124,7 +133,7 @@ void MeshObjectInfoControl::Show()
 				{
 					if (ImGui::Selectable("Delete"))
 					{
-						deletedItems.push_back(treeId);
+						deletedItems.push_back(meshInstance->GetHandle());
 					}
 					ImGui::EndPopup();
 				}
@@ -176,6 +185,9 @@ void MeshObjectInfoControl::Show()
 					ImGui::EndListBox();
 				}
 
+				ImGui::SetNextItemWidth(200.0f);
+				ImGui::DragFloat("Blend Time", &m_blendTime, 0.01f, 0.0f, 2.0f);
+
 				if (ImGui::Button("Play"))
 				{
 					if (animations != nullptr)
@@ -183,7 +195,21 @@ void MeshObjectInfoControl::Show()
 						auto iter = animations->find(m_selectedAnimation);
 						if (iter != animations->end())
 						{
-							meshInstance->SetAnimation(iter->second);
+							meshInstance->SetAnimation(iter->second, true, true, m_blendTime);
+						}
+					}
+				}
+
+				//임포트때 구운 클립만 가능, 루프 재생
+				ImGui::SameLine();
+				if (ImGui::Button("Play Baked"))
+				{
+					if (animations != nullptr)
+					{
+						auto iter = animations->find(m_selectedAnimation);
+						if (iter != animations->end())
+						{
+							meshInstance->SetBakedAnimation(iter->second);
 						}
 					}
 				}
@@ -209,6 +235,7 @@ void MeshObjectInfoControl::Show()
 			}
 			treeId++;
 		}//end meshInstance for
+		//인덱스가 당겨져도 핸들은 그대로
 		for (auto& item : deletedItems)
 		{
 			meshObject->DeleteMeshInstance(item);
@@ -7,7 +7,7 @@
 struct MeshObjectInfoModel
 {
 	std::weak_ptr<MeshObject> MeshObject;
-	std::weak_ptr<std::map<std::string, AnimationClip>> Animations;
+	std::weak_ptr<std::map<std::string, std::shared_ptr<const AnimationClip>>> Animations;
 };
 
 class MeshObjectInfoControl
@@ -29,5 +29,7 @@ private:
 	std::weak_ptr<MeshInstance> m_currentMeshInstance;
 
 	std::string m_selectedAnimation;
+	//재생중인 클립에서 크로스페이드하는 시간
+	float m_blendTime = 0.2f;
 
 };
\ No newline at end of file
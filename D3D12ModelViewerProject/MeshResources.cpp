@@ -35,12 +35,64 @@ MeshResources::MeshResources(MeshResourcesInfo& modelResourceInfo)
 		subGeo.IndexCount = subMesh.size();
 		subGeo.StartIndexLocation = startIndexLocation;
 
+		//바인드포즈 기준 바운딩박스
+		if (subMesh.empty() == false)
+		{
+			XMVECTOR minPosition = XMVectorReplicate(FLT_MAX);
+			XMVECTOR maxPosition = XMVectorReplicate(-FLT_MAX);
+			for (IndexBufferFormat index : subMesh)
+			{
+				XMVECTOR position = XMLoadFloat3(&vertexTable[index].Pos);
+				minPosition = XMVectorMin(minPosition, position);
+				maxPosition = XMVectorMax(maxPosition, position);
+			}
+			BoundingBox::CreateFromPoints(subGeo.Bounds, minPosition, maxPosition);
+		}
+
 		indexTable.insert(indexTable.end(), subMesh.begin(), subMesh.end());
 		startIndexLocation += subMesh.size();
 
 		geo->DrawArgs[materialName] = subGeo;
 	}
 
+	//본별 바운딩박스, 가중치가 0인 영향은 제외
+	if (Skeleton.Joints.empty() == false)
+	{
+		const size_t jointCount = Skeleton.Joints.size();
+		std::vector<XMVECTOR> minPositions(jointCount, XMVectorReplicate(FLT_MAX));
+		std::vector<XMVECTOR> maxPositions(jointCount, XMVectorReplicate(-FLT_MAX));
+		std::vector<bool> isInfluenced(jointCount, false);
+
+		for (const Vertex& vertex : vertexTable)
+		{
+			const UINT indices[4] = { vertex.BoneIndices.x, vertex.BoneIndices.y, vertex.BoneIndices.z, vertex.BoneIndices.w };
+			const float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, vertex.BoneWeights.w };
+			XMVECTOR position = XMLoadFloat3(&vertex.Pos);
+			for (int i = 0; i < 4; ++i)
+			{
+				if (weights[i] <= 0.0f || indices[i] >= jointCount)
+				{
+					continue;
+				}
+				minPositions[indices[i]] = XMVectorMin(minPositions[indices[i]], position);
+				maxPositions[indices[i]] = XMVectorMax(maxPositions[indices[i]], position);
+				isInfluenced[indices[i]] = true;
+			}
+		}
+
+		Skeleton.SkinnedJointBounds.clear();
+		for (size_t jointIndex = 0; jointIndex < jointCount; ++jointIndex)
+		{
+			if (isInfluenced[jointIndex])
+			{
+				JointBounds jointBounds;
+				jointBounds.JointIndex = static_cast<UINT>(jointIndex);
+				BoundingBox::CreateFromPoints(jointBounds.Bounds, minPositions[jointIndex], maxPositions[jointIndex]);
+				Skeleton.SkinnedJointBounds.push_back(jointBounds);
+			}
+		}
+	}
+
 	const UINT vbByteSize = (UINT)vertexTable.size() * sizeof(Vertex);
 	const UINT ibByteSize = (UINT)indexTable.size() * sizeof(IndexBufferFormat);
 
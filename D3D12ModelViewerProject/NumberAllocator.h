@@ -1,22 +1,62 @@
 #pragma once
 
-#include "VariableAllocationManager.h"
+#include <stdint.h>
+#include <vector>
 
+//번호와 세대, 번호가 재사용되면 세대가 올라가 이전 핸들은 무효가 됨
+struct NumberHandle
+{
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+	uint32_t Index = InvalidIndex;
+	uint32_t Generation = 0;
+
+	bool IsNull() const { return Index == InvalidIndex; }
+	bool operator==(const NumberHandle& rhs) const { return Index == rhs.Index && Generation == rhs.Generation; }
+	bool operator!=(const NumberHandle& rhs) const { return (*this == rhs) == false; }
+};
+
+//해제된 번호를 먼저 재사용, 없으면 새 번호
 class NumberAllocator
 {
 public:
-	NumberAllocator(int maxSize = 100000) :
-		m_manager(maxSize) {}
-public:
-	size_t Allocate()
+	NumberHandle Allocate()
 	{
-		return m_manager.Allocate(1);
+		NumberHandle handle;
+		if (m_freeIndices.empty() == false)
+		{
+			handle.Index = m_freeIndices.back();
+			m_freeIndices.pop_back();
+		}
+		else
+		{
+			handle.Index = static_cast<uint32_t>(m_generations.size());
+			m_generations.push_back(0);
+		}
+		handle.Generation = m_generations[handle.Index];
+		return handle;
 	}
 
-	void Free(size_t number)
+	//이미 해제된 핸들은 무시
+	void Free(NumberHandle handle)
 	{
-		m_manager.Free(number, 1);
+		if (IsValid(handle) == false)
+		{
+			return;
+		}
+		m_generations[handle.Index]++;
+		m_freeIndices.push_back(handle.Index);
 	}
+
+	bool IsValid(NumberHandle handle) const
+	{
+		return handle.Index < m_generations.size() && m_generations[handle.Index] == handle.Generation;
+	}
+
+	//지금까지 만든 번호 개수, 번호로 인덱싱하는 배열 크기로 사용
+	size_t GetCapacity() const { return m_generations.size(); }
 private:
-	VariableSizeAllocationsManager m_manager;
-};
\ No newline at end of file
+	//번호별 현재 세대
+	std::vector<uint32_t> m_generations;
+	std::vector<uint32_t> m_freeIndices;
+};
@@ -65,7 +65,7 @@ bool SceneHierachyControl::ShowSceneHierachyRecursively(std::shared_ptr<SceneObj
 		node_flags |= ImGuiTreeNodeFlags_Leaf;
 	}
 
-	//׸߰  þ  
+	//항목추가 및 선택아이템 변경 
 	if (ImGui::TreeNodeEx((void*)(intptr_t)id, node_flags, objectName.c_str()))
 	{
 		if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None))
@@ -7,7 +7,7 @@
 struct SceneHierachyModel
 {
 	std::weak_ptr<Scene> scene;
-	std::weak_ptr<std::map<std::string, AnimationClip>> Animations;
+	std::weak_ptr<std::map<std::string, std::shared_ptr<const AnimationClip>>> Animations;
 };
 
 class SceneHierachyControl
@@ -19,7 +19,7 @@ public:
 	void Initialize(SceneHierachyModel viewModel);
 private:
 	void MeshObjectInfoControlInitialize();
-	//rootScene id = -1
+	//rootScene은 id = -1
 	bool ShowSceneHierachyRecursively(std::shared_ptr<SceneObject> sceneObject, int id = -1);
 
 private:
@@ -36,16 +36,37 @@ cbuffer cbPass : register(b0)
 cbuffer ObjectConstant : register(b1)
 {
     float4x4 gObjectTransform;
+    uint gSkinningMode;
 };
+#define SKINNING_MODE_DUAL_QUATERNION 1
 
 struct InstanceData
 {
     float4x4 World;
     uint NumOfBones;
+    uint AnimationOffset;
+    uint BakedClipId;
+    float BakedTimeOffset;
 };
-struct InstanceAnimation
+#define BAKED_CLIP_NONE 0xffffffff
+
+//4x4 스키닝 행렬을 전치한 상위 3행, 인스턴스 팔레트와 구운 팔레트 모두 사용
+struct BoneTransform3x4
+{
+    float4 Rows[3];
+};
+//스케일을 뺀 회전(Real), 이동(Dual)
+struct DualQuaternion
+{
+    float4 Real;
+    float4 Dual;
+};
+struct BakedClip
 {
-    float4x4 BoneTransform;
+    uint PaletteOffset;
+    uint FrameCount;
+    float FramePerSecond;
+    uint BoneCount;
 };
 
 cbuffer PBRMaterial : register(b2)
@@ -59,8 +80,76 @@ cbuffer PBRMaterial : register(b2)
 
 Texture2D gAlbedoMap : register(t0);
 StructuredBuffer<InstanceData> gInstanceData : register(t0, space1);
-StructuredBuffer<InstanceAnimation> gInstanceAnimation : register(t0, space2);
+StructuredBuffer<BoneTransform3x4> gInstanceAnimation : register(t0, space2);
+StructuredBuffer<DualQuaternion> gInstanceDualQuaternions : register(t1, space2);
 StructuredBuffer<Light> gLights : register(t0, space3);
+StructuredBuffer<BoneTransform3x4> gBakedPalettes : register(t0, space4);
+StructuredBuffer<BakedClip> gBakedClips : register(t1, space4);
+
+//BakedAnimation::Sample과 같은 계산, 루프로 되감고 두 프레임을 선형보간
+float3x4 GetBakedBoneTransform(InstanceData instData, uint boneIndex)
+{
+    BakedClip clip = gBakedClips[instData.BakedClipId];
+    
+    float frame = (gTotalTime + instData.BakedTimeOffset) * clip.FramePerSecond;
+    float frameCount = (float) clip.FrameCount;
+    frame = frame - floor(frame / frameCount) * frameCount;
+    float baseFrame = floor(frame);
+    
+    float alpha = frame - baseFrame;
+    uint frame0 = min((uint) baseFrame, clip.FrameCount - 1);
+    uint frame1 = min(frame0 + 1, clip.FrameCount - 1);
+    
+    BoneTransform3x4 bone0 = gBakedPalettes[clip.PaletteOffset + frame0 * clip.BoneCount + boneIndex];
+    BoneTransform3x4 bone1 = gBakedPalettes[clip.PaletteOffset + frame1 * clip.BoneCount + boneIndex];
+    
+    return float3x4(
+        lerp(bone0.Rows[0], bone1.Rows[0], alpha),
+        lerp(bone0.Rows[1], bone1.Rows[1], alpha),
+        lerp(bone0.Rows[2], bone1.Rows[2], alpha));
+}
+
+float3x4 GetBoneTransform(InstanceData instData, uint boneIndex)
+{
+    if (instData.BakedClipId != BAKED_CLIP_NONE)
+    {
+        return GetBakedBoneTransform(instData, boneIndex);
+    }
+    BoneTransform3x4 bone = gInstanceAnimation[instData.AnimationOffset + boneIndex];
+    return float3x4(bone.Rows[0], bone.Rows[1], bone.Rows[2]);
+}
+
+//Skinning::BlendDualQuaternions와 같은 계산
+DualQuaternion BlendDualQuaternions(InstanceData instData, uint4 boneIndices, float4 boneWeights)
+{
+    DualQuaternion result = (DualQuaternion) 0.0f;
+    float4 pivot = gInstanceDualQuaternions[instData.AnimationOffset + boneIndices[0]].Real;
+    
+    for (int i = 0; i < 4; ++i)
+    {
+        DualQuaternion bone = gInstanceDualQuaternions[instData.AnimationOffset + boneIndices[i]];
+        float weight = dot(bone.Real, pivot) < 0.0f ? -boneWeights[i] : boneWeights[i];
+        
+        result.Real += weight * bone.Real;
+        result.Dual += weight * bone.Dual;
+    }
+    
+    float invLength = 1.0f / length(result.Real);
+    result.Real *= invLength;
+    result.Dual *= invLength;
+    return result;
+}
+
+float3 RotateByQuaternion(float4 q, float3 v)
+{
+    return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+float3 TransformByDualQuaternion(DualQuaternion dq, float3 position)
+{
+    float3 translation = 2.0f * (dq.Real.w * dq.Dual.xyz - dq.Dual.w * dq.Real.xyz + cross(dq.Real.xyz, dq.Dual.xyz));
+    return RotateByQuaternion(dq.Real, position) + translation;
+}
 
 struct VertexIn
 {
@@ -84,17 +173,27 @@ VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID)
     VertexOut vout = (VertexOut) 0.0f;
 
     InstanceData instData = gInstanceData[instanceID];
-    int animationStartIndex = instData.NumOfBones * instanceID;
     
     float3 posL = float3(0.0f, 0.0f, 0.0f);
     float3 normalL = float3(0.0f, 0.0f, 0.0f);
     
-    for (int i = 0; i < 4; ++i)
+    //구운 클립은 3x4 팔레트뿐이라 선형 스키닝
+    if (gSkinningMode == SKINNING_MODE_DUAL_QUATERNION && instData.BakedClipId == BAKED_CLIP_NONE)
+    {
+        DualQuaternion dq = BlendDualQuaternions(instData, vin.BoneIndices, vin.BoneWeights);
+        
+        posL = TransformByDualQuaternion(dq, vin.PosL);
+        normalL = RotateByQuaternion(dq.Real, vin.NormalL);
+    }
+    else
     {
-        InstanceAnimation instanceAnimation = gInstanceAnimation[animationStartIndex + vin.BoneIndices[i]];
+        for (int i = 0; i < 4; ++i)
+        {
+            float3x4 boneTransform = GetBoneTransform(instData, vin.BoneIndices[i]);
         
-        posL += vin.BoneWeights[i] * mul(float4(vin.PosL, 1.0f), instanceAnimation.BoneTransform).xyz;
-        normalL += vin.BoneWeights[i] * mul(vin.NormalL, (float3x3) instanceAnimation.BoneTransform);
+            posL += vin.BoneWeights[i] * mul(boneTransform, float4(vin.PosL, 1.0f));
+            normalL += vin.BoneWeights[i] * mul((float3x3) boneTransform, vin.NormalL);
+        }
     }
 
     vin.PosL = posL;
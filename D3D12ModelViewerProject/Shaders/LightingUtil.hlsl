@@ -107,7 +107,7 @@ float3 CalculateColor(float3 radiance, float3 albedo, float3 toLight, float3 toE
         
     float3 numerator = NDF * F * G;
     float NdotL = max(dot(normal, toLight), 0.0f);
-    float denominator = 4.0 * max(dot(normal, toEyeW), 0.0f) * NdotL + 0.0001f; // 0  0.0001
+    float denominator = 4.0 * max(dot(normal, toEyeW), 0.0f) * NdotL + 0.0001f; // 0으로 나눌수없게 0.0001을더함
     float3 specular = numerator / denominator;
     
     return ((kD * albedo / M_PI) + specular) * radiance * NdotL;
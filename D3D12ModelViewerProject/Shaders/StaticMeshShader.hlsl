@@ -42,6 +42,9 @@ struct InstanceData
 {
     float4x4 World;
     uint NumOfBones;
+    uint AnimationOffset;
+    uint BakedClipId;
+    float BakedTimeOffset;
 };
 
 //cbuffer MaterialData : register(b2)
@@ -0,0 +1,292 @@
+#include "Skinning.h"
+#include <intrin.h>
+
+using namespace DirectX;
+
+DualQuaternionTransform Skinning::ToDualQuaternion(const BoneTransform3x4& boneTransform)
+{
+	XMMATRIX transposed(
+		XMLoadFloat4(&boneTransform.Rows[0]),
+		XMLoadFloat4(&boneTransform.Rows[1]),
+		XMLoadFloat4(&boneTransform.Rows[2]),
+		g_XMIdentityR3);
+	XMMATRIX matrix = XMMatrixTranspose(transposed);
+
+	XMVECTOR scale, rotation, translation;
+	if (XMMatrixDecompose(&scale, &rotation, &translation, matrix) == false)
+	{
+		rotation = XMQuaternionIdentity();
+		translation = matrix.r[3];
+	}
+	rotation = XMQuaternionNormalize(rotation);
+
+	//dual = 0.5 * t * r
+	XMVECTOR pureTranslation = XMVectorSelect(g_XMZero, translation, g_XMSelect1110);
+	XMVECTOR dual = XMVectorScale(XMQuaternionMultiply(rotation, pureTranslation), 0.5f);
+
+	DualQuaternionTransform result;
+	XMStoreFloat4(&result.Real, rotation);
+	XMStoreFloat4(&result.Dual, dual);
+	return result;
+}
+
+void Skinning::ToDualQuaternions(const BoneTransform3x4* palette, DualQuaternionTransform* result, size_t boneCount)
+{
+	for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		result[boneIndex] = ToDualQuaternion(palette[boneIndex]);
+	}
+}
+
+void Skinning::BlendDualQuaternions(const DualQuaternionTransform* palette, const XMUINT4& boneIndices, const XMFLOAT4& boneWeights,
+	XMVECTOR& real, XMVECTOR& dual)
+{
+	const UINT indices[4] = { boneIndices.x, boneIndices.y, boneIndices.z, boneIndices.w };
+	const float weights[4] = { boneWeights.x, boneWeights.y, boneWeights.z, boneWeights.w };
+
+	XMVECTOR pivot = XMLoadFloat4(&palette[indices[0]].Real);
+	real = XMVectorZero();
+	dual = XMVectorZero();
+	for (int i = 0; i < 4; ++i)
+	{
+		XMVECTOR boneReal = XMLoadFloat4(&palette[indices[i]].Real);
+		XMVECTOR boneDual = XMLoadFloat4(&palette[indices[i]].Dual);
+
+		float weight = XMVectorGetX(XMVector4Dot(boneReal, pivot)) < 0.0f ? -weights[i] : weights[i];
+		real = XMVectorMultiplyAdd(boneReal, XMVectorReplicate(weight), real);
+		dual = XMVectorMultiplyAdd(boneDual, XMVectorReplicate(weight), dual);
+	}
+
+	XMVECTOR length = XMVector4Length(real);
+	real = XMVectorDivide(real, length);
+	dual = XMVectorDivide(dual, length);
+}
+
+XMVECTOR XM_CALLCONV Skinning::TransformPosition(FXMVECTOR real, FXMVECTOR dual, FXMVECTOR position)
+{
+	//t = 2 * (r.w * d.xyz - d.w * r.xyz + r.xyz x d.xyz)
+	XMVECTOR realW = XMVectorSplatW(real);
+	XMVECTOR dualW = XMVectorSplatW(dual);
+	XMVECTOR translation = XMVectorSubtract(XMVectorMultiply(realW, dual), XMVectorMultiply(dualW, real));
+	translation = XMVectorScale(XMVectorAdd(translation, XMVector3Cross(real, dual)), 2.0f);
+
+	return XMVectorAdd(TransformNormal(real, position), translation);
+}
+
+XMVECTOR XM_CALLCONV Skinning::TransformNormal(FXMVECTOR real, FXMVECTOR normal)
+{
+	//v + 2 * r.xyz x (r.xyz x v + r.w * v)
+	XMVECTOR inner = XMVectorMultiplyAdd(XMVectorSplatW(real), normal, XMVector3Cross(real, normal));
+	XMVECTOR result = XMVectorMultiplyAdd(XMVector3Cross(real, inner), XMVectorReplicate(2.0f), normal);
+	return XMVectorSelect(g_XMZero, result, g_XMSelect1110);
+}
+
+namespace
+{
+	//3x4 행렬 행으로 박스를 옮겨서 min, max에 합침
+	void XM_CALLCONV MergeTransformedBounds(FXMVECTOR row0, FXMVECTOR row1, FXMVECTOR row2, const BoundingBox& bounds,
+		XMVECTOR& minPosition, XMVECTOR& maxPosition)
+	{
+		//중심은 그대로 변환, 반크기는 회전 스케일 성분의 절대값으로 변환
+		XMVECTOR center = XMVectorSetW(XMLoadFloat3(&bounds.Center), 1.0f);
+		XMVECTOR extents = XMLoadFloat3(&bounds.Extents);
+
+		XMVECTOR newCenter = XMVectorMergeXY(XMVector4Dot(row0, center), XMVector4Dot(row1, center));
+		newCenter = XMVectorPermute<XM_PERMUTE_0X, XM_PERMUTE_0Y, XM_PERMUTE_1Z, XM_PERMUTE_1W>(newCenter, XMVector4Dot(row2, center));
+
+		XMVECTOR newExtents = XMVectorMergeXY(XMVector3Dot(XMVectorAbs(row0), extents), XMVector3Dot(XMVectorAbs(row1), extents));
+		newExtents = XMVectorPermute<XM_PERMUTE_0X, XM_PERMUTE_0Y, XM_PERMUTE_1Z, XM_PERMUTE_1W>(newExtents, XMVector3Dot(XMVectorAbs(row2), extents));
+
+		minPosition = XMVectorMin(minPosition, XMVectorSubtract(newCenter, newExtents));
+		maxPosition = XMVectorMax(maxPosition, XMVectorAdd(newCenter, newExtents));
+	}
+}
+
+void Skinning::MergeSkinnedBounds(const BoneTransform3x4& bone, const BoundingBox& jointBounds, XMVECTOR& minPosition, XMVECTOR& maxPosition)
+{
+	MergeTransformedBounds(XMLoadFloat4(&bone.Rows[0]), XMLoadFloat4(&bone.Rows[1]), XMLoadFloat4(&bone.Rows[2]), jointBounds,
+		minPosition, maxPosition);
+}
+
+void XM_CALLCONV Skinning::CreateSkinnedBounds(bool isEmpty, FXMVECTOR minPosition, FXMVECTOR maxPosition, BoundingBox& result)
+{
+	if (isEmpty)
+	{
+		BoundingBox::CreateFromPoints(result, XMVectorZero(), XMVectorZero());
+	}
+	else
+	{
+		BoundingBox::CreateFromPoints(result, minPosition, maxPosition);
+	}
+}
+
+void Skinning::ComputeSkinnedBounds(const BoneTransform3x4* palette, const std::vector<JointBounds>& jointBounds, BoundingBox& result)
+{
+	XMVECTOR minPosition = XMVectorReplicate(FLT_MAX);
+	XMVECTOR maxPosition = XMVectorReplicate(-FLT_MAX);
+
+	for (const JointBounds& joint : jointBounds)
+	{
+		MergeSkinnedBounds(palette[joint.JointIndex], joint.Bounds, minPosition, maxPosition);
+	}
+
+	CreateSkinnedBounds(jointBounds.empty(), minPosition, maxPosition, result);
+}
+
+void Skinning::ComputeSkinnedBounds(const DualQuaternionTransform* palette, const std::vector<JointBounds>& jointBounds, BoundingBox& result)
+{
+	XMVECTOR minPosition = XMVectorReplicate(FLT_MAX);
+	XMVECTOR maxPosition = XMVectorReplicate(-FLT_MAX);
+
+	for (const JointBounds& joint : jointBounds)
+	{
+		const DualQuaternionTransform& bone = palette[joint.JointIndex];
+		XMVECTOR real = XMLoadFloat4(&bone.Real);
+		XMVECTOR dual = XMLoadFloat4(&bone.Dual);
+
+		//회전 행렬을 전치해서 행으로, 이동은 원점을 옮긴 위치
+		XMMATRIX rotation = XMMatrixTranspose(XMMatrixRotationQuaternion(real));
+		XMVECTOR translation = TransformPosition(real, dual, XMVectorZero());
+		MergeTransformedBounds(
+			XMVectorSetW(rotation.r[0], XMVectorGetX(translation)),
+			XMVectorSetW(rotation.r[1], XMVectorGetY(translation)),
+			XMVectorSetW(rotation.r[2], XMVectorGetZ(translation)),
+			joint.Bounds, minPosition, maxPosition);
+	}
+
+	CreateSkinnedBounds(jointBounds.empty(), minPosition, maxPosition, result);
+}
+
+void Skinning::SkinVerticesScalar(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+	XMFLOAT3* positions, XMFLOAT3* normals)
+{
+	for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const Vertex& vertex = vertices[vertexIndex];
+		const UINT indices[4] = { vertex.BoneIndices.x, vertex.BoneIndices.y, vertex.BoneIndices.z, vertex.BoneIndices.w };
+		const float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, vertex.BoneWeights.w };
+
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float normal[3] = { 0.0f, 0.0f, 0.0f };
+		for (int i = 0; i < 4; ++i)
+		{
+			const BoneTransform3x4& bone = palette[indices[i]];
+			for (int row = 0; row < 3; ++row)
+			{
+				const XMFLOAT4& r = bone.Rows[row];
+				position[row] += weights[i] * (r.x * vertex.Pos.x + r.y * vertex.Pos.y + r.z * vertex.Pos.z + r.w);
+				normal[row] += weights[i] * (r.x * vertex.Normal.x + r.y * vertex.Normal.y + r.z * vertex.Normal.z);
+			}
+		}
+
+		positions[vertexIndex] = XMFLOAT3(position[0], position[1], position[2]);
+		if (normals != nullptr)
+		{
+			normals[vertexIndex] = XMFLOAT3(normal[0], normal[1], normal[2]);
+		}
+	}
+}
+
+bool Skinning::IsAvx2Supported()
+{
+	static const bool isSupported = []()
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo, 0);
+		if (cpuInfo[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(cpuInfo, 1);
+		const bool hasFma = (cpuInfo[2] & (1 << 12)) != 0;
+		const bool hasOsxsave = (cpuInfo[2] & (1 << 27)) != 0;
+		const bool hasAvx = (cpuInfo[2] & (1 << 28)) != 0;
+		if (hasFma == false || hasOsxsave == false || hasAvx == false)
+		{
+			return false;
+		}
+
+		//OS가 XMM, YMM 상태를 저장해야 함
+		if ((_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(cpuInfo, 7, 0);
+		return (cpuInfo[1] & (1 << 5)) != 0;
+	}();
+	return isSupported;
+}
+
+void Skinning::SkinVertices(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+	XMFLOAT3* positions, XMFLOAT3* normals)
+{
+	if (IsAvx2Supported())
+	{
+		SkinVerticesAvx2(vertices, vertexCount, palette, positions, normals);
+	}
+	else
+	{
+		SkinVerticesSse2(vertices, vertexCount, palette, positions, normals);
+	}
+}
+
+void Skinning::SkinVerticesSse2(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+	XMFLOAT3* positions, XMFLOAT3* normals)
+{
+	for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const Vertex& vertex = vertices[vertexIndex];
+		const UINT indices[4] = { vertex.BoneIndices.x, vertex.BoneIndices.y, vertex.BoneIndices.z, vertex.BoneIndices.w };
+		const float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, vertex.BoneWeights.w };
+
+		//행렬이 선형이므로 섞은 행렬로 한번 변환한 것과 같음
+		XMVECTOR row0 = XMVectorZero();
+		XMVECTOR row1 = XMVectorZero();
+		XMVECTOR row2 = XMVectorZero();
+		for (int i = 0; i < 4; ++i)
+		{
+			if (weights[i] == 0.0f)
+			{
+				continue;
+			}
+			const BoneTransform3x4& bone = palette[indices[i]];
+			XMVECTOR weight = XMVectorReplicate(weights[i]);
+			row0 = XMVectorMultiplyAdd(XMLoadFloat4(&bone.Rows[0]), weight, row0);
+			row1 = XMVectorMultiplyAdd(XMLoadFloat4(&bone.Rows[1]), weight, row1);
+			row2 = XMVectorMultiplyAdd(XMLoadFloat4(&bone.Rows[2]), weight, row2);
+		}
+
+		XMVECTOR position = XMVectorSetW(XMLoadFloat3(&vertex.Pos), 1.0f);
+		XMVECTOR skinnedPosition = XMVectorMergeXY(XMVector4Dot(row0, position), XMVector4Dot(row1, position));
+		skinnedPosition = XMVectorPermute<XM_PERMUTE_0X, XM_PERMUTE_0Y, XM_PERMUTE_1Z, XM_PERMUTE_1W>(skinnedPosition, XMVector4Dot(row2, position));
+		XMStoreFloat3(&positions[vertexIndex], skinnedPosition);
+
+		if (normals != nullptr)
+		{
+			XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
+			XMVECTOR skinnedNormal = XMVectorMergeXY(XMVector3Dot(row0, normal), XMVector3Dot(row1, normal));
+			skinnedNormal = XMVectorPermute<XM_PERMUTE_0X, XM_PERMUTE_0Y, XM_PERMUTE_1Z, XM_PERMUTE_1W>(skinnedNormal, XMVector3Dot(row2, normal));
+			XMStoreFloat3(&normals[vertexIndex], skinnedNormal);
+		}
+	}
+}
+
+void Skinning::SkinVertices(const Vertex* vertices, size_t vertexCount, const DualQuaternionTransform* palette,
+	XMFLOAT3* positions, XMFLOAT3* normals)
+{
+	for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const Vertex& vertex = vertices[vertexIndex];
+
+		XMVECTOR real, dual;
+		BlendDualQuaternions(palette, vertex.BoneIndices, vertex.BoneWeights, real, dual);
+
+		XMStoreFloat3(&positions[vertexIndex], TransformPosition(real, dual, XMLoadFloat3(&vertex.Pos)));
+		if (normals != nullptr)
+		{
+			XMStoreFloat3(&normals[vertexIndex], TransformNormal(real, XMLoadFloat3(&vertex.Normal)));
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "FbxUtil.h"
+
+//팔레트 변환과 DynamicMeshShader.hlsl 스키닝의 CPU 버전
+namespace Skinning
+{
+	//3x4 팔레트에서 스케일을 뺀 회전, 이동을 듀얼쿼터니언으로
+	DualQuaternionTransform ToDualQuaternion(const BoneTransform3x4& boneTransform);
+	void ToDualQuaternions(const BoneTransform3x4* palette, DualQuaternionTransform* result, size_t boneCount);
+
+	//가중치 4개를 첫 본과 같은 반구로 맞춰서 더한 뒤 정규화
+	void BlendDualQuaternions(const DualQuaternionTransform* palette, const DirectX::XMUINT4& boneIndices, const DirectX::XMFLOAT4& boneWeights,
+		DirectX::XMVECTOR& real, DirectX::XMVECTOR& dual);
+	DirectX::XMVECTOR XM_CALLCONV TransformPosition(DirectX::FXMVECTOR real, DirectX::FXMVECTOR dual, DirectX::FXMVECTOR position);
+	DirectX::XMVECTOR XM_CALLCONV TransformNormal(DirectX::FXMVECTOR real, DirectX::FXMVECTOR normal);
+
+	//본 바운딩박스를 팔레트로 옮겨 합친 박스, 선형 스키닝 결과를 항상 포함함
+	void ComputeSkinnedBounds(const BoneTransform3x4* palette, const std::vector<JointBounds>& jointBounds, DirectX::BoundingBox& result);
+	//스케일 없는 강체 변환으로 옮겨 합친 박스, 듀얼쿼터니언 스키닝은 이 박스와 선형 박스를 합쳐서 씀
+	void ComputeSkinnedBounds(const DualQuaternionTransform* palette, const std::vector<JointBounds>& jointBounds, DirectX::BoundingBox& result);
+	//ComputeSkinnedBounds를 본 하나씩, min, max는 FLT_MAX, -FLT_MAX로 시작
+	void MergeSkinnedBounds(const BoneTransform3x4& bone, const DirectX::BoundingBox& jointBounds, DirectX::XMVECTOR& minPosition, DirectX::XMVECTOR& maxPosition);
+	//합친 min, max로 박스를 만듦, 본 바운딩박스가 없으면 원점
+	void XM_CALLCONV CreateSkinnedBounds(bool isEmpty, DirectX::FXMVECTOR minPosition, DirectX::FXMVECTOR maxPosition, DirectX::BoundingBox& result);
+
+	//정점 단위 스키닝, 결과는 스켈레톤 공간 (인스턴스, 오브젝트 변환 전)
+	//normals는 nullptr이면 계산하지 않음, 정규화하지 않음
+	//셰이더 식을 그대로 옮긴 비교용 버전
+	void SkinVerticesScalar(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+		DirectX::XMFLOAT3* positions, DirectX::XMFLOAT3* normals);
+	//가중치로 3x4 행렬을 먼저 섞고 한번만 변환하는 SIMD 버전, CPU가 지원하면 AVX2 커널 사용
+	void SkinVertices(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+		DirectX::XMFLOAT3* positions, DirectX::XMFLOAT3* normals);
+	//정점 하나씩 DirectXMath로
+	void SkinVerticesSse2(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+		DirectX::XMFLOAT3* positions, DirectX::XMFLOAT3* normals);
+	//정점 8개씩 gather, SkinningAvx2.cpp
+	void SkinVerticesAvx2(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+		DirectX::XMFLOAT3* positions, DirectX::XMFLOAT3* normals);
+	//AVX2, FMA 명령어와 OS의 YMM 레지스터 저장 지원
+	bool IsAvx2Supported();
+	void SkinVertices(const Vertex* vertices, size_t vertexCount, const DualQuaternionTransform* palette,
+		DirectX::XMFLOAT3* positions, DirectX::XMFLOAT3* normals);
+}
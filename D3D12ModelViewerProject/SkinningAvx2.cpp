@@ -0,0 +1,82 @@
+#include "Skinning.h"
+#include <immintrin.h>
+#include <cstddef>
+
+using namespace DirectX;
+
+//이 파일만 /arch:AVX2로 빌드, IsAvx2Supported일때만 호출해야함
+void Skinning::SkinVerticesAvx2(const Vertex* vertices, size_t vertexCount, const BoneTransform3x4* palette,
+	XMFLOAT3* positions, XMFLOAT3* normals)
+{
+	constexpr int VertexStride = sizeof(Vertex) / sizeof(float);
+	constexpr int BoneStride = sizeof(BoneTransform3x4) / sizeof(float);
+	static_assert(sizeof(Vertex) % sizeof(float) == 0 && sizeof(BoneTransform3x4) % sizeof(float) == 0, "gather offset must be float index");
+
+	const float* paletteBase = reinterpret_cast<const float*>(palette);
+	const __m256i laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(VertexStride));
+
+	size_t vertexIndex = 0;
+	for (; vertexIndex + 8 <= vertexCount; vertexIndex += 8)
+	{
+		//정점 8개를 레인마다 하나씩
+		const float* vertexBase = reinterpret_cast<const float*>(vertices + vertexIndex);
+		auto gatherVertex = [&](size_t offset)
+		{
+			return _mm256_i32gather_ps(vertexBase + offset / sizeof(float), laneOffsets, 4);
+		};
+
+		//가중치로 섞은 3x4 행렬, 원소 12개가 각각 8레인
+		__m256 blended[12];
+		for (__m256& element : blended)
+		{
+			element = _mm256_setzero_ps();
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			__m256 weight = gatherVertex(offsetof(Vertex, BoneWeights) + i * sizeof(float));
+			__m256i boneIndex = _mm256_i32gather_epi32(reinterpret_cast<const int*>(vertexBase) + (offsetof(Vertex, BoneIndices) / sizeof(float) + i), laneOffsets, 4);
+			__m256i boneOffset = _mm256_mullo_epi32(boneIndex, _mm256_set1_epi32(BoneStride));
+			for (int element = 0; element < 12; ++element)
+			{
+				blended[element] = _mm256_fmadd_ps(_mm256_i32gather_ps(paletteBase + element, boneOffset, 4), weight, blended[element]);
+			}
+		}
+
+		__m256 posX = gatherVertex(offsetof(Vertex, Pos));
+		__m256 posY = gatherVertex(offsetof(Vertex, Pos) + sizeof(float));
+		__m256 posZ = gatherVertex(offsetof(Vertex, Pos) + 2 * sizeof(float));
+
+		alignas(32) float result[3][8];
+		for (int row = 0; row < 3; ++row)
+		{
+			const __m256* r = blended + row * 4;
+			__m256 value = _mm256_fmadd_ps(r[0], posX, _mm256_fmadd_ps(r[1], posY, _mm256_fmadd_ps(r[2], posZ, r[3])));
+			_mm256_store_ps(result[row], value);
+		}
+		for (int lane = 0; lane < 8; ++lane)
+		{
+			positions[vertexIndex + lane] = XMFLOAT3(result[0][lane], result[1][lane], result[2][lane]);
+		}
+
+		if (normals != nullptr)
+		{
+			__m256 normalX = gatherVertex(offsetof(Vertex, Normal));
+			__m256 normalY = gatherVertex(offsetof(Vertex, Normal) + sizeof(float));
+			__m256 normalZ = gatherVertex(offsetof(Vertex, Normal) + 2 * sizeof(float));
+			for (int row = 0; row < 3; ++row)
+			{
+				const __m256* r = blended + row * 4;
+				__m256 value = _mm256_fmadd_ps(r[0], normalX, _mm256_fmadd_ps(r[1], normalY, _mm256_mul_ps(r[2], normalZ)));
+				_mm256_store_ps(result[row], value);
+			}
+			for (int lane = 0; lane < 8; ++lane)
+			{
+				normals[vertexIndex + lane] = XMFLOAT3(result[0][lane], result[1][lane], result[2][lane]);
+			}
+		}
+	}
+
+	//8개가 안되는 나머지
+	SkinVerticesSse2(vertices + vertexIndex, vertexCount - vertexIndex, palette,
+		positions + vertexIndex, normals != nullptr ? normals + vertexIndex : nullptr);
+}
@@ -26,7 +26,7 @@ void StaticMesh::Render(ID3D12GraphicsCommandList* cmdList, RenderType renderTyp
 {
 	int frameIndex = D3DResourceManager::GetInstance().GetCurrentFrameIndex();
 
-	if (m_enable == false)
+	if (m_enable == false || m_visibleInstanceCount == 0)
 	{
 		return;
 	}
@@ -67,7 +67,7 @@ void StaticMesh::Render(ID3D12GraphicsCommandList* cmdList, RenderType renderTyp
 
 		cmdList->DrawIndexedInstanced(
 			renderItem.IndexCount,
-			m_meshInstances.size(),
+			m_visibleInstanceCount,
 			renderItem.StartIndexLocation,
 			renderItem.BaseVertexLocation,
 			0
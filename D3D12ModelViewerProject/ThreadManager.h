@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
 #include "ThreadPool.h"
 
 class ThreadManager
@@ -15,10 +19,77 @@ public:
 	{
 		m_threadPool.EnqueueJob(std::move(func));
 	}
+
+	// [0, count) 를 워커쓰레드들과 호출한 쓰레드가 나눠서 처리하고 모두 끝날때까지 대기
+	// 호출한 쓰레드도 직접 처리하므로 워커쓰레드 안에서 호출해도 교착되지 않음
+	// func에서 발생한 예외는 호출한 쓰레드에서 다시 던짐
+	void ParallelFor(size_t count, std::function<void(size_t)> func)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		struct ParallelForState
+		{
+			std::function<void(size_t)> Func;
+			size_t Count = 0;
+			std::atomic<size_t> NextIndex = 0;
+			std::atomic<size_t> DoneCount = 0;
+			std::mutex Mutex;
+			std::condition_variable DoneCondition;
+			std::exception_ptr Exception;
+		};
+
+		//늦게 시작한 워커가 접근할수 있으므로 공유상태는 shared_ptr로 유지
+		auto state = std::make_shared<ParallelForState>();
+		state->Func = std::move(func);
+		state->Count = count;
+
+		auto work = [state]()
+		{
+			size_t index;
+			while ((index = state->NextIndex.fetch_add(1)) < state->Count)
+			{
+				try
+				{
+					state->Func(index);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(state->Mutex);
+					if (state->Exception == nullptr)
+					{
+						state->Exception = std::current_exception();
+					}
+				}
+
+				if (state->DoneCount.fetch_add(1) + 1 == state->Count)
+				{
+					std::lock_guard<std::mutex> lock(state->Mutex);
+					state->DoneCondition.notify_all();
+				}
+			}
+		};
+
+		size_t helperCount = (std::min)(count - 1, m_threadPool.GetThreadCount());
+		for (size_t i = 0; i < helperCount; ++i)
+		{
+			m_threadPool.EnqueueJob(work);
+		}
+		work();
+
+		std::unique_lock<std::mutex> lock(state->Mutex);
+		state->DoneCondition.wait(lock, [&state]() { return state->DoneCount == state->Count; });
+		if (state->Exception != nullptr)
+		{
+			std::rethrow_exception(state->Exception);
+		}
+	}
 private:
-	ThreadManager() :m_threadPool(4) {}
+	ThreadManager() :m_threadPool((std::max)<size_t>(4, std::thread::hardware_concurrency())) {}
 	ThreadManager(const ThreadManager&) = delete;
 	ThreadManager& operator=(const ThreadManager&) = delete;
 private:
 	ThreadPool m_threadPool;
-};
\ No newline at end of file
+};
@@ -23,12 +23,12 @@ void ThreadPool::WorkerThread()
 			return;
 		}
 
-		//   job  .
+		// 맨 앞의 job 을 뺀다.
 		std::function<void()> job = std::move(jobs_.front());
 		jobs_.pop();
 		lock.unlock();
 
-		// ش job  Ѵ :)
+		// 해당 job 을 수행한다 :)
 		job();
 	}
 }
@@ -48,7 +48,7 @@ void ThreadPool::EnqueueJob(std::function<void()> job)
 {
 	if (stop_all)
 	{
-		throw std::runtime_error("ThreadPool  ");
+		throw std::runtime_error("ThreadPool 사용 중지됨");
 	}
 
 	{
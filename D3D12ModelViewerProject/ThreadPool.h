@@ -16,22 +16,24 @@ public:
 	~ThreadPool();
 
 public:
-	// job  ߰Ѵ.
+	// job 을 추가한다.
 	void EnqueueJob(std::function<void()> job);
+
+	size_t GetThreadCount() const { return num_threads_; }
 private:
-	// Worker 
+	// Worker 쓰레드
 	void WorkerThread();
 private:
-	//  Worker  .
+	// 총 Worker 쓰레드의 개수.
 	size_t num_threads_;
 
-	// Worker 带 ϴ .
+	// Worker 쓰레드를 보관하는 벡터.
 	std::vector<std::thread> worker_threads_;
 
-	// ϵ ϴ job ť.
+	// 할일들을 보관하는 job 큐.
 	std::queue<std::function<void()>> jobs_;
 
-	//  job ť  cv  m.
+	// 위의 job 큐를 위한 cv 와 m.
 	std::condition_variable cv_job_q_;
 
 	std::mutex m_job_q_;
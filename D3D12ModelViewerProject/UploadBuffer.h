@@ -53,6 +53,8 @@ public:
 	{
 		memcpy(&m_mappedData[elementIndex * m_elementByteSize], pDataArray, sizeof(T) * elementCount);
 	}
+	//상수버퍼가 아닐때만 T 배열, write-combine 메모리라 쓰기만 해야함
+	T* GetMappedData() { return reinterpret_cast<T*>(m_mappedData); }
 	UINT GetElementByteSize() { return m_elementByteSize; }
 	UINT GetBufferByteSize() { return m_bufferSize; }
 	UINT GetMaxElementCount() { return m_elementCount; }
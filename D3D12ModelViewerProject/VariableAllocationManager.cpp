@@ -1,112 +1,497 @@
 #include "VariableAllocationManager.h"
+#include <cassert>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-void VariableSizeAllocationsManager::AddNewBlock(OffsetType Offset, OffsetType size)
+namespace
 {
-	auto newBlockIter = m_freeBlocksByOffset.emplace(Offset, size);
-	auto OrderIt = m_freeBlocksBySize.emplace(size, newBlockIter.first);
-	newBlockIter.first->second.OrderBySizeIt = OrderIt;
+	uint32_t FindLowestBit(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	uint32_t FindHighestBit(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	size_t HashOffset(OffsetType offset, size_t mask)
+	{
+		return static_cast<size_t>((static_cast<uint64_t>(offset) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+	}
 }
 
-OffsetType VariableSizeAllocationsManager::Allocate(OffsetType size)
+VariableSizeAllocationsManager::VariableSizeAllocationsManager(int MaxSize) : m_maxSize(MaxSize), m_freeSize(MaxSize)
 {
-	if (m_freeSize < size)
+	for (auto& freeLists : m_freeLists)
 	{
-		return InvalidOffset;
+		std::fill(std::begin(freeLists), std::end(freeLists), InvalidBlock);
 	}
+	m_allocatedTable.assign(16, InvalidBlock);
 
-	auto smallestBlockIterIter = m_freeBlocksBySize.lower_bound(size);
-	if (smallestBlockIterIter == m_freeBlocksBySize.end())
+	if (MaxSize > 0)
 	{
-		return InvalidOffset;
+		InsertFreeBlock(CreateBlock(0, MaxSize));
 	}
+}
 
-	auto smallestBlockIter = smallestBlockIterIter->second;
-	auto offset = smallestBlockIter->first;
-	auto newOffset = offset + size;
-	auto newSize = smallestBlockIter->second.Size - size;
+VariableSizeAllocationsManager::VariableSizeAllocationsManager(VariableSizeAllocationsManager&& rhs) noexcept
+{
+	m_blocks = std::move(rhs.m_blocks);
+	m_unusedBlocks = std::move(rhs.m_unusedBlocks);
+	m_firstLevelBitmap = rhs.m_firstLevelBitmap;
+	std::copy(std::begin(rhs.m_secondLevelBitmaps), std::end(rhs.m_secondLevelBitmaps), std::begin(m_secondLevelBitmaps));
+	for (uint32_t firstLevel = 0; firstLevel < FirstLevelCount; ++firstLevel)
+	{
+		std::copy(std::begin(rhs.m_freeLists[firstLevel]), std::end(rhs.m_freeLists[firstLevel]), std::begin(m_freeLists[firstLevel]));
+	}
+	m_allocatedTable = std::move(rhs.m_allocatedTable);
+	m_allocatedCount = rhs.m_allocatedCount;
+	m_maxSize = rhs.m_maxSize;
+	m_freeSize = rhs.m_freeSize;
+	m_freeBlockCount = rhs.m_freeBlockCount;
+	m_alignmentPaddingCount = rhs.m_alignmentPaddingCount;
+	m_alignmentPaddingSize = rhs.m_alignmentPaddingSize;
+	m_peakUsedSize = rhs.m_peakUsedSize;
+	m_allocateCount = rhs.m_allocateCount;
+	m_freeCount = rhs.m_freeCount;
+	m_failedAllocateCount = rhs.m_failedAllocateCount;
+}
 
-	m_freeBlocksBySize.erase(smallestBlockIterIter);
-	m_freeBlocksByOffset.erase(smallestBlockIter);
+void VariableSizeAllocationsManager::Mapping(OffsetType size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	//SecondLevelCount보다 작으면 1단계 0에 크기별로
+	if (size < SecondLevelCount)
+	{
+		firstLevel = 0;
+		secondLevel = static_cast<uint32_t>(size);
+		return;
+	}
 
-	if (newSize > 0)
+	uint32_t highestBit = FindHighestBit(size);
+	firstLevel = highestBit - SecondLevelLog2 + 1;
+	secondLevel = static_cast<uint32_t>(size >> (highestBit - SecondLevelLog2)) - SecondLevelCount;
+}
+
+uint32_t VariableSizeAllocationsManager::FindFreeBlock(OffsetType size, OffsetType alignment) const
+{
+	//리스트 안의 블록은 모두 size 이상이 되도록 다음 2단계 경계로 올림
+	//정렬이 있으면 앞쪽 패딩이 최대 alignment - 1이므로 그만큼 더 큰 블록을 찾음
+	OffsetType searchSize = size + alignment - 1;
+	if (searchSize >= SecondLevelCount)
 	{
-		AddNewBlock(newOffset, newSize);
+		searchSize += (OffsetType(1) << (FindHighestBit(searchSize) - SecondLevelLog2)) - 1;
 	}
 
-	m_freeSize -= size;
-	return offset;
+	uint32_t firstLevel, secondLevel;
+	Mapping(searchSize, firstLevel, secondLevel);
+
+	if (firstLevel < FirstLevelCount)
+	{
+		uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0)
+		{
+			uint64_t firstLevelMap = firstLevel + 1 < 64 ? m_firstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+			if (firstLevelMap != 0)
+			{
+				firstLevel = FindLowestBit(firstLevelMap);
+				secondLevelMap = m_secondLevelBitmaps[firstLevel];
+			}
+		}
+
+		if (secondLevelMap != 0)
+		{
+			return m_freeLists[firstLevel][FindLowestBit(secondLevelMap)];
+		}
+	}
+
+	//올림 때문에 못찾은 경우 size부터 올리기 전 크기까지의 리스트에서 직접 찾음
+	uint32_t lastFirstLevel, lastSecondLevel;
+	Mapping(size, firstLevel, secondLevel);
+	Mapping(size + alignment - 1, lastFirstLevel, lastSecondLevel);
+	while (firstLevel < lastFirstLevel || (firstLevel == lastFirstLevel && secondLevel <= lastSecondLevel))
+	{
+		for (uint32_t blockIndex = m_freeLists[firstLevel][secondLevel]; blockIndex != InvalidBlock; blockIndex = m_blocks[blockIndex].NextFree)
+		{
+			const BlockNode& block = m_blocks[blockIndex];
+			if (GetAlignedOffset(block.Offset, alignment) + size <= block.Offset + block.Size)
+			{
+				return blockIndex;
+			}
+		}
+
+		if (++secondLevel >= SecondLevelCount)
+		{
+			secondLevel = 0;
+			firstLevel++;
+		}
+	}
+	return InvalidBlock;
 }
 
-VariableSizeAllocationsManager::VariableSizeAllocationsManager(int MaxSize) : m_freeSize(MaxSize)
+uint32_t VariableSizeAllocationsManager::CreateBlock(OffsetType offset, OffsetType size)
 {
-	AddNewBlock(0, MaxSize);
+	uint32_t blockIndex;
+	if (m_unusedBlocks.empty() == false)
+	{
+		blockIndex = m_unusedBlocks.back();
+		m_unusedBlocks.pop_back();
+	}
+	else
+	{
+		blockIndex = static_cast<uint32_t>(m_blocks.size());
+		m_blocks.emplace_back();
+	}
+
+	BlockNode& block = m_blocks[blockIndex];
+	block = BlockNode();
+	block.Offset = offset;
+	block.Size = size;
+	return blockIndex;
 }
 
-VariableSizeAllocationsManager::VariableSizeAllocationsManager(VariableSizeAllocationsManager&& rhs) noexcept
+void VariableSizeAllocationsManager::ReleaseBlock(uint32_t blockIndex)
 {
-	m_freeBlocksByOffset = std::move(rhs.m_freeBlocksByOffset);
-	m_freeBlocksBySize = std::move(rhs.m_freeBlocksBySize);
-	m_freeSize = rhs.m_freeSize;
+	m_unusedBlocks.push_back(blockIndex);
 }
 
-void VariableSizeAllocationsManager::Free(OffsetType offset, OffsetType size)
+void VariableSizeAllocationsManager::InsertFreeBlock(uint32_t blockIndex)
 {
-	//4 츦 óؾ
-	//Ҵ簡 ޸𸮰 ʿ Ѱ 
-	//ʿ Ѱ 
-	//ʿ Ѱ 
-	//  ο Ҵ簡 ޸ ߰
-	auto nextBlockIter = m_freeBlocksByOffset.upper_bound(offset); // ޸
-	auto prevBlockIter = nextBlockIter;  // ޸
-	if (prevBlockIter != m_freeBlocksByOffset.begin())
+	BlockNode& block = m_blocks[blockIndex];
+	uint32_t firstLevel, secondLevel;
+	Mapping(block.Size, firstLevel, secondLevel);
+
+	uint32_t& head = m_freeLists[firstLevel][secondLevel];
+	block.IsFree = true;
+	block.PrevFree = InvalidBlock;
+	block.NextFree = head;
+	if (head != InvalidBlock)
 	{
-		--prevBlockIter;
+		m_blocks[head].PrevFree = blockIndex;
+	}
+	head = blockIndex;
+
+	m_firstLevelBitmap |= 1ull << firstLevel;
+	m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	m_freeBlockCount++;
+}
+
+void VariableSizeAllocationsManager::RemoveFreeBlock(uint32_t blockIndex)
+{
+	BlockNode& block = m_blocks[blockIndex];
+	uint32_t firstLevel, secondLevel;
+	Mapping(block.Size, firstLevel, secondLevel);
+
+	if (block.PrevFree != InvalidBlock)
+	{
+		m_blocks[block.PrevFree].NextFree = block.NextFree;
 	}
 	else
 	{
-		prevBlockIter = m_freeBlocksByOffset.end();
+		m_freeLists[firstLevel][secondLevel] = block.NextFree;
+	}
+	if (block.NextFree != InvalidBlock)
+	{
+		m_blocks[block.NextFree].PrevFree = block.PrevFree;
 	}
 
-	OffsetType newSize;
-	OffsetType newOffset;
-	//
-	if (prevBlockIter != m_freeBlocksByOffset.end() && offset == prevBlockIter->first + prevBlockIter->second.Size)
+	if (m_freeLists[firstLevel][secondLevel] == InvalidBlock)
 	{
-		newSize = prevBlockIter->second.Size + size;
-		newOffset = prevBlockIter->first;
-		// 
-		if (nextBlockIter != m_freeBlocksByOffset.end() && offset + size == nextBlockIter->first)
+		m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if (m_secondLevelBitmaps[firstLevel] == 0)
 		{
-			newSize += nextBlockIter->second.Size;
-			m_freeBlocksBySize.erase(prevBlockIter->second.OrderBySizeIt);
-			m_freeBlocksBySize.erase(nextBlockIter->second.OrderBySizeIt);
-			++nextBlockIter;
-			m_freeBlocksByOffset.erase(prevBlockIter, nextBlockIter);
+			m_firstLevelBitmap &= ~(1ull << firstLevel);
 		}
-		// 
-		else
+	}
+
+	block.IsFree = false;
+	block.PrevFree = InvalidBlock;
+	block.NextFree = InvalidBlock;
+	m_freeBlockCount--;
+}
+
+void VariableSizeAllocationsManager::InsertAllocatedBlock(uint32_t blockIndex)
+{
+	if ((m_allocatedCount + 1) * 2 > m_allocatedTable.size())
+	{
+		GrowAllocatedTable();
+	}
+
+	size_t mask = m_allocatedTable.size() - 1;
+	size_t slot = HashOffset(m_blocks[blockIndex].Offset, mask);
+	while (m_allocatedTable[slot] != InvalidBlock)
+	{
+		slot = (slot + 1) & mask;
+	}
+	m_allocatedTable[slot] = blockIndex;
+	m_allocatedCount++;
+}
+
+uint32_t VariableSizeAllocationsManager::RemoveAllocatedBlock(OffsetType offset)
+{
+	size_t mask = m_allocatedTable.size() - 1;
+	size_t slot = HashOffset(offset, mask);
+	while (m_allocatedTable[slot] != InvalidBlock && m_blocks[m_allocatedTable[slot]].Offset != offset)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	uint32_t blockIndex = m_allocatedTable[slot];
+	if (blockIndex == InvalidBlock)
+	{
+		return InvalidBlock;
+	}
+
+	//뒤따르는 항목을 당겨서 탐색이 끊기지 않게 함
+	m_allocatedTable[slot] = InvalidBlock;
+	size_t emptySlot = slot;
+	for (size_t next = (slot + 1) & mask; m_allocatedTable[next] != InvalidBlock; next = (next + 1) & mask)
+	{
+		size_t home = HashOffset(m_blocks[m_allocatedTable[next]].Offset, mask);
+		//home이 (emptySlot, next] 밖에 있으면 빈칸으로 옮김
+		bool isBetween = emptySlot <= next ? (emptySlot < home && home <= next) : (emptySlot < home || home <= next);
+		if (isBetween == false)
 		{
-			m_freeBlocksBySize.erase(prevBlockIter->second.OrderBySizeIt);
-			m_freeBlocksByOffset.erase(prevBlockIter);
+			m_allocatedTable[emptySlot] = m_allocatedTable[next];
+			m_allocatedTable[next] = InvalidBlock;
+			emptySlot = next;
 		}
 	}
-	//  + 
-	else if (nextBlockIter != m_freeBlocksByOffset.end() && offset + size == nextBlockIter->first)
+
+	m_allocatedCount--;
+	return blockIndex;
+}
+
+void VariableSizeAllocationsManager::GrowAllocatedTable()
+{
+	std::vector<uint32_t> oldTable(m_allocatedTable.size() * 2, InvalidBlock);
+	oldTable.swap(m_allocatedTable);
+	m_allocatedCount = 0;
+
+	for (uint32_t blockIndex : oldTable)
 	{
-		newSize = size + nextBlockIter->second.Size;
-		newOffset = offset;
-		m_freeBlocksBySize.erase(nextBlockIter->second.OrderBySizeIt);
-		m_freeBlocksByOffset.erase(nextBlockIter);
+		if (blockIndex != InvalidBlock)
+		{
+			InsertAllocatedBlock(blockIndex);
+		}
+	}
+}
+
+OffsetType VariableSizeAllocationsManager::Allocate(OffsetType size)
+{
+	return Allocate(size, 1);
+}
+
+OffsetType VariableSizeAllocationsManager::Allocate(OffsetType size, OffsetType alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	if (size == 0 || m_freeSize < size)
+	{
+		m_failedAllocateCount++;
+		return InvalidOffset;
+	}
+
+	uint32_t blockIndex = FindFreeBlock(size, alignment);
+	if (blockIndex == InvalidBlock)
+	{
+		m_failedAllocateCount++;
+		return InvalidOffset;
+	}
+
+	RemoveFreeBlock(blockIndex);
+
+	//정렬로 남는 앞부분은 빈 블록으로 돌려놓음
+	OffsetType alignedOffset = GetAlignedOffset(m_blocks[blockIndex].Offset, alignment);
+	OffsetType padding = alignedOffset - m_blocks[blockIndex].Offset;
+	if (padding > 0)
+	{
+		uint32_t alignedIndex = CreateBlock(alignedOffset, m_blocks[blockIndex].Size - padding);
+		BlockNode& paddingBlock = m_blocks[blockIndex];
+		BlockNode& alignedBlock = m_blocks[alignedIndex];
+
+		alignedBlock.PrevPhysical = blockIndex;
+		alignedBlock.NextPhysical = paddingBlock.NextPhysical;
+		if (paddingBlock.NextPhysical != InvalidBlock)
+		{
+			m_blocks[paddingBlock.NextPhysical].PrevPhysical = alignedIndex;
+		}
+		paddingBlock.NextPhysical = alignedIndex;
+		paddingBlock.Size = padding;
+
+		InsertFreeBlock(blockIndex);
+		blockIndex = alignedIndex;
+
+		m_alignmentPaddingCount++;
+		m_alignmentPaddingSize += padding;
+	}
+
+	//남는 뒷부분은 새 빈 블록으로
+	if (m_blocks[blockIndex].Size > size)
+	{
+		uint32_t remainIndex = CreateBlock(m_blocks[blockIndex].Offset + size, m_blocks[blockIndex].Size - size);
+		BlockNode& block = m_blocks[blockIndex];
+		BlockNode& remain = m_blocks[remainIndex];
+
+		remain.PrevPhysical = blockIndex;
+		remain.NextPhysical = block.NextPhysical;
+		if (block.NextPhysical != InvalidBlock)
+		{
+			m_blocks[block.NextPhysical].PrevPhysical = remainIndex;
+		}
+		block.NextPhysical = remainIndex;
+		block.Size = size;
+
+		InsertFreeBlock(remainIndex);
+	}
+
+	InsertAllocatedBlock(blockIndex);
+
+	m_freeSize -= size;
+	m_peakUsedSize = (std::max)(m_peakUsedSize, m_maxSize - m_freeSize);
+	m_allocateCount++;
+	return m_blocks[blockIndex].Offset;
+}
+
+void VariableSizeAllocationsManager::Free(OffsetType offset, OffsetType size)
+{
+	uint32_t blockIndex = RemoveAllocatedBlock(offset);
+	assert(blockIndex != InvalidBlock && m_blocks[blockIndex].Size == size);
+	if (blockIndex == InvalidBlock)
+	{
+		return;
+	}
+
+	m_freeCount++;
+	FreeBlock(blockIndex);
+}
+
+void VariableSizeAllocationsManager::SplitAllocation(OffsetType offset, OffsetType size, const std::vector<uint32_t>& sizes)
+{
+	uint32_t blockIndex = RemoveAllocatedBlock(offset);
+	assert(blockIndex != InvalidBlock && m_blocks[blockIndex].Size == size);
+	if (blockIndex == InvalidBlock)
+	{
+		return;
+	}
+
+	//원래 할당 하나가 sizes.size()개의 할당이 됨
+	m_allocateCount += sizes.size();
+	m_allocateCount--;
+
+	for (uint32_t headSize : sizes)
+	{
+		assert(headSize > 0 && headSize <= m_blocks[blockIndex].Size);
+		if (m_blocks[blockIndex].Size == headSize)
+		{
+			InsertAllocatedBlock(blockIndex);
+			blockIndex = InvalidBlock;
+			break;
+		}
+
+		uint32_t remainIndex = CreateBlock(m_blocks[blockIndex].Offset + headSize, m_blocks[blockIndex].Size - headSize);
+		BlockNode& block = m_blocks[blockIndex];
+		BlockNode& remain = m_blocks[remainIndex];
+
+		remain.PrevPhysical = blockIndex;
+		remain.NextPhysical = block.NextPhysical;
+		if (block.NextPhysical != InvalidBlock)
+		{
+			m_blocks[block.NextPhysical].PrevPhysical = remainIndex;
+		}
+		block.NextPhysical = remainIndex;
+		block.Size = headSize;
+
+		InsertAllocatedBlock(blockIndex);
+		blockIndex = remainIndex;
+	}
+
+	if (blockIndex != InvalidBlock)
+	{
+		FreeBlock(blockIndex);
+	}
+}
+
+void VariableSizeAllocationsManager::FreeBlock(uint32_t blockIndex)
+{
+	m_freeSize += m_blocks[blockIndex].Size;
+
+	//좌측 인접 빈 블록에 합침
+	uint32_t prevIndex = m_blocks[blockIndex].PrevPhysical;
+	if (prevIndex != InvalidBlock && m_blocks[prevIndex].IsFree)
+	{
+		RemoveFreeBlock(prevIndex);
+
+		BlockNode& prev = m_blocks[prevIndex];
+		BlockNode& block = m_blocks[blockIndex];
+		prev.Size += block.Size;
+		prev.NextPhysical = block.NextPhysical;
+		if (block.NextPhysical != InvalidBlock)
+		{
+			m_blocks[block.NextPhysical].PrevPhysical = prevIndex;
+		}
+		ReleaseBlock(blockIndex);
+		blockIndex = prevIndex;
 	}
-	else //
+
+	//우측 인접 빈 블록을 합침
+	uint32_t nextIndex = m_blocks[blockIndex].NextPhysical;
+	if (nextIndex != InvalidBlock && m_blocks[nextIndex].IsFree)
 	{
-		newSize = size;
-		newOffset = offset;
+		RemoveFreeBlock(nextIndex);
+
+		BlockNode& block = m_blocks[blockIndex];
+		BlockNode& next = m_blocks[nextIndex];
+		block.Size += next.Size;
+		block.NextPhysical = next.NextPhysical;
+		if (next.NextPhysical != InvalidBlock)
+		{
+			m_blocks[next.NextPhysical].PrevPhysical = blockIndex;
+		}
+		ReleaseBlock(nextIndex);
 	}
 
-	AddNewBlock(newOffset, newSize);
+	InsertFreeBlock(blockIndex);
+}
+
+VariableSizeAllocationStats VariableSizeAllocationsManager::GetStats() const
+{
+	VariableSizeAllocationStats stats;
+	stats.TotalSize = m_maxSize;
+	stats.FreeSize = m_freeSize;
+	stats.FreeBlockCount = m_freeBlockCount;
+	stats.AllocationCount = m_allocatedCount;
+	stats.AlignmentPaddingCount = m_alignmentPaddingCount;
+	stats.AlignmentPaddingSize = m_alignmentPaddingSize;
+	stats.PeakUsedSize = m_peakUsedSize;
+	stats.AllocateCount = m_allocateCount;
+	stats.FreeCount = m_freeCount;
+	stats.FailedAllocateCount = m_failedAllocateCount;
 
-	m_freeSize += size;
+	//가장 큰 블록은 가장 높은 리스트에 있음
+	if (m_firstLevelBitmap != 0)
+	{
+		uint32_t firstLevel = FindHighestBit(m_firstLevelBitmap);
+		uint32_t secondLevel = FindHighestBit(m_secondLevelBitmaps[firstLevel]);
+		for (uint32_t blockIndex = m_freeLists[firstLevel][secondLevel]; blockIndex != InvalidBlock; blockIndex = m_blocks[blockIndex].NextFree)
+		{
+			stats.LargestFreeBlock = (std::max)(stats.LargestFreeBlock, m_blocks[blockIndex].Size);
+		}
+	}
+	return stats;
 }
 
 VariableSizeGPUAllocationsManager::VariableSizeGPUAllocationsManager(OffsetType MaxSize) : VariableSizeAllocationsManager(MaxSize)
@@ -120,4 +505,13 @@ VariableSizeGPUAllocationsManager::~VariableSizeGPUAllocationsManager()
 VariableSizeGPUAllocationsManager::VariableSizeGPUAllocationsManager(VariableSizeGPUAllocationsManager&& rhs) noexcept : VariableSizeAllocationsManager(std::move(rhs))
 {
 	m_staleAllocations = std::move(rhs.m_staleAllocations);
+	m_staleSize = rhs.m_staleSize;
+}
+
+VariableSizeAllocationStats VariableSizeGPUAllocationsManager::GetStats() const
+{
+	VariableSizeAllocationStats stats = VariableSizeAllocationsManager::GetStats();
+	stats.StaleAllocationCount = m_staleAllocations.size();
+	stats.StaleSize = m_staleSize;
+	return stats;
 }
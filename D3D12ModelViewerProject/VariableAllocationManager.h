@@ -1,25 +1,43 @@
 #pragma once
-#include <map>
+#include <stddef.h>
 #include <stdint.h>
 #include <vector>
 #include <deque>
 
 typedef size_t OffsetType;
-struct FreeBlockInfo;
 
-
-using TFreeBlockByOffsetMap = std::map<OffsetType, FreeBlockInfo>;
-using TFreeBlockBySizeMap = std::multimap<OffsetType, TFreeBlockByOffsetMap::iterator>;
-
-struct FreeBlockInfo
+//GetStats 결과
+struct VariableSizeAllocationStats
 {
-	OffsetType Size;
-
-	TFreeBlockBySizeMap::iterator OrderBySizeIt;
-	FreeBlockInfo(OffsetType size) : Size(size) {}
+	OffsetType TotalSize = 0;
+	OffsetType FreeSize = 0;
+	OffsetType LargestFreeBlock = 0;
+	size_t FreeBlockCount = 0;
+	size_t AllocationCount = 0;
+	//정렬 때문에 앞쪽에 떼어낸 빈 블록 누적 개수, 크기
+	size_t AlignmentPaddingCount = 0;
+	OffsetType AlignmentPaddingSize = 0;
+	//사용량 최고치
+	OffsetType PeakUsedSize = 0;
+	//생성 후 누적 횟수, 프레임당 횟수는 이전 값과의 차로 구함
+	uint64_t AllocateCount = 0;
+	uint64_t FreeCount = 0;
+	uint64_t FailedAllocateCount = 0;
+	//GPU 매니저에서 프레임 완료를 기다리는 해제 대기열
+	size_t StaleAllocationCount = 0;
+	OffsetType StaleSize = 0;
+
+	//0 : 빈공간이 한 블록, 1에 가까울수록 잘게 나뉨
+	float GetFragmentation() const
+	{
+		return FreeSize > 0 ? 1.0f - static_cast<float>(LargestFreeBlock) / static_cast<float>(FreeSize) : 0.0f;
+	}
 };
 
-
+//TLSF (two-level segregated fit) 방식
+//빈 블록을 크기의 최상위 비트(1단계)와 그 아래 SecondLevelLog2 비트(2단계)로 나눈 리스트에 두고
+//비트맵으로 요청 크기 이상인 리스트를 O(1)에 찾음
+//블록 노드는 풀에서 재사용하므로 풀이 커질때 말고는 호출마다 힙할당이 없음
 class VariableSizeAllocationsManager
 {
 public:
@@ -29,18 +47,79 @@ public:
 	VariableSizeAllocationsManager(VariableSizeAllocationsManager&& rhs) noexcept;
 public:
 
+	//size는 Allocate때와 같아야함
 	void Free(OffsetType offset, OffsetType size);
 	OffsetType Allocate(OffsetType size);
+	//alignment : 2의 거듭제곱, 반환 오프셋이 alignment의 배수
+	//앞쪽 남는 부분은 빈 블록으로 돌려놓음, Free는 반환된 오프셋과 size로 호출
+	OffsetType Allocate(OffsetType size, OffsetType alignment);
+	//할당된 블록(offset, size)을 앞에서부터 sizes 크기의 할당들로 나누고 남는 뒷부분은 해제
+	//나뉜 할당은 각각 Free 해야함
+	void SplitAllocation(OffsetType offset, OffsetType size, const std::vector<uint32_t>& sizes);
 	OffsetType GetFreeSize() const
 	{
 		return m_freeSize;
 	}
+	//빈 블록 수와 가장 큰 빈 블록을 찾으므로 매 호출마다 쓰지 않음
+	VariableSizeAllocationStats GetStats() const;
+private:
+	static constexpr uint32_t SecondLevelLog2 = 4;
+	static constexpr uint32_t SecondLevelCount = 1 << SecondLevelLog2;
+	static constexpr uint32_t FirstLevelCount = 64 - SecondLevelLog2 + 1;
+	static constexpr uint32_t InvalidBlock = UINT32_MAX;
+
+	//빈 블록과 할당된 블록 모두 오프셋 순서로 연결됨
+	struct BlockNode
+	{
+		OffsetType Offset = 0;
+		OffsetType Size = 0;
+		uint32_t PrevPhysical = InvalidBlock;
+		uint32_t NextPhysical = InvalidBlock;
+		//빈 블록일때만 사용
+		uint32_t PrevFree = InvalidBlock;
+		uint32_t NextFree = InvalidBlock;
+		bool IsFree = false;
+	};
 private:
-	void AddNewBlock(OffsetType Offset, OffsetType size);
+	static void Mapping(OffsetType size, uint32_t& firstLevel, uint32_t& secondLevel);
+	uint32_t FindFreeBlock(OffsetType size, OffsetType alignment) const;
+	static OffsetType GetAlignedOffset(OffsetType offset, OffsetType alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	uint32_t CreateBlock(OffsetType offset, OffsetType size);
+	void ReleaseBlock(uint32_t blockIndex);
+	void InsertFreeBlock(uint32_t blockIndex);
+	void RemoveFreeBlock(uint32_t blockIndex);
+	//할당 테이블에서 빠진 블록을 인접 빈 블록과 합쳐 빈 리스트에 넣음
+	void FreeBlock(uint32_t blockIndex);
+
+	//할당된 블록을 오프셋으로 찾는 개방 주소 해시 테이블
+	void InsertAllocatedBlock(uint32_t blockIndex);
+	uint32_t RemoveAllocatedBlock(OffsetType offset);
+	void GrowAllocatedTable();
 private:
-	TFreeBlockByOffsetMap m_freeBlocksByOffset;
-	TFreeBlockBySizeMap m_freeBlocksBySize;
+	std::vector<BlockNode> m_blocks;
+	std::vector<uint32_t> m_unusedBlocks;
+
+	uint64_t m_firstLevelBitmap = 0;
+	uint32_t m_secondLevelBitmaps[FirstLevelCount] = {};
+	uint32_t m_freeLists[FirstLevelCount][SecondLevelCount];
+
+	//크기는 2의 거듭제곱, 절반 이상 차면 늘림
+	std::vector<uint32_t> m_allocatedTable;
+	size_t m_allocatedCount = 0;
+
+	OffsetType m_maxSize = 0;
 	OffsetType m_freeSize;
+	size_t m_freeBlockCount = 0;
+	size_t m_alignmentPaddingCount = 0;
+	OffsetType m_alignmentPaddingSize = 0;
+	OffsetType m_peakUsedSize = 0;
+	uint64_t m_allocateCount = 0;
+	uint64_t m_freeCount = 0;
+	uint64_t m_failedAllocateCount = 0;
 };
 
 
@@ -69,6 +148,7 @@ public:
 	void Free(OffsetType Offset, OffsetType Size, uint64_t FrameNumber)
 	{
 		m_staleAllocations.emplace_back(Offset, Size, FrameNumber);
+		m_staleSize += Size;
 	}
 
 	void ReleaseCompletedFrames(uint64_t NumCompletedFrames)
@@ -77,10 +157,15 @@ public:
 		{
 			auto& OldestAllocation = m_staleAllocations.front();
 			VariableSizeAllocationsManager::Free(OldestAllocation.Offset, OldestAllocation.Size);
+			m_staleSize -= OldestAllocation.Size;
 			m_staleAllocations.pop_front();
 		}
 	}
 
+	//기본 통계에 해제 대기열 깊이를 더함
+	VariableSizeAllocationStats GetStats() const;
+
 private:
 	std::deque< FreedAllocationInfo > m_staleAllocations;
-};
\ No newline at end of file
+	OffsetType m_staleSize = 0;
+};
@@ -0,0 +1,99 @@
+#include "VertexDedupeTable.h"
+
+namespace
+{
+	//MurmurHash3 fmix64
+	uint64_t Mix64(uint64_t value)
+	{
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdULL;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ULL;
+		value ^= value >> 33;
+		return value;
+	}
+
+	size_t RoundUpPowerOfTwo(size_t value)
+	{
+		size_t result = 16;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+}
+
+uint64_t VertexKey::Hash(const VertexKey& key)
+{
+	static_assert(sizeof(VertexKey) % sizeof(uint64_t) == 0);
+
+	uint64_t words[sizeof(VertexKey) / sizeof(uint64_t)];
+	memcpy(words, &key, sizeof(VertexKey));
+
+	uint64_t hash = 0x9E3779B97F4A7C15ULL;
+	for (uint64_t word : words)
+	{
+		hash = (hash ^ Mix64(word)) * 0x9E3779B97F4A7C15ULL;
+	}
+	return Mix64(hash);
+}
+
+VertexDedupeTable::VertexDedupeTable(size_t expectedCount)
+{
+	m_keys.reserve(expectedCount);
+	//load factor 0.5 이하로 시작
+	Rehash(RoundUpPowerOfTwo(expectedCount * 2));
+}
+
+std::pair<uint32_t, bool> VertexDedupeTable::Insert(const VertexKey& key)
+{
+	//load factor 0.75 초과시 두배로
+	if ((m_keys.size() + 1) * 4 > m_slots.size() * 3)
+	{
+		Rehash(m_slots.size() * 2);
+	}
+
+	uint64_t hash = VertexKey::Hash(key);
+	uint32_t hashTag = static_cast<uint32_t>(hash >> 32);
+
+	size_t slotIndex = static_cast<size_t>(hash) & m_slotMask;
+	while (true)
+	{
+		Slot& slot = m_slots[slotIndex];
+		if (slot.KeyIndex == InvalidIndex)
+		{
+			uint32_t keyIndex = static_cast<uint32_t>(m_keys.size());
+			slot.HashTag = hashTag;
+			slot.KeyIndex = keyIndex;
+			m_keys.push_back(key);
+			return { keyIndex, true };
+		}
+
+		if (slot.HashTag == hashTag && m_keys[slot.KeyIndex] == key)
+		{
+			return { slot.KeyIndex, false };
+		}
+
+		slotIndex = (slotIndex + 1) & m_slotMask;
+	}
+}
+
+void VertexDedupeTable::Rehash(size_t slotCount)
+{
+	m_slots.assign(slotCount, Slot());
+	m_slotMask = slotCount - 1;
+
+	for (uint32_t keyIndex = 0; keyIndex < m_keys.size(); ++keyIndex)
+	{
+		uint64_t hash = VertexKey::Hash(m_keys[keyIndex]);
+
+		size_t slotIndex = static_cast<size_t>(hash) & m_slotMask;
+		while (m_slots[slotIndex].KeyIndex != InvalidIndex)
+		{
+			slotIndex = (slotIndex + 1) & m_slotMask;
+		}
+		m_slots[slotIndex].HashTag = static_cast<uint32_t>(hash >> 32);
+		m_slots[slotIndex].KeyIndex = keyIndex;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <utility>
+
+// 중복정점 검사용 키, 힙할당이 없는 POD
+// float는 비트값으로 저장 (-0.0f는 0.0f로 맞춤)
+struct VertexKey
+{
+	uint32_t Position[3] = {};
+	uint32_t Normal[3] = {};
+	uint32_t TexC[2] = {};
+	int32_t MaterialIndex = -1;
+	uint32_t Padding = 0;
+
+	bool operator==(const VertexKey& rhs) const
+	{
+		return memcmp(this, &rhs, sizeof(VertexKey)) == 0;
+	}
+
+	//양자화하지 않음, 같은 float만 같은 키 (기존 SubMeshVertex::operator==와 같은 결과)
+	static uint32_t CanonicalFloatBits(float value)
+	{
+		if (value == 0.0f)
+		{
+			return 0;
+		}
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	static uint64_t Hash(const VertexKey& key);
+};
+
+// open addressing(linear probing) 해시테이블
+// 키는 추가된 순서대로 0,1,2... 인덱스를 받음
+class VertexDedupeTable
+{
+public:
+	static const uint32_t InvalidIndex = static_cast<uint32_t>(-1);
+public:
+	VertexDedupeTable(size_t expectedCount = 0);
+
+	// 이미 있으면 {기존 인덱스, false}, 없으면 추가후 {새 인덱스, true}
+	std::pair<uint32_t, bool> Insert(const VertexKey& key);
+
+	size_t GetSize() const { return m_keys.size(); }
+private:
+	struct Slot
+	{
+		//해시 상위 32bit, 키비교 전에 먼저 비교
+		uint32_t HashTag = 0;
+		uint32_t KeyIndex = InvalidIndex;
+	};
+
+	void Rehash(size_t slotCount);
+private:
+	std::vector<Slot> m_slots;
+	std::vector<VertexKey> m_keys;
+	size_t m_slotMask = 0;
+};
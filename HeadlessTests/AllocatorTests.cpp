@@ -0,0 +1,393 @@
+#include "HeadlessTest.h"
+#include "VariableAllocationManager.h"
+#include <map>
+#include <random>
+#include <algorithm>
+
+namespace
+{
+	//오프셋마다 사용 여부를 저장하는 기준 모델
+	//빈 블록은 항상 합쳐지므로 연속된 빈 구간 하나가 매니저의 빈 블록 하나와 같음
+	class ReferenceModel
+	{
+	public:
+		ReferenceModel(OffsetType size) : m_used(size, false) {}
+
+		bool IsRangeFree(OffsetType offset, OffsetType size) const
+		{
+			if (offset + size > m_used.size())
+			{
+				return false;
+			}
+			return std::none_of(m_used.begin() + offset, m_used.begin() + offset + size, [](bool used) { return used; });
+		}
+
+		void SetRange(OffsetType offset, OffsetType size, bool used)
+		{
+			std::fill(m_used.begin() + offset, m_used.begin() + offset + size, used);
+		}
+
+		//빈 구간 중 alignment 정렬된 size 크기가 들어가는 곳이 있는지
+		bool CanFit(OffsetType size, OffsetType alignment) const
+		{
+			OffsetType runStart = 0;
+			for (OffsetType i = 0; i <= m_used.size(); ++i)
+			{
+				if (i == m_used.size() || m_used[i])
+				{
+					OffsetType alignedStart = (runStart + alignment - 1) & ~(alignment - 1);
+					if (alignedStart + size <= i)
+					{
+						return true;
+					}
+					runStart = i + 1;
+				}
+			}
+			return false;
+		}
+
+		VariableSizeAllocationStats GetStats() const
+		{
+			VariableSizeAllocationStats stats;
+			stats.TotalSize = m_used.size();
+			OffsetType runSize = 0;
+			for (OffsetType i = 0; i <= m_used.size(); ++i)
+			{
+				if (i == m_used.size() || m_used[i])
+				{
+					if (runSize > 0)
+					{
+						stats.FreeBlockCount++;
+						stats.LargestFreeBlock = (std::max)(stats.LargestFreeBlock, runSize);
+					}
+					runSize = 0;
+				}
+				else
+				{
+					stats.FreeSize++;
+					runSize++;
+				}
+			}
+			return stats;
+		}
+	private:
+		std::vector<bool> m_used;
+	};
+
+	struct LiveAllocation
+	{
+		OffsetType Offset;
+		OffsetType Size;
+	};
+
+	bool CheckStats(const VariableSizeAllocationsManager& manager, const ReferenceModel& model, size_t liveCount)
+	{
+		VariableSizeAllocationStats stats = manager.GetStats();
+		VariableSizeAllocationStats expected = model.GetStats();
+		return stats.FreeSize == expected.FreeSize && manager.GetFreeSize() == expected.FreeSize
+			&& stats.FreeBlockCount == expected.FreeBlockCount
+			&& stats.LargestFreeBlock == expected.LargestFreeBlock
+			&& stats.AllocationCount == liveCount;
+	}
+
+	//할당 결과를 기준 모델에 반영, 실패면 들어갈 곳이 정말 없어야함
+	bool ApplyAllocation(ReferenceModel& model, std::vector<LiveAllocation>& live, OffsetType offset, OffsetType size, OffsetType alignment)
+	{
+		if (offset == VariableSizeAllocationsManager::InvalidOffset)
+		{
+			return model.CanFit(size, alignment) == false;
+		}
+		if (offset % alignment != 0 || model.IsRangeFree(offset, size) == false)
+		{
+			return false;
+		}
+		model.SetRange(offset, size, true);
+		live.push_back({ offset, size });
+		return true;
+	}
+
+	void FreeRandom(std::mt19937& random, VariableSizeAllocationsManager& manager, ReferenceModel& model, std::vector<LiveAllocation>& live)
+	{
+		size_t index = random() % live.size();
+		manager.Free(live[index].Offset, live[index].Size);
+		model.SetRange(live[index].Offset, live[index].Size, false);
+		live[index] = live.back();
+		live.pop_back();
+	}
+
+	//변경 전의 map, multimap 기반 매니저, 벤치마크 비교용
+	class MapAllocationsManager
+	{
+	public:
+		MapAllocationsManager(OffsetType maxSize) : m_freeSize(maxSize)
+		{
+			AddNewBlock(0, maxSize);
+		}
+
+		OffsetType Allocate(OffsetType size)
+		{
+			if (m_freeSize < size)
+			{
+				return VariableSizeAllocationsManager::InvalidOffset;
+			}
+			auto smallestBlockIterIter = m_freeBlocksBySize.lower_bound(size);
+			if (smallestBlockIterIter == m_freeBlocksBySize.end())
+			{
+				return VariableSizeAllocationsManager::InvalidOffset;
+			}
+			auto smallestBlockIter = smallestBlockIterIter->second;
+			OffsetType offset = smallestBlockIter->first;
+			OffsetType newSize = smallestBlockIter->second.Size - size;
+			m_freeBlocksBySize.erase(smallestBlockIterIter);
+			m_freeBlocksByOffset.erase(smallestBlockIter);
+			if (newSize > 0)
+			{
+				AddNewBlock(offset + size, newSize);
+			}
+			m_freeSize -= size;
+			return offset;
+		}
+
+		void Free(OffsetType offset, OffsetType size)
+		{
+			auto nextBlockIter = m_freeBlocksByOffset.upper_bound(offset);
+			auto prevBlockIter = nextBlockIter;
+			if (prevBlockIter != m_freeBlocksByOffset.begin())
+			{
+				--prevBlockIter;
+			}
+			else
+			{
+				prevBlockIter = m_freeBlocksByOffset.end();
+			}
+
+			OffsetType newOffset = offset;
+			OffsetType newSize = size;
+			if (prevBlockIter != m_freeBlocksByOffset.end() && offset == prevBlockIter->first + prevBlockIter->second.Size)
+			{
+				newOffset = prevBlockIter->first;
+				newSize += prevBlockIter->second.Size;
+				m_freeBlocksBySize.erase(prevBlockIter->second.OrderBySizeIt);
+				m_freeBlocksByOffset.erase(prevBlockIter);
+			}
+			if (nextBlockIter != m_freeBlocksByOffset.end() && offset + size == nextBlockIter->first)
+			{
+				newSize += nextBlockIter->second.Size;
+				m_freeBlocksBySize.erase(nextBlockIter->second.OrderBySizeIt);
+				m_freeBlocksByOffset.erase(nextBlockIter);
+			}
+			AddNewBlock(newOffset, newSize);
+			m_freeSize += size;
+		}
+	private:
+		struct FreeBlockInfo;
+		using FreeBlockByOffsetMap = std::map<OffsetType, FreeBlockInfo>;
+		using FreeBlockBySizeMap = std::multimap<OffsetType, FreeBlockByOffsetMap::iterator>;
+		struct FreeBlockInfo
+		{
+			OffsetType Size;
+			FreeBlockBySizeMap::iterator OrderBySizeIt;
+			FreeBlockInfo(OffsetType size) : Size(size) {}
+		};
+
+		void AddNewBlock(OffsetType offset, OffsetType size)
+		{
+			auto newBlockIter = m_freeBlocksByOffset.emplace(offset, size);
+			newBlockIter.first->second.OrderBySizeIt = m_freeBlocksBySize.emplace(size, newBlockIter.first);
+		}
+	private:
+		FreeBlockByOffsetMap m_freeBlocksByOffset;
+		FreeBlockBySizeMap m_freeBlocksBySize;
+		OffsetType m_freeSize;
+	};
+
+	//크기 1~64의 할당/해제를 반씩 섞어서 반복
+	template<typename ManagerType>
+	double RunChurn(ManagerType& manager, int operationCount)
+	{
+		std::mt19937 random(3);
+		std::vector<LiveAllocation> live;
+		live.reserve(operationCount);
+
+		HeadlessTest::Timer timer;
+		for (int i = 0; i < operationCount; ++i)
+		{
+			if (random() % 2 || live.empty())
+			{
+				OffsetType size = 1 + random() % 64;
+				OffsetType offset = manager.Allocate(size);
+				if (offset != VariableSizeAllocationsManager::InvalidOffset)
+				{
+					live.push_back({ offset, size });
+				}
+			}
+			else
+			{
+				size_t index = random() % live.size();
+				manager.Free(live[index].Offset, live[index].Size);
+				live[index] = live.back();
+				live.pop_back();
+			}
+		}
+		return timer.GetMilliseconds();
+	}
+}
+
+HEADLESS_TEST(AllocatorRandomAllocateFree)
+{
+	std::mt19937 random(1);
+	for (int trial = 0; trial < 100; ++trial)
+	{
+		OffsetType maxSize = 1 + random() % 4000;
+		VariableSizeAllocationsManager manager(static_cast<int>(maxSize));
+		ReferenceModel model(maxSize);
+		std::vector<LiveAllocation> live;
+
+		for (int operation = 0; operation < 3000; ++operation)
+		{
+			if (random() % 2 || live.empty())
+			{
+				OffsetType size = 1 + (random() % 3 == 0 ? random() % 500 : random() % 20);
+				REQUIRE(ApplyAllocation(model, live, manager.Allocate(size), size, 1));
+			}
+			else
+			{
+				FreeRandom(random, manager, model, live);
+			}
+
+			if (operation % 64 == 0)
+			{
+				REQUIRE(CheckStats(manager, model, live.size()));
+			}
+		}
+		REQUIRE(CheckStats(manager, model, live.size()));
+
+		for (const auto& allocation : live)
+		{
+			manager.Free(allocation.Offset, allocation.Size);
+		}
+		//모두 해제하면 한 블록으로 합쳐져야함
+		CHECK(manager.GetFreeSize() == maxSize);
+		CHECK(manager.Allocate(maxSize) == 0);
+	}
+}
+
+HEADLESS_TEST(AllocatorAlignedAllocate)
+{
+	std::mt19937 random(2);
+	for (int trial = 0; trial < 100; ++trial)
+	{
+		OffsetType maxSize = 64 + random() % 4000;
+		VariableSizeAllocationsManager manager(static_cast<int>(maxSize));
+		ReferenceModel model(maxSize);
+		std::vector<LiveAllocation> live;
+
+		for (int operation = 0; operation < 3000; ++operation)
+		{
+			if (random() % 2 || live.empty())
+			{
+				OffsetType size = 1 + random() % 40;
+				OffsetType alignment = OffsetType(1) << (random() % 7);
+				REQUIRE(ApplyAllocation(model, live, manager.Allocate(size, alignment), size, alignment));
+			}
+			else
+			{
+				FreeRandom(random, manager, model, live);
+			}
+
+			if (operation % 64 == 0)
+			{
+				REQUIRE(CheckStats(manager, model, live.size()));
+			}
+		}
+		REQUIRE(CheckStats(manager, model, live.size()));
+
+		for (const auto& allocation : live)
+		{
+			manager.Free(allocation.Offset, allocation.Size);
+		}
+		CHECK(manager.GetStats().FreeBlockCount == 1);
+	}
+}
+
+HEADLESS_TEST(AllocatorSplitAllocation)
+{
+	std::mt19937 random(4);
+	for (int trial = 0; trial < 100; ++trial)
+	{
+		OffsetType maxSize = 256 + random() % 4000;
+		VariableSizeAllocationsManager manager(static_cast<int>(maxSize));
+		ReferenceModel model(maxSize);
+		std::vector<LiveAllocation> live;
+
+		for (int operation = 0; operation < 2000; ++operation)
+		{
+			uint32_t choice = random() % 3;
+			if (choice == 0 || live.empty())
+			{
+				OffsetType size = 1 + random() % 64;
+				REQUIRE(ApplyAllocation(model, live, manager.Allocate(size), size, 1));
+			}
+			else if (choice == 1)
+			{
+				FreeRandom(random, manager, model, live);
+			}
+			else
+			{
+				//앞에서부터 나누고 남는 뒷부분은 해제됨
+				size_t index = random() % live.size();
+				LiveAllocation allocation = live[index];
+				live[index] = live.back();
+				live.pop_back();
+
+				std::vector<uint32_t> sizes;
+				OffsetType usedSize = 0;
+				while (random() % 4 != 0)
+				{
+					uint32_t size = 1 + random() % 8;
+					if (usedSize + size > allocation.Size)
+					{
+						break;
+					}
+					sizes.push_back(size);
+					usedSize += size;
+				}
+				manager.SplitAllocation(allocation.Offset, allocation.Size, sizes);
+
+				model.SetRange(allocation.Offset + usedSize, allocation.Size - usedSize, false);
+				OffsetType offset = allocation.Offset;
+				for (uint32_t size : sizes)
+				{
+					live.push_back({ offset, size });
+					offset += size;
+				}
+			}
+
+			if (operation % 32 == 0)
+			{
+				REQUIRE(CheckStats(manager, model, live.size()));
+			}
+		}
+		REQUIRE(CheckStats(manager, model, live.size()));
+
+		for (const auto& allocation : live)
+		{
+			manager.Free(allocation.Offset, allocation.Size);
+		}
+		CHECK(manager.GetFreeSize() == maxSize);
+		CHECK(manager.GetStats().FreeBlockCount == 1);
+	}
+}
+
+HEADLESS_BENCH(AllocatorChurn)
+{
+	const int operationCount = 2000000;
+	const OffsetType maxSize = 1 << 20;
+
+	VariableSizeAllocationsManager manager(static_cast<int>(maxSize));
+	double tlsfTime = RunChurn(manager, operationCount);
+	MapAllocationsManager mapManager(maxSize);
+	double mapTime = RunChurn(mapManager, operationCount);
+
+	printf("  %d ops, tlsf %.1f ms, map %.1f ms (x%.2f)\n", operationCount, tlsfTime, mapTime, mapTime / tlsfTime);
+}
@@ -0,0 +1,306 @@
+#include "HeadlessTest.h"
+#include "AnimationBaking.h"
+#include "AnimationCalculator.h"
+#include "Skinning.h"
+
+using namespace DirectX;
+
+namespace
+{
+	//본 3개 체인, 루트는 스케일도 변함, 마지막 본은 트랙이 짧아서 마지막 키로 고정됨
+	AnimationClip CreateClip(uint32_t frameCount)
+	{
+		AnimationClip clip;
+		clip.Name = "Synthetic";
+
+		const int parentIndices[3] = { -1, 0, 1 };
+		const uint32_t trackFrameCounts[3] = { frameCount, frameCount, frameCount / 2 };
+		for (int boneIndex = 0; boneIndex < 3; ++boneIndex)
+		{
+			std::vector<AffineMatrix> frames(trackFrameCounts[boneIndex]);
+			for (uint32_t frame = 0; frame < frames.size(); ++frame)
+			{
+				float t = static_cast<float>(frame);
+				frames[frame].Translation = XMVectorSet(0.1f * t * (boneIndex + 1), 1.0f, 0.05f * t, 0.0f);
+				frames[frame].Quaternion = XMQuaternionRotationRollPitchYaw(0.1f * t, 0.3f * t + boneIndex, 0.05f * t);
+				if (boneIndex == 0)
+				{
+					frames[frame].Scale = XMVectorSet(1.0f + 0.05f * t, 1.0f, 1.0f - 0.02f * t, 0.0f);
+				}
+			}
+
+			BoneAnimation boneAnimation;
+			boneAnimation.Joint.ParentIndex = parentIndices[boneIndex];
+			boneAnimation.Joint.GlobalBindposeInverseTransform.Translation = XMVectorSet(0.0f, -1.0f * boneIndex, 0.0f, 0.0f);
+
+			AnimationCompressionStats stats;
+			boneAnimation.Track = AnimationCompressor::Compress(frames, AnimationCompressionSettings(), stats);
+			clip.BoneAnimations.push_back(boneAnimation);
+		}
+		return clip;
+	}
+
+	//DynamicMeshShader.hlsl의 GetBakedBoneTransform을 그대로 옮김
+	BoneTransform3x4 GetShaderBoneTransform(const BakedAnimation& baked, float time, UINT boneIndex)
+	{
+		float frame = time * baked.FramePerSecond;
+		float frameCount = static_cast<float>(baked.FrameCount);
+		frame = frame - floorf(frame / frameCount) * frameCount;
+		float baseFrame = floorf(frame);
+
+		float alpha = frame - baseFrame;
+		UINT frame0 = (std::min)(static_cast<UINT>(baseFrame), baked.FrameCount - 1);
+		UINT frame1 = (std::min)(frame0 + 1, baked.FrameCount - 1);
+
+		const BoneTransform3x4& bone0 = baked.Palettes[frame0 * baked.BoneCount + boneIndex];
+		const BoneTransform3x4& bone1 = baked.Palettes[frame1 * baked.BoneCount + boneIndex];
+
+		//lerp(x, y, s) = x + s * (y - x)
+		BoneTransform3x4 result;
+		for (int row = 0; row < 3; ++row)
+		{
+			const XMFLOAT4& row0 = bone0.Rows[row];
+			const XMFLOAT4& row1 = bone1.Rows[row];
+			result.Rows[row] = XMFLOAT4(
+				row0.x + alpha * (row1.x - row0.x),
+				row0.y + alpha * (row1.y - row0.y),
+				row0.z + alpha * (row1.z - row0.z),
+				row0.w + alpha * (row1.w - row0.w));
+		}
+		return result;
+	}
+
+	bool IsNear(const BoneTransform3x4& a, const BoneTransform3x4& b, float epsilon)
+	{
+		for (int row = 0; row < 3; ++row)
+		{
+			if (XMVector4NearEqual(XMLoadFloat4(&a.Rows[row]), XMLoadFloat4(&b.Rows[row]), XMVectorReplicate(epsilon)) == false)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//AnimationCalcuator로 루프 재생해서 AnimationPoseBatch로 계산한 팔레트, 구운 클립을 쓰지 않는 인스턴스와 같은 경로
+	std::vector<InstanceAnimations> GetPlaybackPalette(const std::shared_ptr<const AnimationClip>& clip, const Skeleton& skeleton, float time)
+	{
+		AnimationCalcuator calculator;
+		calculator.SetAnimationClip(clip);
+		calculator.SetLoop(true);
+		calculator.AddTime(time);
+
+		AnimationPoseBatch poseBatch;
+		poseBatch.Begin(skeleton);
+		std::vector<InstanceAnimations> palette;
+		calculator.AddPoseSamples(poseBatch, poseBatch.AddPose(0, 0, &palette));
+		poseBatch.Execute([](size_t, const InstanceAnimations*) {});
+		return palette;
+	}
+
+	Skeleton CreateSkeleton(const AnimationClip& clip)
+	{
+		Skeleton skeleton;
+		for (const BoneAnimation& boneAnimation : clip.BoneAnimations)
+		{
+			skeleton.Joints.push_back(boneAnimation.Joint);
+		}
+		return skeleton;
+	}
+
+	bool IsFramePosition(const BakedClipInfo& clipInfo, float frame, UINT expectedFrame0, UINT expectedFrame1, float expectedAlpha)
+	{
+		UINT frame0, frame1;
+		float alpha;
+		AnimationBaking::GetFramePosition(clipInfo, frame / clipInfo.FramePerSecond, frame0, frame1, alpha);
+		return frame0 == expectedFrame0 && frame1 == expectedFrame1 && std::fabs(alpha - expectedAlpha) < 1.0e-3f;
+	}
+}
+
+HEADLESS_TEST(AnimationBakingLayout)
+{
+	AnimationClip clip = CreateClip(10);
+	BakedAnimation baked = BakedAnimation::Bake(clip);
+
+	REQUIRE(baked.BoneCount == 3);
+	REQUIRE(baked.FrameCount == 10);
+	REQUIRE(baked.Palettes.size() == baked.FrameCount * baked.BoneCount);
+	CHECK(baked.FramePerSecond == clip.BoneAnimations.front().GetFramePerSecond());
+	CHECK(std::fabs(baked.GetEndTime() - clip.GetEndTime()) < 1.0e-6f);
+
+	//frame * BoneCount + bone 위치에 그 프레임 시간의 스키닝 행렬
+	std::vector<XMMATRIX> boneTransforms;
+	for (UINT frame = 0; frame < baked.FrameCount; ++frame)
+	{
+		clip.Interpolate(frame / baked.FramePerSecond, boneTransforms);
+		for (UINT boneIndex = 0; boneIndex < baked.BoneCount; ++boneIndex)
+		{
+			BoneTransform3x4 expected;
+			expected.Store(boneTransforms[boneIndex]);
+			CHECK(IsNear(baked.Palettes[frame * baked.BoneCount + boneIndex], expected, 1.0e-5f));
+		}
+	}
+
+	//본이 없는 클립
+	BakedAnimation empty = BakedAnimation::Bake(AnimationClip());
+	CHECK(empty.BoneCount == 0 && empty.Palettes.empty());
+}
+
+HEADLESS_TEST(AnimationBakingFramePosition)
+{
+	BakedClipInfo clipInfo;
+	clipInfo.FrameCount = 10;
+	clipInfo.BoneCount = 3;
+	clipInfo.FramePerSecond = 24.0f;
+
+	CHECK(IsFramePosition(clipInfo, 0.0f, 0, 1, 0.0f));
+	CHECK(IsFramePosition(clipInfo, 2.5f, 2, 3, 0.5f));
+	//끝을 지나면 처음부터
+	CHECK(IsFramePosition(clipInfo, 12.5f, 2, 3, 0.5f));
+	CHECK(IsFramePosition(clipInfo, 37.25f, 7, 8, 0.25f));
+	//음수 시간도 끝에서부터 되감음
+	CHECK(IsFramePosition(clipInfo, -2.5f, 7, 8, 0.5f));
+	CHECK(IsFramePosition(clipInfo, -23.5f, 6, 7, 0.5f));
+	//마지막 프레임 구간은 처음 프레임으로 보간하지 않음
+	CHECK(IsFramePosition(clipInfo, 9.5f, 9, 9, 0.5f));
+	CHECK(IsFramePosition(clipInfo, -0.25f, 9, 9, 0.75f));
+
+	//어떤 시간이든 범위 안
+	for (float frame = -35.0f; frame < 35.0f; frame += 0.37f)
+	{
+		UINT frame0, frame1;
+		float alpha;
+		AnimationBaking::GetFramePosition(clipInfo, frame / clipInfo.FramePerSecond, frame0, frame1, alpha);
+		REQUIRE(frame0 < clipInfo.FrameCount && frame1 < clipInfo.FrameCount);
+		REQUIRE(alpha >= 0.0f && alpha < 1.0f);
+	}
+}
+
+HEADLESS_TEST(AnimationBakingSampleMatchesShader)
+{
+	AnimationClip clip = CreateClip(10);
+	BakedAnimation baked = BakedAnimation::Bake(clip);
+	const float endTime = baked.GetEndTime();
+
+	std::vector<BoneTransform3x4> palette(baked.BoneCount);
+	for (float time = -2.0f * endTime; time < 3.0f * endTime; time += 0.013f)
+	{
+		baked.Sample(time, palette.data());
+		for (UINT boneIndex = 0; boneIndex < baked.BoneCount; ++boneIndex)
+		{
+			REQUIRE(IsNear(palette[boneIndex], GetShaderBoneTransform(baked, time, boneIndex), 1.0e-5f));
+		}
+	}
+
+	//프레임 시간에는 구운 팔레트 그대로
+	baked.Sample(4.0f / baked.FramePerSecond, palette.data());
+	for (UINT boneIndex = 0; boneIndex < baked.BoneCount; ++boneIndex)
+	{
+		CHECK(IsNear(palette[boneIndex], baked.Palettes[4 * baked.BoneCount + boneIndex], 1.0e-4f));
+	}
+}
+
+HEADLESS_TEST(AnimationBakingLoopMatchesPlayback)
+{
+	auto clip = std::make_shared<const AnimationClip>(CreateClip(10));
+	BakedAnimation baked = BakedAnimation::Bake(*clip);
+	Skeleton skeleton = CreateSkeleton(*clip);
+
+	//프레임 시간과 마지막 프레임 ~ 끝 시간 구간은 두 경로가 같은 포즈, 몇 바퀴 돈 뒤에도 같음
+	const float lastFrame = static_cast<float>(baked.FrameCount - 1);
+	std::vector<BoneTransform3x4> palette(baked.BoneCount);
+	for (int loop = 0; loop < 3; ++loop)
+	{
+		for (float frame : { 0.0f, 3.0f, lastFrame, lastFrame + 0.25f, lastFrame + 0.5f, lastFrame + 0.9f })
+		{
+			float time = (loop * baked.FrameCount + frame) / baked.FramePerSecond;
+			baked.Sample(time, palette.data());
+			std::vector<InstanceAnimations> playbackPalette = GetPlaybackPalette(clip, skeleton, time);
+			REQUIRE(playbackPalette.size() == baked.BoneCount);
+			for (UINT boneIndex = 0; boneIndex < baked.BoneCount; ++boneIndex)
+			{
+				CHECK(IsNear(palette[boneIndex], playbackPalette[boneIndex], 1.0e-4f));
+			}
+		}
+	}
+}
+
+HEADLESS_TEST(AnimationPoseBatchDirectWriteMatchesCallback)
+{
+	auto clip = std::make_shared<const AnimationClip>(CreateClip(10));
+	Skeleton skeleton = CreateSkeleton(*clip);
+	const size_t boneCount = skeleton.Joints.size();
+
+	//1번 본은 정점이 없는 본
+	std::vector<JointBounds> jointBounds(2);
+	jointBounds[0].JointIndex = 0;
+	jointBounds[0].Bounds = BoundingBox(XMFLOAT3(0.0f, 0.5f, 0.0f), XMFLOAT3(0.3f, 0.5f, 0.3f));
+	jointBounds[1].JointIndex = 2;
+	jointBounds[1].Bounds = BoundingBox(XMFLOAT3(0.0f, 2.5f, 0.1f), XMFLOAT3(0.2f, 0.5f, 0.2f));
+
+	const size_t instanceCount = 6;
+	const size_t captureInstance = 3;
+	std::vector<AnimationCalcuator> calculators(instanceCount);
+	for (size_t i = 0; i < instanceCount; ++i)
+	{
+		calculators[i].SetAnimationClip(clip);
+		calculators[i].SetLoop(true);
+		calculators[i].AddTime(0.07f * i);
+	}
+
+	AnimationPoseBatch poseBatch;
+	auto addPoses = [&](std::vector<InstanceAnimations>& capture)
+	{
+		poseBatch.Begin(skeleton);
+		for (size_t i = 0; i < instanceCount; ++i)
+		{
+			calculators[i].AddPoseSamples(poseBatch, poseBatch.AddPose(i, 0, i == captureInstance ? &capture : nullptr));
+		}
+	};
+
+	//임시 버퍼 + 콜백
+	std::vector<InstanceAnimations> expected(instanceCount * boneCount);
+	std::vector<InstanceAnimations> expectedCapture;
+	addPoses(expectedCapture);
+	poseBatch.Execute([&](size_t instanceIndex, const InstanceAnimations* palette)
+		{
+			std::copy(palette, palette + boneCount, expected.begin() + instanceIndex * boneCount);
+		});
+
+	//인스턴스 버퍼에 바로 쓰기, 캡처하는 포즈는 버퍼에 쓰지 않음
+	BoneTransform3x4 untouched;
+	untouched.Rows[0].w = 123.0f;
+	std::vector<InstanceAnimations> palettes(instanceCount * boneCount, untouched);
+	std::vector<InstanceAnimations> capture;
+	std::vector<BoundingBox> bounds(instanceCount);
+	std::vector<int> boundsWriteCounts(instanceCount, 0);
+	addPoses(capture);
+	poseBatch.Execute(palettes.data(), jointBounds, [&](size_t instanceIndex, const BoundingBox& instanceBounds)
+		{
+			bounds[instanceIndex] = instanceBounds;
+			boundsWriteCounts[instanceIndex]++;
+		});
+
+	REQUIRE(capture.size() == boneCount);
+	CHECK(IsNear(capture[1], expectedCapture[1], 0.0f));
+	for (size_t i = 0; i < instanceCount; ++i)
+	{
+		for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+		{
+			const InstanceAnimations& palette = palettes[i * boneCount + boneIndex];
+			CHECK(IsNear(palette, i == captureInstance ? untouched : expected[i * boneCount + boneIndex], 0.0f));
+		}
+		if (i == captureInstance)
+		{
+			CHECK(boundsWriteCounts[i] == 0);
+			continue;
+		}
+
+		//Skinning::ComputeSkinnedBounds와 같은 박스
+		CHECK(boundsWriteCounts[i] == 1);
+		BoundingBox expectedBounds;
+		Skinning::ComputeSkinnedBounds(&expected[i * boneCount], jointBounds, expectedBounds);
+		CHECK(XMVector3Equal(XMLoadFloat3(&bounds[i].Center), XMLoadFloat3(&expectedBounds.Center)));
+		CHECK(XMVector3Equal(XMLoadFloat3(&bounds[i].Extents), XMLoadFloat3(&expectedBounds.Extents)));
+	}
+}
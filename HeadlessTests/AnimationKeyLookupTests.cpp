@@ -0,0 +1,216 @@
+#include "HeadlessTest.h"
+#include "AnimationCompression.h"
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	//일정 간격마다 꺾이는 직선 이동과 회전, 꺾이는 곳에만 키가 남음
+	std::vector<AffineMatrix> CreateSparseFrames(uint32_t frameCount)
+	{
+		const uint32_t segmentLength = 12;
+		std::vector<AffineMatrix> frames(frameCount);
+		XMVECTOR translation = XMVectorZero();
+		XMVECTOR velocity = XMVectorSet(0.1f, 0.0f, 0.05f, 0.0f);
+		float angle = 0.0f;
+		float angularVelocity = 0.02f;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			if (frame % segmentLength == 0)
+			{
+				velocity = XMVectorSet(0.1f * ((frame / segmentLength) % 3), 0.02f, -0.05f, 0.0f);
+				angularVelocity = (frame / segmentLength) % 2 ? 0.02f : -0.01f;
+			}
+			frames[frame].Translation = translation;
+			frames[frame].Quaternion = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), angle);
+			translation = XMVectorAdd(translation, velocity);
+			angle += angularVelocity;
+		}
+		return frames;
+	}
+
+	//매 프레임 허용오차보다 크게 흔들려서 모든 프레임에 키가 남음
+	std::vector<AffineMatrix> CreateDenseFrames(uint32_t frameCount)
+	{
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+		std::vector<AffineMatrix> frames(frameCount);
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			frames[frame].Translation = XMVectorSet(noise(random), noise(random), noise(random), 0.0f);
+			frames[frame].Quaternion = XMQuaternionRotationRollPitchYaw(noise(random), noise(random), noise(random));
+		}
+		return frames;
+	}
+
+	CompressedBoneTrack CompressFrames(const std::vector<AffineMatrix>& frames,
+		const AnimationCompressionSettings& settings = AnimationCompressionSettings())
+	{
+		AnimationCompressionStats stats;
+		return AnimationCompressor::Compress(frames, settings, stats);
+	}
+
+	//DecodeLanes의 레인마다 Decode와 같은 값
+	template<class Track>
+	bool IsSameLanes(const Track& track, const size_t* keyIndices, int axisCount)
+	{
+		XMVECTOR lanes[4];
+		track.DecodeLanes(keyIndices, lanes);
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			float expected[4];
+			track.Decode(keyIndices[lane], expected);
+			for (int axis = 0; axis < axisCount; ++axis)
+			{
+				float value = XMVectorGetByIndex(lanes[axis], lane);
+				if (std::fabs(value - expected[axis]) > 1.0e-6f)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsSameSample(const CompressedBoneTrack& track, float frame, BoneTrackCursor& cursor)
+	{
+		XMVECTOR scale, rotation, translation;
+		XMVECTOR searchScale, searchRotation, searchTranslation;
+		track.Sample(frame, scale, rotation, translation, &cursor);
+		track.Sample(frame, searchScale, searchRotation, searchTranslation);
+		return XMVector4Equal(scale, searchScale) && XMVector4Equal(rotation, searchRotation) && XMVector4Equal(translation, searchTranslation);
+	}
+
+	//재생하듯이 step씩 진행하며 끝까지 샘플링, 커서를 넘기지 않으면 이진검색
+	double SampleClip(const std::vector<CompressedBoneTrack>& tracks, float step, int repeatCount, bool useCursor, XMVECTOR& checksum)
+	{
+		std::vector<BoneTrackCursor> cursors(tracks.size());
+		const float lastFrame = static_cast<float>(tracks.front().FrameCount - 1);
+
+		HeadlessTest::Timer timer;
+		for (int repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			for (float frame = 0.0f; frame <= lastFrame; frame += step)
+			{
+				for (size_t i = 0; i < tracks.size(); ++i)
+				{
+					XMVECTOR scale, rotation, translation;
+					tracks[i].Sample(frame, scale, rotation, translation, useCursor ? &cursors[i] : nullptr);
+					checksum = XMVectorAdd(checksum, XMVectorAdd(rotation, translation));
+				}
+			}
+		}
+		return timer.GetMilliseconds();
+	}
+}
+
+HEADLESS_TEST(AnimationKeyDecodeLanesMatchesDecode)
+{
+	std::vector<AffineMatrix> frames = CreateDenseFrames(200);
+	for (AffineMatrix& frame : frames)
+	{
+		frame.Scale = XMVectorAdd(g_XMOne, XMVectorScale(frame.Translation, 0.5f));
+	}
+
+	//허용오차가 작으면 양자화하지 않은 트랙
+	AnimationCompressionSettings rawSettings;
+	rawSettings.TranslationTolerance = 1.0e-7f;
+	rawSettings.RotationTolerance = 1.0e-7f;
+	rawSettings.ScaleTolerance = 1.0e-7f;
+
+	for (bool isQuantized : { true, false })
+	{
+		CompressedBoneTrack track = CompressFrames(frames, isQuantized ? AnimationCompressionSettings() : rawSettings);
+		CHECK(track.Translation.RawValues.empty() == isQuantized);
+		CHECK(track.Rotation.RawValues.empty() == isQuantized);
+
+		//가장 큰 성분 위치가 레인마다 다르도록 임의 키
+		std::mt19937 random(11);
+		auto isSameRandomLanes = [&](const auto& channel, int axisCount)
+		{
+			std::uniform_int_distribution<size_t> key(0, channel.Frames.size() - 1);
+			const size_t keyIndices[4] = { key(random), key(random), key(random), key(random) };
+			return IsSameLanes(channel, keyIndices, axisCount);
+		};
+		for (int i = 0; i < 200; ++i)
+		{
+			REQUIRE(isSameRandomLanes(track.Scale, 3));
+			REQUIRE(isSameRandomLanes(track.Rotation, 4));
+			REQUIRE(isSameRandomLanes(track.Translation, 3));
+		}
+	}
+}
+
+HEADLESS_TEST(AnimationKeyCursorMatchesBinarySearch)
+{
+	for (uint32_t frameCount : { 2u, 30u, 301u, 3000u })
+	{
+		for (bool isDense : { false, true })
+		{
+			CompressedBoneTrack track = CompressFrames(isDense ? CreateDenseFrames(frameCount) : CreateSparseFrames(frameCount));
+			const float lastFrame = static_cast<float>(frameCount - 1);
+
+			//밀집 트랙은 인덱스를 바로 계산하는 경로, 나머지는 커서 경로
+			if (isDense)
+			{
+				CHECK(track.Translation.Frames.size() == frameCount);
+			}
+			else if (frameCount > 30)
+			{
+				CHECK(track.Translation.Frames.size() < frameCount / 4);
+			}
+
+			//정방향 재생, 루프로 처음으로 돌아감
+			BoneTrackCursor cursor;
+			for (int loop = 0; loop < 2; ++loop)
+			{
+				for (float frame = 0.0f; frame <= lastFrame; frame += 0.37f)
+				{
+					REQUIRE(IsSameSample(track, frame, cursor));
+				}
+			}
+
+			//임의 위치로 이동, 범위 밖 포함
+			std::mt19937 random(frameCount);
+			std::uniform_real_distribution<float> seek(-2.0f, lastFrame + 2.0f);
+			for (int i = 0; i < 500; ++i)
+			{
+				REQUIRE(IsSameSample(track, seek(random), cursor));
+			}
+
+			//키 프레임 위치 그대로
+			for (uint32_t keyFrame : track.Translation.Frames)
+			{
+				REQUIRE(IsSameSample(track, static_cast<float>(keyFrame), cursor));
+			}
+		}
+	}
+}
+
+HEADLESS_BENCH(AnimationKeyLookup)
+{
+	const size_t boneCount = 64;
+	//30fps 클립을 60fps로 재생
+	const float step = 0.5f;
+
+	for (uint32_t frameCount : { 30u, 300u, 3000u, 30000u })
+	{
+		std::vector<CompressedBoneTrack> sparseTracks(boneCount, CompressFrames(CreateSparseFrames(frameCount)));
+		std::vector<CompressedBoneTrack> denseTracks(boneCount, CompressFrames(CreateDenseFrames(frameCount)));
+
+		//클립 길이와 상관없이 비슷한 샘플 수
+		int repeatCount = (std::max)(1, static_cast<int>(60000 / frameCount));
+		double sampleCount = static_cast<double>(repeatCount) * (static_cast<int>((frameCount - 1) / step) + 1) * boneCount;
+
+		XMVECTOR checksum = XMVectorZero();
+		double searchTime = SampleClip(sparseTracks, step, repeatCount, false, checksum);
+		double cursorTime = SampleClip(sparseTracks, step, repeatCount, true, checksum);
+		double directTime = SampleClip(denseTracks, step, repeatCount, false, checksum);
+
+		printf("  %5u frames (%4zu keys), ns/sample : binary search %.1f, cursor %.1f, every frame key %.1f (%.0f)\n",
+			frameCount, sparseTracks.front().Translation.Frames.size(),
+			searchTime * 1.0e6 / sampleCount, cursorTime * 1.0e6 / sampleCount, directTime * 1.0e6 / sampleCount,
+			XMVectorGetX(checksum));
+	}
+}
@@ -0,0 +1,313 @@
+#include "HeadlessTest.h"
+#include "DescriptorChunkCache.h"
+#include <map>
+#include <set>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+
+namespace
+{
+	//디바이스 없는 힙, GPUDescriptorHeap의 동적 영역과 같은 방식으로 관리
+	//해제는 프레임 완료까지 대기열에 두고 ReleaseStaleAllocations에서 캐시를 먼저 반환함
+	class FakeDescriptorHeap : public IDescriptorChunkSource
+	{
+	public:
+		struct ChunkInfo
+		{
+			OffsetType Offset;
+			uint32_t Count;
+			std::thread::id ThreadId;
+		};
+	public:
+		FakeDescriptorHeap(OffsetType size, uint32_t chunkSize)
+			: m_manager(size), m_threadCaches(this, chunkSize)
+		{
+		}
+
+		virtual DescriptorRange AllocateChunk(uint32_t count) override
+		{
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			DescriptorRange chunk;
+			chunk.Offset = m_manager.Allocate(count);
+			if (chunk.IsNull())
+			{
+				return DescriptorRange();
+			}
+			chunk.Owner = this;
+			chunk.Count = count;
+			m_chunks.push_back({ chunk.Offset, count, std::this_thread::get_id() });
+			return chunk;
+		}
+
+		virtual void ReturnChunk(const DescriptorRange& chunk, const std::vector<uint32_t>& usedSizes) override
+		{
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			m_manager.SplitAllocation(chunk.Offset, chunk.Count, usedSizes);
+			m_returnedChunkCount++;
+		}
+
+		//캐시에서 못받으면 공유 매니저에서 할당
+		DescriptorRange AllocateDynamic(uint32_t count)
+		{
+			DescriptorRange range = m_threadCaches.Allocate(count);
+			if (range.IsNull() == false)
+			{
+				return range;
+			}
+
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			range.Offset = m_manager.Allocate(count);
+			if (range.IsNull() == false)
+			{
+				range.Owner = this;
+				range.Count = count;
+			}
+			return range;
+		}
+
+		void Free(const DescriptorRange& range, uint64_t frameNumber)
+		{
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			m_manager.Free(range.Offset, range.Count, frameNumber);
+		}
+
+		void ReleaseStaleAllocations(uint64_t numCompletedFrames)
+		{
+			m_threadCaches.Flush();
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			m_manager.ReleaseCompletedFrames(numCompletedFrames);
+		}
+
+		VariableSizeAllocationStats GetStats() const { return m_manager.GetStats(); }
+		const std::vector<ChunkInfo>& GetChunks() const { return m_chunks; }
+		size_t GetReturnedChunkCount() const { return m_returnedChunkCount; }
+		ThreadDescriptorCaches& GetThreadCaches() { return m_threadCaches; }
+
+	private:
+		std::mutex m_mutex;
+		VariableSizeGPUAllocationsManager m_manager;
+		ThreadDescriptorCaches m_threadCaches;
+		std::vector<ChunkInfo> m_chunks;
+		size_t m_returnedChunkCount = 0;
+	};
+
+	bool IsDisjoint(const std::vector<DescriptorRange>& ranges)
+	{
+		std::vector<DescriptorRange> sorted = ranges;
+		std::sort(sorted.begin(), sorted.end(), [](const DescriptorRange& a, const DescriptorRange& b) { return a.Offset < b.Offset; });
+		for (size_t i = 1; i < sorted.size(); ++i)
+		{
+			if (sorted[i - 1].Offset + sorted[i - 1].Count > sorted[i].Offset)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32_t GetTotalCount(const std::vector<DescriptorRange>& ranges)
+	{
+		return std::accumulate(ranges.begin(), ranges.end(), 0u, [](uint32_t sum, const DescriptorRange& range) { return sum + range.Count; });
+	}
+}
+
+HEADLESS_TEST(DescriptorCacheChunkRefill)
+{
+	FakeDescriptorHeap heap(256, 8);
+	DescriptorChunkCache cache(&heap, 8);
+
+	DescriptorRange first = cache.Allocate(3);
+	DescriptorRange second = cache.Allocate(3);
+	REQUIRE(first.IsNull() == false && second.IsNull() == false);
+	CHECK(second.Offset == first.Offset + 3);
+	CHECK(cache.GetRemainCount() == 2);
+	CHECK(heap.GetChunks().size() == 1);
+
+	//남은 2개로 모자라면 이전 청크를 반환하고 새 청크에서 할당
+	DescriptorRange third = cache.Allocate(3);
+	REQUIRE(third.IsNull() == false);
+	CHECK(heap.GetChunks().size() == 2);
+	CHECK(heap.GetReturnedChunkCount() == 1);
+	CHECK(third.Offset == heap.GetChunks()[1].Offset);
+	CHECK(cache.GetRemainCount() == 5);
+
+	//반환된 청크의 남은 2개는 빈공간, 새 청크는 통째로 사용중
+	VariableSizeAllocationStats stats = heap.GetStats();
+	CHECK(stats.AllocationCount == 3);
+	CHECK(stats.FreeSize == 256 - 6 - 8);
+	CHECK(IsDisjoint({ first, second, third }));
+}
+
+HEADLESS_TEST(DescriptorCacheFlushSplitsChunk)
+{
+	FakeDescriptorHeap heap(128, 16);
+	DescriptorChunkCache cache(&heap, 16);
+
+	std::vector<DescriptorRange> ranges;
+	for (uint32_t count : { 2u, 5u, 1u })
+	{
+		ranges.push_back(cache.Allocate(count));
+		REQUIRE(ranges.back().IsNull() == false);
+	}
+	CHECK(heap.GetStats().AllocationCount == 1);
+
+	//Flush 후 잘라준 구간마다 독립된 할당, 남은 8개는 해제
+	cache.Flush();
+	CHECK(cache.GetRemainCount() == 0);
+	VariableSizeAllocationStats stats = heap.GetStats();
+	CHECK(stats.AllocationCount == 3);
+	CHECK(stats.FreeSize == 128 - 8);
+	CHECK(stats.FreeBlockCount == 1);
+
+	//빈 캐시의 Flush는 아무것도 하지 않음
+	cache.Flush();
+	CHECK(heap.GetReturnedChunkCount() == 1);
+
+	//가운데부터 순서와 상관없이 각각 해제 가능
+	heap.Free(ranges[1], 0);
+	heap.Free(ranges[0], 0);
+	heap.Free(ranges[2], 0);
+	heap.ReleaseStaleAllocations(1);
+	stats = heap.GetStats();
+	CHECK(stats.FreeSize == 128);
+	CHECK(stats.FreeBlockCount == 1);
+	CHECK(stats.AllocationCount == 0);
+}
+
+HEADLESS_TEST(DescriptorCacheFreeBeforeAndAfterFlush)
+{
+	FakeDescriptorHeap heap(128, 16);
+
+	//Flush 전 해제, 대기열에 있다가 ReleaseStaleAllocations에서 Flush 후 해제됨
+	DescriptorRange beforeFlush = heap.AllocateDynamic(4);
+	DescriptorRange kept = heap.AllocateDynamic(4);
+	REQUIRE(beforeFlush.IsNull() == false && kept.IsNull() == false);
+	heap.Free(beforeFlush, 0);
+	CHECK(heap.GetStats().StaleAllocationCount == 1);
+
+	heap.ReleaseStaleAllocations(1);
+	VariableSizeAllocationStats stats = heap.GetStats();
+	CHECK(stats.StaleAllocationCount == 0);
+	CHECK(stats.AllocationCount == 1);
+	CHECK(stats.FreeSize == 128 - 4);
+
+	//Flush 후 해제
+	heap.Free(kept, 1);
+	//완료되지 않은 프레임이면 그대로 대기
+	heap.ReleaseStaleAllocations(1);
+	CHECK(heap.GetStats().StaleAllocationCount == 1);
+	heap.ReleaseStaleAllocations(2);
+	stats = heap.GetStats();
+	CHECK(stats.FreeSize == 128);
+	CHECK(stats.FreeBlockCount == 1);
+
+	//Flush 후 같은 스레드는 새 청크를 받아서 계속 할당
+	DescriptorRange next = heap.AllocateDynamic(4);
+	CHECK(next.IsNull() == false);
+	CHECK(heap.GetChunks().size() == 2);
+}
+
+HEADLESS_TEST(DescriptorCacheOversizedRequest)
+{
+	FakeDescriptorHeap heap(128, 8);
+	DescriptorChunkCache cache(&heap, 8);
+
+	CHECK(cache.Allocate(9).IsNull());
+	CHECK(cache.Allocate(0).IsNull());
+	CHECK(heap.GetThreadCaches().Allocate(9).IsNull());
+	//청크를 받지 않고 공유 매니저에서 할당
+	CHECK(heap.GetChunks().empty());
+
+	DescriptorRange large = heap.AllocateDynamic(20);
+	REQUIRE(large.IsNull() == false);
+	CHECK(large.Count == 20);
+	CHECK(heap.GetChunks().empty());
+
+	//청크 크기와 같으면 캐시에서 할당
+	DescriptorRange exact = cache.Allocate(8);
+	CHECK(exact.IsNull() == false);
+	CHECK(heap.GetChunks().size() == 1);
+	CHECK(cache.GetRemainCount() == 0);
+
+	//힙이 모자라 청크를 못받으면 IsNull
+	FakeDescriptorHeap smallHeap(4, 8);
+	DescriptorChunkCache smallCache(&smallHeap, 8);
+	CHECK(smallCache.Allocate(1).IsNull());
+}
+
+HEADLESS_TEST(DescriptorCacheMultipleThreads)
+{
+	const int threadCount = 4;
+	const int allocationCount = 500;
+	const OffsetType heapSize = 1 << 14;
+	FakeDescriptorHeap heap(heapSize, 32);
+
+	std::vector<std::vector<DescriptorRange>> threadRanges(threadCount);
+	std::vector<std::thread::id> threadIds(threadCount);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&heap, &threadRanges, &threadIds, t]()
+			{
+				threadIds[t] = std::this_thread::get_id();
+				for (int i = 0; i < allocationCount; ++i)
+				{
+					//가끔 청크보다 큰 요청을 섞음
+					uint32_t count = (i % 50 == 0) ? 40 : 1 + (i * 7 + t) % 9;
+					threadRanges[t].push_back(heap.AllocateDynamic(count));
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::vector<DescriptorRange> allRanges;
+	for (const auto& ranges : threadRanges)
+	{
+		for (const auto& range : ranges)
+		{
+			REQUIRE(range.IsNull() == false);
+		}
+		allRanges.insert(allRanges.end(), ranges.begin(), ranges.end());
+	}
+	CHECK(IsDisjoint(allRanges));
+
+	//캐시에서 받은 구간은 그 스레드가 받은 청크 안에 있어야함
+	for (int t = 0; t < threadCount; ++t)
+	{
+		for (const auto& range : threadRanges[t])
+		{
+			if (range.Count > 32)
+			{
+				continue;
+			}
+			bool isInOwnChunk = false;
+			for (const auto& chunk : heap.GetChunks())
+			{
+				if (range.Offset >= chunk.Offset && range.Offset + range.Count <= chunk.Offset + chunk.Count)
+				{
+					isInOwnChunk = chunk.ThreadId == threadIds[t];
+					break;
+				}
+			}
+			CHECK(isInOwnChunk);
+		}
+	}
+
+	heap.ReleaseStaleAllocations(0);
+	VariableSizeAllocationStats stats = heap.GetStats();
+	CHECK(stats.AllocationCount == allRanges.size());
+	CHECK(stats.FreeSize == heapSize - GetTotalCount(allRanges));
+
+	for (const auto& range : allRanges)
+	{
+		heap.Free(range, 0);
+	}
+	heap.ReleaseStaleAllocations(1);
+	stats = heap.GetStats();
+	CHECK(stats.FreeSize == heapSize);
+	CHECK(stats.FreeBlockCount == 1);
+}
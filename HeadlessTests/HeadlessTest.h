@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+//디바이스 없이 돌리는 테스트, 벤치마크 등록
+//HEADLESS_TEST는 항상, HEADLESS_BENCH는 --bench 인자가 있을때만 실행
+namespace HeadlessTest
+{
+	typedef void (*TestFunction)();
+
+	struct TestEntry
+	{
+		const char* Name;
+		TestFunction Function;
+		bool IsBench;
+	};
+
+	inline std::vector<TestEntry>& GetEntries()
+	{
+		static std::vector<TestEntry> entries;
+		return entries;
+	}
+
+	//현재 테스트의 실패 수
+	inline int& GetFailCount()
+	{
+		static int failCount = 0;
+		return failCount;
+	}
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestFunction function, bool isBench)
+		{
+			GetEntries().push_back({ name, function, isBench });
+		}
+	};
+
+	inline void ReportFailure(const char* file, int line, const char* expression)
+	{
+		printf("  FAILED %s(%d) : %s\n", file, line, expression);
+		++GetFailCount();
+	}
+
+	//벤치마크 시간 측정
+	class Timer
+	{
+	public:
+		Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+		double GetMilliseconds() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+		}
+	private:
+		std::chrono::steady_clock::time_point m_start;
+	};
+}
+
+#define HEADLESS_CONCAT_IMPL(a, b) a##b
+#define HEADLESS_CONCAT(a, b) HEADLESS_CONCAT_IMPL(a, b)
+
+#define HEADLESS_REGISTER(name, isBench) \
+	static void name(); \
+	static HeadlessTest::Registrar HEADLESS_CONCAT(name, Registrar)(#name, name, isBench); \
+	static void name()
+
+#define HEADLESS_TEST(name) HEADLESS_REGISTER(name, false)
+#define HEADLESS_BENCH(name) HEADLESS_REGISTER(name, true)
+
+//실패해도 테스트를 계속 진행
+#define CHECK(expression) \
+	do { if (!(expression)) { HeadlessTest::ReportFailure(__FILE__, __LINE__, #expression); } } while (0)
+
+//실패하면 현재 테스트 중단
+#define REQUIRE(expression) \
+	do { if (!(expression)) { HeadlessTest::ReportFailure(__FILE__, __LINE__, #expression); return; } } while (0)
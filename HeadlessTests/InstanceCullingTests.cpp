@@ -0,0 +1,191 @@
+#include "HeadlessTest.h"
+#include "InstanceCulling.h"
+#include <float.h>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	//원점에서 +z를 보는 카메라
+	Camera CreateCamera(float farZ)
+	{
+		Camera camera;
+		camera.SetLens(0.25f * MathHelper::Pi, 16.0f / 9.0f, 1.0f, farZ);
+		camera.LookAt(XMFLOAT3(0.0f, 2.0f, 0.0f), XMFLOAT3(0.0f, 2.0f, 1.0f), XMFLOAT3(0.0f, 1.0f, 0.0f));
+		camera.UpdateViewMatrix();
+		return camera;
+	}
+
+	//박스 꼭지점 8개를 클립 공간으로 옮겨서 모두 같은 평면 밖이면 false
+	//plane margin : 경계에서 float 오차로 결과가 갈리는 박스는 margin이 0에 가까움
+	bool IsVisibleByCorners(const BoundingBox& box, FXMMATRIX viewProj, float& planeMargin)
+	{
+		XMFLOAT4 clipCorners[8];
+		for (int i = 0; i < 8; ++i)
+		{
+			XMVECTOR corner = XMVectorSet(
+				box.Center.x + (i & 1 ? box.Extents.x : -box.Extents.x),
+				box.Center.y + (i & 2 ? box.Extents.y : -box.Extents.y),
+				box.Center.z + (i & 4 ? box.Extents.z : -box.Extents.z), 1.0f);
+			XMStoreFloat4(&clipCorners[i], XMVector4Transform(corner, viewProj));
+		}
+
+		bool isVisible = true;
+		planeMargin = FLT_MAX;
+		for (int plane = 0; plane < 6; ++plane)
+		{
+			//-w <= x,y <= w, 0 <= z <= w
+			float maxDistance = -FLT_MAX;
+			for (const XMFLOAT4& clip : clipCorners)
+			{
+				const float distances[6] = { clip.w + clip.x, clip.w - clip.x, clip.w + clip.y, clip.w - clip.y, clip.z, clip.w - clip.z };
+				maxDistance = (std::max)(maxDistance, distances[plane]);
+			}
+			if (maxDistance < 0.0f)
+			{
+				isVisible = false;
+			}
+			planeMargin = (std::min)(planeMargin, std::fabs(maxDistance));
+		}
+		return isVisible;
+	}
+
+	struct TestInstance
+	{
+		AffineMatrix Transform;
+		BoundingBox LocalBounds;
+	};
+
+	//카메라 주변 size x size 영역에 흩어진 인스턴스, 절반 정도는 카메라 뒤
+	std::vector<TestInstance> CreateInstances(size_t count, float size)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-size * 0.5f, size * 0.5f);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		std::vector<TestInstance> instances(count);
+		for (auto& instance : instances)
+		{
+			instance.Transform.Translation = XMVectorSet(position(random), unit(random) * 4.0f, position(random), 0.0f);
+			instance.Transform.Quaternion = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), unit(random) * MathHelper::Pi * 2.0f);
+			float scale = 0.5f + unit(random);
+			instance.Transform.Scale = XMVectorSet(scale, scale, scale, 0.0f);
+			instance.LocalBounds = BoundingBox(XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.5f, 1.0f, 0.5f));
+		}
+		return instances;
+	}
+}
+
+HEADLESS_TEST(InstanceCullingKnownBoxes)
+{
+	Camera camera = CreateCamera(100.0f);
+	InstanceCullingSystem cullingSystem;
+	cullingSystem.BeginFrame(camera);
+
+	const XMFLOAT3 unitExtents(0.5f, 0.5f, 0.5f);
+	//정면
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, 10.0f), unitExtents)));
+	//카메라 뒤, 좌우, 위아래
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, -10.0f), unitExtents)) == false);
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(-50.0f, 2.0f, 10.0f), unitExtents)) == false);
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(50.0f, 2.0f, 10.0f), unitExtents)) == false);
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 50.0f, 10.0f), unitExtents)) == false);
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, -50.0f, 10.0f), unitExtents)) == false);
+	//far 평면 밖, 걸침
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, 110.0f), unitExtents)) == false);
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, 100.2f), unitExtents)));
+	//near 평면에 걸침, 카메라를 감싸는 큰 박스
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, 1.0f), unitExtents)));
+	CHECK(cullingSystem.IsVisible(BoundingBox(XMFLOAT3(0.0f, 2.0f, 0.0f), XMFLOAT3(200.0f, 200.0f, 200.0f))));
+}
+
+HEADLESS_TEST(InstanceCullingMatchesCornerTest)
+{
+	Camera camera = CreateCamera(150.0f);
+	InstanceCullingSystem cullingSystem;
+	cullingSystem.BeginFrame(camera);
+	XMMATRIX viewProj = XMMatrixMultiply(camera.GetView(), camera.GetProj());
+
+	std::vector<TestInstance> instances = CreateInstances(20000, 400.0f);
+	size_t visibleCount = 0;
+	for (const auto& instance : instances)
+	{
+		BoundingBox worldBounds;
+		instance.LocalBounds.Transform(worldBounds, instance.Transform.GetFinalTransformMatrix());
+
+		float planeMargin;
+		bool isVisible = IsVisibleByCorners(worldBounds, viewProj, planeMargin);
+		if (planeMargin > 1.0e-3f)
+		{
+			CHECK(cullingSystem.IsVisible(worldBounds) == isVisible);
+		}
+		visibleCount += isVisible ? 1 : 0;
+	}
+	//카메라 앞쪽 일부만 보여야함
+	CHECK(visibleCount > 0 && visibleCount < instances.size() / 2);
+}
+
+HEADLESS_BENCH(InstanceCulling100k)
+{
+	const size_t instanceCount = 100000;
+	const int frameCount = 20;
+
+	Camera camera = CreateCamera(300.0f);
+	InstanceCullingSystem cullingSystem;
+	std::vector<TestInstance> instances = CreateInstances(instanceCount, 800.0f);
+	XMMATRIX objectTransform = XMMatrixIdentity();
+
+	//MeshObject::UpdateInstanceBuffers와 같이 월드 박스 계산 + 판정
+	size_t visibleCount = 0;
+	HeadlessTest::Timer cullingTimer;
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		cullingSystem.BeginFrame(camera);
+		visibleCount = 0;
+		for (const auto& instance : instances)
+		{
+			BoundingBox worldBounds;
+			instance.LocalBounds.Transform(worldBounds, XMMatrixMultiply(instance.Transform.GetFinalTransformMatrix(), objectTransform));
+			visibleCount += cullingSystem.IsVisible(worldBounds) ? 1 : 0;
+		}
+	}
+	double cullingTime = cullingTimer.GetMilliseconds() / frameCount;
+
+	//판정만
+	std::vector<BoundingBox> worldBounds(instanceCount);
+	for (size_t i = 0; i < instanceCount; ++i)
+	{
+		instances[i].LocalBounds.Transform(worldBounds[i], instances[i].Transform.GetFinalTransformMatrix());
+	}
+	size_t testVisibleCount = 0;
+	HeadlessTest::Timer testTimer;
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		testVisibleCount = 0;
+		for (const auto& bounds : worldBounds)
+		{
+			testVisibleCount += cullingSystem.IsVisible(bounds) ? 1 : 0;
+		}
+	}
+	double testTime = testTimer.GetMilliseconds() / frameCount;
+
+	//꼭지점 8개를 변환하는 단순한 방법
+	XMMATRIX viewProj = XMMatrixMultiply(camera.GetView(), camera.GetProj());
+	size_t cornerVisibleCount = 0;
+	HeadlessTest::Timer cornerTimer;
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		cornerVisibleCount = 0;
+		for (const auto& bounds : worldBounds)
+		{
+			float planeMargin;
+			cornerVisibleCount += IsVisibleByCorners(bounds, viewProj, planeMargin) ? 1 : 0;
+		}
+	}
+	double cornerTime = cornerTimer.GetMilliseconds() / frameCount;
+
+	CHECK(visibleCount == testVisibleCount);
+	printf("  %zu instances, %zu visible, ms/frame : bounds + test %.2f, test only %.2f, corner test %.2f (%zu visible)\n",
+		instanceCount, visibleCount, cullingTime, testTime, cornerTime, cornerVisibleCount);
+}
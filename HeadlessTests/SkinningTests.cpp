@@ -0,0 +1,342 @@
+#include "HeadlessTest.h"
+#include "Skinning.h"
+#include <float.h>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	BoneTransform3x4 CreateBone(float scale, FXMVECTOR axis, float angle, FXMVECTOR translation)
+	{
+		XMMATRIX transform = XMMatrixMultiply(XMMatrixScaling(scale, scale, scale), XMMatrixRotationAxis(axis, angle));
+		transform = XMMatrixMultiply(transform, XMMatrixTranslationFromVector(translation));
+		BoneTransform3x4 bone;
+		bone.Store(transform);
+		return bone;
+	}
+
+	//본마다 다른 축으로 maxAngle까지 회전 + 이동, scale이 1이 아니면 짝수 본에만 스케일
+	std::vector<BoneTransform3x4> CreatePalette(size_t boneCount, float scale, float maxAngle = XM_PI)
+	{
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::vector<BoneTransform3x4> palette(boneCount);
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			XMVECTOR axis = XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random) + 2.0f, 0.0f));
+			XMVECTOR translation = XMVectorSet(unit(random) * 3.0f, unit(random) * 3.0f, unit(random) * 3.0f, 0.0f);
+			palette[i] = CreateBone(i % 2 == 0 ? scale : 1.0f, axis, unit(random) * maxAngle, translation);
+		}
+		return palette;
+	}
+
+	//영향 본 1~4개, 가중치 합 1, 안쓰는 자리는 가중치 0에 임의 본 인덱스
+	std::vector<Vertex> CreateVertices(size_t vertexCount, UINT boneCount)
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_int_distribution<UINT> bone(0, boneCount - 1);
+		std::vector<Vertex> vertices(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			Vertex& vertex = vertices[i];
+			vertex.Pos = XMFLOAT3(unit(random) * 2.0f, unit(random) * 2.0f, unit(random) * 2.0f);
+			XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random) + 2.0f, 0.0f)));
+			vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+
+			int influenceCount = static_cast<int>(i % 4) + 1;
+			float weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float weightSum = 0.0f;
+			for (int j = 0; j < influenceCount; ++j)
+			{
+				weights[j] = 0.1f + (unit(random) + 1.0f);
+				weightSum += weights[j];
+			}
+			vertex.BoneWeights = XMFLOAT4(weights[0] / weightSum, weights[1] / weightSum, weights[2] / weightSum, weights[3] / weightSum);
+			vertex.BoneIndices = XMUINT4(bone(random), bone(random), bone(random), bone(random));
+		}
+		return vertices;
+	}
+
+	bool IsNear(const XMFLOAT3& a, const XMFLOAT3& b, float epsilon)
+	{
+		return XMVector3NearEqual(XMLoadFloat3(&a), XMLoadFloat3(&b), XMVectorReplicate(epsilon));
+	}
+
+	bool IsNear(const XMFLOAT3& a, float x, float y, float z)
+	{
+		return IsNear(a, XMFLOAT3(x, y, z), 1.0e-5f);
+	}
+}
+
+HEADLESS_TEST(SkinningKnownValues)
+{
+	const XMVECTOR axisZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+	std::vector<BoneTransform3x4> palette = {
+		CreateBone(1.0f, axisZ, 0.0f, XMVectorZero()),
+		CreateBone(1.0f, axisZ, XM_PIDIV2, XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f)),
+		CreateBone(1.0f, axisZ, XM_PIDIV2, XMVectorZero()),
+		CreateBone(1.0f, axisZ, XM_PIDIV2, XMVectorSet(2.0f, 0.0f, 0.0f, 0.0f)),
+		CreateBone(1.0f, axisZ, XM_PIDIV2, XMVectorZero()) };
+	std::vector<DualQuaternionTransform> dualQuaternions(palette.size());
+	Skinning::ToDualQuaternions(palette.data(), dualQuaternions.data(), palette.size());
+	//2번과 같은 변환을 반대 부호 쿼터니언으로
+	XMStoreFloat4(&dualQuaternions[4].Real, XMVectorNegate(XMLoadFloat4(&dualQuaternions[4].Real)));
+	XMStoreFloat4(&dualQuaternions[4].Dual, XMVectorNegate(XMLoadFloat4(&dualQuaternions[4].Dual)));
+
+	Vertex vertex = {};
+	vertex.Pos = XMFLOAT3(1.0f, 0.0f, 0.0f);
+	vertex.Normal = XMFLOAT3(1.0f, 0.0f, 0.0f);
+	XMFLOAT3 position[3], normal[3];
+	auto skin = [&](UINT bone0, UINT bone1, float weight0)
+	{
+		vertex.BoneIndices = XMUINT4(bone0, bone1, 0, 0);
+		vertex.BoneWeights = XMFLOAT4(weight0, 1.0f - weight0, 0.0f, 0.0f);
+		Skinning::SkinVerticesScalar(&vertex, 1, palette.data(), &position[0], &normal[0]);
+		Skinning::SkinVertices(&vertex, 1, palette.data(), &position[1], &normal[1]);
+		Skinning::SkinVertices(&vertex, 1, dualQuaternions.data(), &position[2], &normal[2]);
+	};
+
+	//본 하나면 세 방법 모두 그 본의 변환
+	skin(1, 0, 1.0f);
+	for (int i = 0; i < 3; ++i)
+	{
+		CHECK(IsNear(position[i], 1.0f, 1.0f, 0.0f));
+		CHECK(IsNear(normal[i], 0.0f, 1.0f, 0.0f));
+	}
+
+	//0도, 90도 반반 : 선형은 길이가 줄어듦, 듀얼쿼터니언은 45도 회전
+	skin(0, 2, 0.5f);
+	CHECK(IsNear(position[0], 0.5f, 0.5f, 0.0f));
+	CHECK(IsNear(position[1], 0.5f, 0.5f, 0.0f));
+	CHECK(IsNear(normal[1], 0.5f, 0.5f, 0.0f));
+	const float halfSqrt2 = sqrtf(0.5f);
+	CHECK(IsNear(position[2], halfSqrt2, halfSqrt2, 0.0f));
+	CHECK(IsNear(normal[2], halfSqrt2, halfSqrt2, 0.0f));
+
+	//회전이 같고 이동만 다르면 세 방법 모두 이동의 평균
+	skin(2, 3, 0.25f);
+	for (int i = 0; i < 3; ++i)
+	{
+		CHECK(IsNear(position[i], 1.5f, 1.0f, 0.0f));
+		CHECK(IsNear(normal[i], 0.0f, 1.0f, 0.0f));
+	}
+
+	//부호가 반대인 쿼터니언은 같은 반구로 뒤집어서 더함
+	skin(2, 4, 0.5f);
+	CHECK(IsNear(position[2], 0.0f, 1.0f, 0.0f));
+	CHECK(IsNear(normal[2], 0.0f, 1.0f, 0.0f));
+}
+
+HEADLESS_TEST(SkinningKernelsMatchOnFixture)
+{
+	const UINT boneCount = 16;
+	//AVX2는 8개씩이라 나머지 정점도 생기게
+	std::vector<Vertex> vertices = CreateVertices(4003, boneCount);
+	std::vector<XMFLOAT3> scalarPositions(vertices.size()), scalarNormals(vertices.size());
+	std::vector<XMFLOAT3> simdPositions(vertices.size()), simdNormals(vertices.size());
+	std::vector<XMFLOAT3> avx2Positions(vertices.size()), avx2Normals(vertices.size());
+	std::vector<XMFLOAT3> dualPositions(vertices.size()), dualNormals(vertices.size());
+	const bool isAvx2Supported = Skinning::IsAvx2Supported();
+	if (isAvx2Supported == false)
+	{
+		printf("  AVX2 not supported, skip AVX2 kernel\n");
+	}
+
+	for (float scale : { 1.0f, 2.5f })
+	{
+		std::vector<BoneTransform3x4> palette = CreatePalette(boneCount, scale);
+		std::vector<DualQuaternionTransform> dualQuaternions(boneCount);
+		Skinning::ToDualQuaternions(palette.data(), dualQuaternions.data(), boneCount);
+
+		Skinning::SkinVerticesScalar(vertices.data(), vertices.size(), palette.data(), scalarPositions.data(), scalarNormals.data());
+		Skinning::SkinVerticesSse2(vertices.data(), vertices.size(), palette.data(), simdPositions.data(), simdNormals.data());
+		if (isAvx2Supported)
+		{
+			Skinning::SkinVerticesAvx2(vertices.data(), vertices.size(), palette.data(), avx2Positions.data(), avx2Normals.data());
+		}
+		Skinning::SkinVertices(vertices.data(), vertices.size(), dualQuaternions.data(), dualPositions.data(), dualNormals.data());
+
+		//normals가 nullptr이어도 위치는 같음, 런타임 분기한 커널
+		std::vector<XMFLOAT3> positionsOnly(vertices.size());
+		Skinning::SkinVertices(vertices.data(), vertices.size(), palette.data(), positionsOnly.data(), nullptr);
+		const std::vector<XMFLOAT3>& dispatchedPositions = isAvx2Supported ? avx2Positions : simdPositions;
+
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			//SIMD는 더하는 순서, FMA만 다름
+			REQUIRE(IsNear(simdPositions[i], scalarPositions[i], 1.0e-4f));
+			REQUIRE(IsNear(simdNormals[i], scalarNormals[i], 1.0e-4f));
+			if (isAvx2Supported)
+			{
+				REQUIRE(IsNear(avx2Positions[i], scalarPositions[i], 1.0e-4f));
+				REQUIRE(IsNear(avx2Normals[i], scalarNormals[i], 1.0e-4f));
+			}
+			REQUIRE(IsNear(positionsOnly[i], dispatchedPositions[i], 0.0f));
+
+			//듀얼쿼터니언은 강체 변환이라 법선 길이 유지
+			CHECK(std::fabs(XMVectorGetX(XMVector3Length(XMLoadFloat3(&dualNormals[i]))) - 1.0f) < 1.0e-4f);
+
+			//본 하나인 정점은 스케일이 없으면 선형과 같음
+			if (vertices[i].BoneWeights.y == 0.0f && scale == 1.0f)
+			{
+				CHECK(IsNear(dualPositions[i], scalarPositions[i], 1.0e-4f));
+				CHECK(IsNear(dualNormals[i], scalarNormals[i], 1.0e-4f));
+			}
+		}
+	}
+
+	//스케일은 무시됨 : 같은 회전, 이동에 스케일만 다른 팔레트는 같은 듀얼쿼터니언
+	std::vector<BoneTransform3x4> rigidPalette = CreatePalette(boneCount, 1.0f);
+	std::vector<BoneTransform3x4> scaledPalette = CreatePalette(boneCount, 2.5f);
+	for (UINT i = 0; i < boneCount; ++i)
+	{
+		DualQuaternionTransform rigid = Skinning::ToDualQuaternion(rigidPalette[i]);
+		DualQuaternionTransform scaled = Skinning::ToDualQuaternion(scaledPalette[i]);
+		CHECK(XMVector4NearEqual(XMLoadFloat4(&rigid.Real), XMLoadFloat4(&scaled.Real), XMVectorReplicate(1.0e-5f)));
+		CHECK(XMVector4NearEqual(XMLoadFloat4(&rigid.Dual), XMLoadFloat4(&scaled.Dual), XMVectorReplicate(1.0e-5f)));
+	}
+}
+
+HEADLESS_TEST(SkinnedBoundsContainVertices)
+{
+	const UINT boneCount = 16;
+	std::vector<Vertex> vertices = CreateVertices(4000, boneCount);
+
+	//본마다 가중치가 있는 정점의 바인드포즈 박스, FbxModelScene과 같은 방식
+	std::vector<JointBounds> jointBounds;
+	for (UINT bone = 0; bone < boneCount; ++bone)
+	{
+		XMVECTOR minPosition = XMVectorReplicate(FLT_MAX);
+		XMVECTOR maxPosition = XMVectorReplicate(-FLT_MAX);
+		bool hasVertex = false;
+		for (const Vertex& vertex : vertices)
+		{
+			const UINT indices[4] = { vertex.BoneIndices.x, vertex.BoneIndices.y, vertex.BoneIndices.z, vertex.BoneIndices.w };
+			const float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, vertex.BoneWeights.w };
+			for (int i = 0; i < 4; ++i)
+			{
+				if (indices[i] == bone && weights[i] > 0.0f)
+				{
+					minPosition = XMVectorMin(minPosition, XMLoadFloat3(&vertex.Pos));
+					maxPosition = XMVectorMax(maxPosition, XMLoadFloat3(&vertex.Pos));
+					hasVertex = true;
+				}
+			}
+		}
+		if (hasVertex)
+		{
+			JointBounds joint;
+			joint.JointIndex = bone;
+			BoundingBox::CreateFromPoints(joint.Bounds, minPosition, maxPosition);
+			jointBounds.push_back(joint);
+		}
+	}
+
+	auto isContained = [](const BoundingBox& bounds, const std::vector<XMFLOAT3>& positions)
+	{
+		XMVECTOR center = XMLoadFloat3(&bounds.Center);
+		XMVECTOR extents = XMVectorAdd(XMLoadFloat3(&bounds.Extents), XMVectorReplicate(1.0e-4f));
+		for (const XMFLOAT3& position : positions)
+		{
+			if (XMVector3InBounds(XMVectorSubtract(XMLoadFloat3(&position), center), extents) == false)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	std::vector<XMFLOAT3> positions(vertices.size());
+	for (float scale : { 1.0f, 2.5f, 0.4f })
+	{
+		std::vector<BoneTransform3x4> palette = CreatePalette(boneCount, scale);
+		BoundingBox skinnedBounds;
+		Skinning::ComputeSkinnedBounds(palette.data(), jointBounds, skinnedBounds);
+
+		Skinning::SkinVertices(vertices.data(), vertices.size(), palette.data(), positions.data(), nullptr);
+		CHECK(isContained(skinnedBounds, positions));
+
+		//듀얼쿼터니언은 스케일을 버리므로 DynamicMesh처럼 강체 변환 박스를 합쳐야 포함됨
+		//같이 섞이는 본의 회전 차이가 크면 정점이 호를 따라 박스 밖으로 나가므로 실제 관절처럼 회전 차이는 작게
+		palette = CreatePalette(boneCount, scale, 0.3f);
+		Skinning::ComputeSkinnedBounds(palette.data(), jointBounds, skinnedBounds);
+		std::vector<DualQuaternionTransform> dualQuaternions(boneCount);
+		Skinning::ToDualQuaternions(palette.data(), dualQuaternions.data(), boneCount);
+		BoundingBox rigidBounds, dualBounds;
+		Skinning::ComputeSkinnedBounds(dualQuaternions.data(), jointBounds, rigidBounds);
+		BoundingBox::CreateMerged(dualBounds, skinnedBounds, rigidBounds);
+
+		Skinning::SkinVertices(vertices.data(), vertices.size(), dualQuaternions.data(), positions.data(), nullptr);
+		CHECK(isContained(dualBounds, positions));
+		if (scale == 1.0f)
+		{
+			//스케일이 없으면 두 박스가 같음
+			CHECK(XMVector3NearEqual(XMLoadFloat3(&rigidBounds.Center), XMLoadFloat3(&skinnedBounds.Center), XMVectorReplicate(1.0e-4f)));
+			CHECK(XMVector3NearEqual(XMLoadFloat3(&rigidBounds.Extents), XMLoadFloat3(&skinnedBounds.Extents), XMVectorReplicate(1.0e-4f)));
+		}
+		else if (scale < 1.0f)
+		{
+			//본을 줄이면 선형 박스만으로는 부족함
+			CHECK(isContained(skinnedBounds, positions) == false);
+		}
+	}
+}
+
+HEADLESS_BENCH(SkinningKernels)
+{
+	const UINT boneCount = 64;
+	const size_t vertexCount = 100000;
+	const int repeatCount = 20;
+
+	std::vector<Vertex> vertices = CreateVertices(vertexCount, boneCount);
+	std::vector<BoneTransform3x4> palette = CreatePalette(boneCount, 1.0f);
+	std::vector<DualQuaternionTransform> dualQuaternions(boneCount);
+	std::vector<XMFLOAT3> positions(vertexCount), normals(vertexCount);
+
+	HeadlessTest::Timer scalarTimer;
+	for (int repeat = 0; repeat < repeatCount; ++repeat)
+	{
+		Skinning::SkinVerticesScalar(vertices.data(), vertexCount, palette.data(), positions.data(), normals.data());
+	}
+	double scalarTime = scalarTimer.GetMilliseconds() / repeatCount;
+
+	HeadlessTest::Timer simdTimer;
+	for (int repeat = 0; repeat < repeatCount; ++repeat)
+	{
+		Skinning::SkinVerticesSse2(vertices.data(), vertexCount, palette.data(), positions.data(), normals.data());
+	}
+	double simdTime = simdTimer.GetMilliseconds() / repeatCount;
+
+	double avx2Time = 0.0;
+	if (Skinning::IsAvx2Supported())
+	{
+		HeadlessTest::Timer avx2Timer;
+		for (int repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			Skinning::SkinVerticesAvx2(vertices.data(), vertexCount, palette.data(), positions.data(), normals.data());
+		}
+		avx2Time = avx2Timer.GetMilliseconds() / repeatCount;
+	}
+
+	//팔레트 변환 포함
+	HeadlessTest::Timer dualTimer;
+	for (int repeat = 0; repeat < repeatCount; ++repeat)
+	{
+		Skinning::ToDualQuaternions(palette.data(), dualQuaternions.data(), boneCount);
+		Skinning::SkinVertices(vertices.data(), vertexCount, dualQuaternions.data(), positions.data(), normals.data());
+	}
+	double dualTime = dualTimer.GetMilliseconds() / repeatCount;
+
+	printf("  %zu vertices, %u bones, ms : scalar %.2f, sse2 %.2f (x%.2f), dual quaternion %.2f (%.3f)\n",
+		vertexCount, boneCount, scalarTime, simdTime, scalarTime / simdTime, dualTime, positions.back().x);
+	if (avx2Time > 0.0)
+	{
+		printf("  avx2 %.2f (x%.2f)\n", avx2Time, scalarTime / avx2Time);
+	}
+	else
+	{
+		printf("  avx2 not supported\n");
+	}
+}
@@ -0,0 +1,48 @@
+#include "HeadlessTest.h"
+#include <string.h>
+
+//사용법 : HeadlessTests [--bench] [이름 일부]
+//인자가 없으면 모든 테스트만 실행, --bench면 벤치마크도 실행
+//실패한 테스트가 있으면 1 반환
+int main(int argc, char* argv[])
+{
+	bool runBench = false;
+	const char* filter = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+		{
+			runBench = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	int runCount = 0;
+	int failedTestCount = 0;
+	for (const auto& entry : HeadlessTest::GetEntries())
+	{
+		if (entry.IsBench && runBench == false)
+		{
+			continue;
+		}
+		if (filter != nullptr && strstr(entry.Name, filter) == nullptr)
+		{
+			continue;
+		}
+
+		printf("[%s] %s\n", entry.IsBench ? "BENCH" : "TEST", entry.Name);
+		HeadlessTest::GetFailCount() = 0;
+		entry.Function();
+		++runCount;
+		if (HeadlessTest::GetFailCount() > 0)
+		{
+			++failedTestCount;
+		}
+	}
+
+	printf("%d run, %d failed\n", runCount, failedTestCount);
+	return failedTestCount > 0 ? 1 : 0;
+}
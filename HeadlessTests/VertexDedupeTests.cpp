@@ -0,0 +1,183 @@
+#include "HeadlessTest.h"
+#include "VertexDedupeTable.h"
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	//변경 전 FbxModelScene의 중복정점 제거에 쓰던 정점과 해시, 비교용
+	struct MapVertex
+	{
+		float Position[3] = {};
+		float Normal[3] = {};
+		float TangentU[3] = {};
+		float TexC[2] = {};
+		std::string MaterialName;
+		std::vector<int> BoneWeights;
+
+		bool operator==(const MapVertex& rhs) const
+		{
+			return Position[0] == rhs.Position[0] && Position[1] == rhs.Position[1] && Position[2] == rhs.Position[2] &&
+				Normal[0] == rhs.Normal[0] && Normal[1] == rhs.Normal[1] && Normal[2] == rhs.Normal[2] &&
+				TangentU[0] == rhs.TangentU[0] && TangentU[1] == rhs.TangentU[1] && TangentU[2] == rhs.TangentU[2] &&
+				TexC[0] == rhs.TexC[0] && TexC[1] == rhs.TexC[1] &&
+				MaterialName.compare(rhs.MaterialName) == 0;
+		}
+	};
+
+	struct MapVertexHash
+	{
+		size_t operator()(const MapVertex& vertex) const
+		{
+			return std::hash<float>()(vertex.Position[0]) ^
+				std::hash<float>()(vertex.Position[1]) ^
+				std::hash<float>()(vertex.Position[2]) ^
+				std::hash<std::string>()(vertex.MaterialName) ^
+				std::hash<float>()(vertex.TexC[0]) ^
+				std::hash<float>()(vertex.TexC[1]);
+		}
+	};
+
+	struct TestVertex
+	{
+		float Position[3];
+		float Normal[3];
+		float TexC[2];
+		int32_t MaterialIndex;
+	};
+
+	//gridSize x gridSize 사각형 격자를 삼각형 리스트로 펼친 정점, 사각형 하나에 6개
+	//격자점 하나를 최대 6개 삼각형이 공유함, 재질은 격자 절반씩 나눔
+	std::vector<TestVertex> CreateGridVertices(int gridSize)
+	{
+		std::vector<TestVertex> vertices;
+		vertices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+
+		const int corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+		for (int z = 0; z < gridSize; ++z)
+		{
+			for (int x = 0; x < gridSize; ++x)
+			{
+				int32_t materialIndex = x < gridSize / 2 ? 0 : 1;
+				for (const auto& corner : corners)
+				{
+					float u = static_cast<float>(x + corner[0]) / gridSize;
+					float v = static_cast<float>(z + corner[1]) / gridSize;
+					//가운데 줄은 -0.0f로 넣어서 0.0f와 같은 키가 되는지 확인
+					float positionX = (x + corner[0]) - gridSize * 0.5f;
+					if (positionX == 0.0f && z % 2 == 1)
+					{
+						positionX = -0.0f;
+					}
+					vertices.push_back({ { positionX, 0.0f, static_cast<float>(z + corner[1]) }, { 0.0f, 1.0f, 0.0f }, { u, v }, materialIndex });
+				}
+			}
+		}
+		return vertices;
+	}
+
+	VertexKey CreateVertexKey(const TestVertex& vertex)
+	{
+		VertexKey key;
+		for (int i = 0; i < 3; ++i)
+		{
+			key.Position[i] = VertexKey::CanonicalFloatBits(vertex.Position[i]);
+			key.Normal[i] = VertexKey::CanonicalFloatBits(vertex.Normal[i]);
+		}
+		key.TexC[0] = VertexKey::CanonicalFloatBits(vertex.TexC[0]);
+		key.TexC[1] = VertexKey::CanonicalFloatBits(vertex.TexC[1]);
+		key.MaterialIndex = vertex.MaterialIndex;
+		return key;
+	}
+
+	MapVertex CreateMapVertex(const TestVertex& vertex)
+	{
+		static const std::string materialNames[2] = { "Material_Body", "Material_Head" };
+
+		MapVertex mapVertex;
+		for (int i = 0; i < 3; ++i)
+		{
+			mapVertex.Position[i] = vertex.Position[i];
+			mapVertex.Normal[i] = vertex.Normal[i];
+		}
+		mapVertex.TexC[0] = vertex.TexC[0];
+		mapVertex.TexC[1] = vertex.TexC[1];
+		mapVertex.MaterialName = materialNames[vertex.MaterialIndex];
+		return mapVertex;
+	}
+
+	//정점마다 중복제거 후 인덱스, FbxModelScene과 같은 순서로 처리
+	std::vector<uint32_t> DedupeWithTable(const std::vector<TestVertex>& vertices, size_t& uniqueCount)
+	{
+		std::vector<uint32_t> indices;
+		indices.reserve(vertices.size());
+		VertexDedupeTable table(vertices.size() / 4);
+		for (const auto& vertex : vertices)
+		{
+			indices.push_back(table.Insert(CreateVertexKey(vertex)).first);
+		}
+		uniqueCount = table.GetSize();
+		return indices;
+	}
+
+	std::vector<uint32_t> DedupeWithMap(const std::vector<TestVertex>& vertices, size_t& uniqueCount)
+	{
+		std::vector<uint32_t> indices;
+		indices.reserve(vertices.size());
+		std::unordered_map<MapVertex, uint32_t, MapVertexHash> hashMap;
+		std::vector<MapVertex> vertexTable;
+		for (const auto& vertex : vertices)
+		{
+			MapVertex mapVertex = CreateMapVertex(vertex);
+			auto findResult = hashMap.find(mapVertex);
+			if (findResult == hashMap.end())
+			{
+				uint32_t index = static_cast<uint32_t>(vertexTable.size());
+				hashMap[mapVertex] = index;
+				vertexTable.push_back(mapVertex);
+				indices.push_back(index);
+			}
+			else
+			{
+				indices.push_back(findResult->second);
+			}
+		}
+		uniqueCount = vertexTable.size();
+		return indices;
+	}
+}
+
+HEADLESS_TEST(VertexDedupeMatchesMap)
+{
+	std::vector<TestVertex> vertices = CreateGridVertices(64);
+
+	size_t tableUniqueCount = 0;
+	size_t mapUniqueCount = 0;
+	std::vector<uint32_t> tableIndices = DedupeWithTable(vertices, tableUniqueCount);
+	std::vector<uint32_t> mapIndices = DedupeWithMap(vertices, mapUniqueCount);
+
+	//재질 경계의 격자점은 재질마다 따로 남음
+	CHECK(tableUniqueCount == 65 * 65 + 65);
+	CHECK(tableUniqueCount == mapUniqueCount);
+	CHECK(tableIndices == mapIndices);
+}
+
+HEADLESS_BENCH(VertexDedupeMillionVertices)
+{
+	//408 * 408 * 6 = 998784 정점
+	std::vector<TestVertex> vertices = CreateGridVertices(408);
+
+	size_t tableUniqueCount = 0;
+	HeadlessTest::Timer tableTimer;
+	std::vector<uint32_t> tableIndices = DedupeWithTable(vertices, tableUniqueCount);
+	double tableTime = tableTimer.GetMilliseconds();
+
+	size_t mapUniqueCount = 0;
+	HeadlessTest::Timer mapTimer;
+	std::vector<uint32_t> mapIndices = DedupeWithMap(vertices, mapUniqueCount);
+	double mapTime = mapTimer.GetMilliseconds();
+
+	CHECK(tableIndices == mapIndices);
+	printf("  %zu vertices -> %zu unique, table %.1f ms, map %.1f ms (x%.2f)\n",
+		vertices.size(), tableUniqueCount, tableTime, mapTime, mapTime / tableTime);
+}